@@ -34,6 +34,7 @@
 #ifdef HAVE_ALBUMART
 #include "albumart.h"
 #include "jpeg_load.h"
+#include "png_load.h"
 #include "playback.h"
 #endif
 #include "buffering.h"
@@ -848,10 +849,12 @@ static bool fill_buffer(void)
 #ifdef HAVE_ALBUMART
 /* Given a file descriptor to a bitmap file, write the bitmap data to the
    buffer, with a struct bitmap and the actual data immediately following.
-   Return value is the total size (struct + data). */
+   free is the space the decoder may use from there on.
+   Return value is the total size (struct + data).
+   Called without llist_mutex held, see bufopen(). */
 static int load_image(int fd, const char *path,
                       struct bufopen_bitmap_data *data,
-                      size_t bufidx)
+                      size_t bufidx, int free)
 {
     int rc;
     struct bitmap *bmp = ringbuf_ptr(bufidx);
@@ -866,15 +869,32 @@ static int load_image(int fd, const char *path,
 #if (LCD_DEPTH > 1) || defined(HAVE_REMOTE_LCD) && (LCD_REMOTE_DEPTH > 1)
     bmp->maskdata = NULL;
 #endif
-    int free = (int)MIN(buffer_len - bytes_used(), buffer_len - bufidx)
-                        - sizeof(struct bitmap);
+
+    rc = albumart_cache_load(fd, path, aa, dim, bmp, free);
+    if (rc > 0)
+        return rc + sizeof(struct bitmap);
+
+    /* Decoding may take a while for large images - let everyone else have
+       a go meanwhile */
+#ifdef HAVE_PRIORITY_SCHEDULING
+    int old_priority = thread_set_priority(thread_self(), PRIORITY_BACKGROUND);
+#endif
 
 #ifdef HAVE_JPEG
     if (aa != NULL) {
         lseek(fd, aa->pos, SEEK_SET);
-        rc = clip_jpeg_fd(fd, aa->size, bmp, free, FORMAT_NATIVE|FORMAT_DITHER|
-                         FORMAT_RESIZE|FORMAT_KEEP_ASPECT, NULL);
+        if (aa->type == AA_TYPE_PNG)
+            rc = clip_png_fd(fd, aa->size, bmp, free, FORMAT_NATIVE|
+                             FORMAT_DITHER|FORMAT_RESIZE|FORMAT_KEEP_ASPECT,
+                             NULL);
+        else
+            rc = clip_jpeg_fd(fd, aa->size, bmp, free, FORMAT_NATIVE|
+                              FORMAT_DITHER|FORMAT_RESIZE|FORMAT_KEEP_ASPECT,
+                              NULL);
     }
+    else if (!strcmp(path + strlen(path) - 4, ".png"))
+        rc = read_png_fd(fd, bmp, free, FORMAT_NATIVE|FORMAT_DITHER|
+                         FORMAT_RESIZE|FORMAT_KEEP_ASPECT, NULL);
     else if (strcmp(path + strlen(path) - 4, ".bmp"))
         rc = read_jpeg_fd(fd, bmp, free, FORMAT_NATIVE|FORMAT_DITHER|
                           FORMAT_RESIZE|FORMAT_KEEP_ASPECT, NULL);
@@ -883,8 +903,15 @@ static int load_image(int fd, const char *path,
         rc = read_bmp_fd(fd, bmp, free, FORMAT_NATIVE|FORMAT_DITHER|
                          FORMAT_RESIZE|FORMAT_KEEP_ASPECT, NULL);
 
+#ifdef HAVE_PRIORITY_SCHEDULING
+    if (old_priority > 0)
+        thread_set_priority(thread_self(), old_priority);
+#endif
+
+    if (rc > 0)
+        albumart_cache_store(path, bmp, rc);
+
     return rc + (rc > 0 ? sizeof(struct bitmap) : 0);
-    (void)path;
 }
 #endif /* HAVE_ALBUMART */
 
@@ -971,7 +998,7 @@ int bufopen(const char *file, off_t offset, enum data_type type,
 #ifdef HAVE_ALBUMART
     if (type == TYPE_BITMAP) {
         /* If albumart is embedded, the complete file is not buffered,
-         * but only the jpeg part; filesize() would be wrong */
+         * but only the image part; filesize() would be wrong */
         struct bufopen_bitmap_data *aa = user_data;
         if (aa->embedded_albumart)
             size = aa->embedded_albumart->size;
@@ -1026,8 +1053,27 @@ int bufopen(const char *file, off_t offset, enum data_type type,
 
 #ifdef HAVE_ALBUMART
     if (type == TYPE_BITMAP) {
-        /* Bitmap file: we load the data instead of the file */
-        int rc = load_image(fd, file, user_data, data);
+        /* Bitmap file: we load the data instead of the file. The handle is
+           linked empty and pinned first, so the decoder can use the space
+           after it without keeping the buffering thread off the buffer for
+           the whole time. Only this thread adds handles, so nothing else
+           will be put there meanwhile. */
+        int free = (int)MIN(buffer_len - bytes_used(), buffer_len - data)
+                            - sizeof(struct bitmap);
+
+        h->widx     = data;
+        h->filesize = 0;
+        h->end      = 0;
+        h->pinned++;
+        link_handle(h);
+
+        mutex_unlock(&llist_mutex);
+        int rc = load_image(fd, file, user_data, data, free);
+        mutex_lock(&llist_mutex);
+
+        h->pinned--;
+        unlink_handle(h);
+
         if (rc <= 0) {
             handle_id = ERR_FILE_ERROR;
         } else {
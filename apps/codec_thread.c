@@ -33,6 +33,7 @@
 #include "dsp_core.h"
 #include "metadata.h"
 #include "settings.h"
+#include "seek_index.h"
 
 /* Define LOGF_ENABLE to enable logf output in this file */
 /*#define LOGF_ENABLE*/
@@ -438,6 +439,13 @@ static bool codec_loop_track_callback(void)
     return global_settings.repeat_mode == REPEAT_ONE;
 }
 
+static bool codec_seek_index_lookup_callback(unsigned long sample,
+                                             unsigned long *point_sample,
+                                             size_t *point_pos)
+{
+    return seek_index_lookup(ci.id3, sample, point_sample, point_pos);
+}
+
 
 /** --- CODEC THREAD --- **/
 
@@ -645,6 +653,7 @@ void INIT_ATTR codec_thread_init(void)
     ci.configure        = codec_configure_callback;
     ci.get_command      = codec_get_command_callback;
     ci.loop_track       = codec_loop_track_callback;
+    ci.seek_index_lookup = codec_seek_index_lookup_callback;
 
     /* Init threading */
     queue_init(&codec_queue, false);
@@ -150,6 +150,7 @@ struct codec_api ci = {
 
     /* new stuff at the end, sort into place next time
        the API gets incompatible */
+    NULL, /* seek_index_lookup */
 
 };
 
@@ -177,6 +178,21 @@ void *codec_get_buffer_callback(size_t *size)
 /** codec loading and call interface **/
 static void *curr_handle = NULL;
 static struct codec_header *c_hdr = NULL;
+#if (CONFIG_PLATFORM & PLATFORM_HOSTED)
+static char curr_path[MAX_PATH]; /* empty if curr_handle isn't cacheable */
+static void *curr_state = NULL;  /* its data as first opened, or NULL */
+#endif
+
+/* Close the current codec, which didn't load or can't be kept */
+static void codec_drop(void)
+{
+    lc_close(curr_handle);
+    curr_handle = NULL;
+#if (CONFIG_PLATFORM & PLATFORM_HOSTED)
+    lc_state_free(curr_state);
+    curr_state = NULL;
+#endif
+}
 
 static int codec_load_ram(struct codec_api *api)
 {
@@ -199,16 +215,14 @@ static int codec_load_ram(struct codec_api *api)
         )
     {
         logf("codec header error");
-        lc_close(curr_handle);
-        curr_handle = NULL;
+        codec_drop();
         return CODEC_ERROR;
     }
 
     if (hdr->api_version > CODEC_API_VERSION
         || hdr->api_version < CODEC_MIN_API_VERSION) {
         logf("codec api version error");
-        lc_close(curr_handle);
-        curr_handle = NULL;
+        codec_drop();
         return CODEC_ERROR;
     }
 
@@ -233,6 +247,10 @@ int codec_load_buf(int hid, struct codec_api *api)
         return CODEC_ERROR;
     }
 
+#if (CONFIG_PLATFORM & PLATFORM_HOSTED)
+    curr_path[0] = '\0'; /* Temporary copy, can't be found again by name */
+#endif
+
     curr_handle = lc_open_from_mem(codecbuf, rc);
 
     if (curr_handle == NULL) {
@@ -243,12 +261,92 @@ int codec_load_buf(int hid, struct codec_api *api)
     return codec_load_ram(api);
 }
 
+#if (CONFIG_PLATFORM & PLATFORM_HOSTED)
+/* Hosted builds link each codec as its own shared object, so a codec can stay
+   open after it's closed. The most recently used ones are kept resident and
+   codec_load_file() adopts them instead of going to storage.
+   Only native codecs have codec_crt0.c clear their bss and reload their data,
+   so each resident codec keeps a copy of its writable data from when it was
+   opened, and that is put back before it's loaded again. Where the loader
+   can't save it (lc_state_save() returns NULL) the codec isn't kept.
+   The list is changed by the codec thread while the audio thread waits on
+   Q_CODEC_LOAD/Q_CODEC_UNLOAD or by a plugin while playback is stopped,
+   never concurrently, so no locking is needed. */
+#define CODEC_RESIDENT_COUNT 3
+
+static struct codec_resident
+{
+    void *handle;
+    void *state;
+    char path[MAX_PATH];
+} resident[CODEC_RESIDENT_COUNT]; /* [0] = most recently used */
+
+/* Remove a codec from the resident list and return its handle and state */
+static void *resident_take(const char *path, void **state)
+{
+    for (int i = 0; i < CODEC_RESIDENT_COUNT && resident[i].handle; i++)
+    {
+        if (strcmp(path, resident[i].path))
+            continue;
+
+        void *handle = resident[i].handle;
+        *state = resident[i].state;
+        memmove(&resident[i], &resident[i+1],
+                (CODEC_RESIDENT_COUNT - 1 - i) * sizeof (resident[0]));
+        resident[CODEC_RESIDENT_COUNT-1].handle = NULL;
+        return handle;
+    }
+
+    return NULL;
+}
+
+/* Make a codec the most recently used one, closing whichever drops off */
+static void resident_put(const char *path, void *handle, void *state)
+{
+    void *dup_state;
+    void *dup = resident_take(path, &dup_state);
+
+    if (dup)
+    {
+        /* Opened twice; drop the extra reference */
+        lc_close(dup);
+        lc_state_free(dup_state);
+    }
+
+    if (resident[CODEC_RESIDENT_COUNT-1].handle)
+    {
+        logf("Codec: evicting %s", resident[CODEC_RESIDENT_COUNT-1].path);
+        lc_close(resident[CODEC_RESIDENT_COUNT-1].handle);
+        lc_state_free(resident[CODEC_RESIDENT_COUNT-1].state);
+    }
+
+    memmove(&resident[1], &resident[0],
+            (CODEC_RESIDENT_COUNT - 1) * sizeof (resident[0]));
+    resident[0].handle = handle;
+    resident[0].state = state;
+    strlcpy(resident[0].path, path, sizeof (resident[0].path));
+}
+#endif /* PLATFORM_HOSTED */
+
 int codec_load_file(const char *plugin, struct codec_api *api)
 {
     char path[MAX_PATH];
 
     codec_get_full_path(path, plugin);
 
+#if (CONFIG_PLATFORM & PLATFORM_HOSTED)
+    strlcpy(curr_path, path, sizeof (curr_path));
+
+    curr_handle = resident_take(path, &curr_state);
+
+    if (curr_handle)
+    {
+        logf("Codec: %s is resident", plugin);
+        lc_state_restore(curr_state);
+        return codec_load_ram(api);
+    }
+#endif
+
     curr_handle = lc_open(path, codecbuf, CODEC_SIZE);
 
     if (curr_handle == NULL) {
@@ -256,6 +354,10 @@ int codec_load_file(const char *plugin, struct codec_api *api)
         return CODEC_ERROR;
     }
 
+#if (CONFIG_PLATFORM & PLATFORM_HOSTED)
+    curr_state = lc_state_save(curr_handle);
+#endif
+
     return codec_load_ram(api);
 }
 
@@ -277,8 +379,18 @@ int codec_close(void)
     if (curr_handle != NULL) {
         logf("Codec: cleaning up");
         status = c_hdr->entry_point(CODEC_UNLOAD);
-        lc_close(curr_handle);
-        curr_handle = NULL;
+#if (CONFIG_PLATFORM & PLATFORM_HOSTED)
+        /* Keep it around for next time unless it left in a bad state or
+           can't be given a clean one */
+        if (status == CODEC_OK && curr_path[0] != '\0' && curr_state)
+        {
+            resident_put(curr_path, curr_handle, curr_state);
+            curr_handle = NULL;
+            curr_state = NULL;
+            return status;
+        }
+#endif
+        codec_drop();
     }
 
     return status;
@@ -2501,6 +2501,9 @@ static bool dbg_skin_engine(void)
         simplelist_addline("%s display:",
                            j == 0 ? "Main" : "Remote");
 #endif
+        unsigned long per_second;
+        unsigned long pixels = skin_get_pixels_pushed(j, &per_second);
+        simplelist_addline("Pixels pushed: %lu, %lu/s", pixels, per_second);
         for (i = 0; i < skin_get_num_skins(); i++) {
             struct skin_stats *stats = skin_get_stats(i, j);
             if (stats->buflib_handles)
@@ -44,6 +44,7 @@
 #include "filetree.h"
 #include "misc.h"
 #include "strnatcmp.h"
+#include "collate.h"
 #ifdef HAVE_LCD_BITMAP
 #include "keyboard.h"
 #endif
@@ -272,35 +273,263 @@ static int compare(const void* p1, const void* p2)
     return 0; /* never reached */
 }
 
-/* load and sort directory into the tree's cache. returns NULL on failure. */
-int ft_load(struct tree_context* c, const char* tempdir)
+/* Collation keys: compare() turned into bytes so that qsort() only has to
+ * strcmp() them. A key is a group byte (volume, directory, file), the type or
+ * date when sorting by those, then the collation key of the name. Keys that
+ * come out the same, or were cut short, fall back to compare(). */
+struct ft_key
+{
+    char *name;             /* the entry's name while its key is in use */
+    unsigned char key[];
+};
+
+#define KEY_MIN_LEN 16      /* not worth it for keys shorter than that */
+
+/* store a number big-endian, 7 bits a byte so that no byte is ever 0 */
+static unsigned char *put_key_num(unsigned char *p, unsigned long val,
+                                  int bytes, bool reversed)
+{
+    while (bytes--)
+    {
+        unsigned char b = (val >> (7*bytes)) & 0x7f;
+        *p++ = reversed ? 0x80 - b : b + 1;
+    }
+    return p;
+}
+
+/* write the key for e, at most len bytes and a terminating 0 */
+static void make_key(unsigned char *key, int len, const struct entry *e)
+{
+    unsigned char *p = key, *end = key + len;
+    unsigned flags = 0;
+    int criteria, type;
+
+    if (e->attr & ATTR_DIRECTORY)
+    {
+        criteria = compare_sort_dir;
+        *p++ = 2;
+#ifdef HAVE_MULTIVOLUME
+        if (e->attr & ATTR_VOLUME)
+        {   /* volumes first, sorted alphabetically */
+            criteria = SORT_ALPHA;
+            p[-1] = 1;
+        }
+#endif
+    }
+    else
+    {
+        criteria = global_settings.sort_file;
+        *p++ = 3;
+    }
+
+    switch(criteria)
+    {
+        case SORT_TYPE:
+        case SORT_TYPE_REVERSED:
+            type = (e->attr & FILE_ATTR_MASK) >> 8;
+            p = put_key_num(p, type ? type : 0x100, 2,
+                            criteria == SORT_TYPE_REVERSED);
+            break;
+
+        case SORT_DATE:
+        case SORT_DATE_REVERSED:
+            p = put_key_num(p, e->time_write, 5,
+                            criteria == SORT_DATE_REVERSED);
+            break;
+
+        case SORT_ALPHA_REVERSED:
+            flags |= COLLATE_REVERSE;
+            break;
+    }
+
+    if (!global_settings.sort_case)
+        flags |= COLLATE_FOLD_CASE;
+    if (global_settings.interpret_numbers == SORT_INTERPRET_AS_NUMBER)
+        flags |= COLLATE_NUMBERS;
+
+    collate_key((char *)p, end - p + 1, e->name, flags);
+}
+
+/* support function for qsort() on entries carrying their keys */
+static int compare_keys(const void* p1, const void* p2)
+{
+    const struct entry* e1 = (const struct entry*)p1;
+    const struct entry* e2 = (const struct entry*)p2;
+    const struct ft_key* k1 = (const struct ft_key*)e1->name;
+    const struct ft_key* k2 = (const struct ft_key*)e2->name;
+    int rc = strcmp((const char *)k1->key, (const char *)k2->key);
+
+    if (rc == 0)
+    {
+        struct entry t1 = *e1, t2 = *e2;
+        t1.name = k1->name;
+        t2.name = k2->name;
+        rc = compare(&t1, &t2);
+    }
+    return rc;
+}
+
+/* sort count entries, with the keys in what's left of the name buffer */
+static void ft_sort(struct tree_context* c, struct entry *entries, int count,
+                    int name_buffer_used)
+{
+    char *buf = core_get_data(c->cache.name_buffer_handle);
+    uintptr_t start = ALIGN_UP((uintptr_t)(buf + name_buffer_used),
+                               sizeof(char *));
+    uintptr_t end = (uintptr_t)(buf + c->cache.name_buffer_size);
+    size_t size = 0;
+    int i;
+
+    compare_sort_dir = c->sort_dir;
+
+    if (count > 1 && start < end)
+        size = ALIGN_DOWN((end - start) / count, sizeof(char *));
+
+    if (size < sizeof(struct ft_key) + KEY_MIN_LEN)
+    {   /* no room for keys */
+        qsort(entries, count, sizeof(struct entry), compare);
+        return;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        struct ft_key *key = (struct ft_key *)(start + i*size);
+        key->name = entries[i].name;
+        make_key(key->key, size - sizeof(struct ft_key) - 1, &entries[i]);
+        entries[i].name = (char *)key;
+    }
+
+    qsort(entries, count, sizeof(struct entry), compare_keys);
+
+    for (i = 0; i < count; i++)
+        entries[i].name = ((struct ft_key *)entries[i].name)->name;
+}
+
+/* compare two entries by keys made on the spot */
+static int compare_entries(const struct entry *e1, const struct entry *e2)
+{
+    unsigned char k1[MAX_PATH], k2[MAX_PATH];
+    int rc;
+
+    make_key(k1, sizeof(k1) - 1, e1);
+    make_key(k2, sizeof(k2) - 1, e2);
+    rc = strcmp((const char *)k1, (const char *)k2);
+    return rc ? rc : compare(e1, e2);
+}
+
+/* Merge the sorted entries from first on into the sorted ones before them.
+ * The new ones are put aside in the name buffer and placed from the back,
+ * each after a binary search, so that loading a directory in steps doesn't
+ * sort all of it again every time. Returns false if there's no room. */
+static bool ft_merge(struct tree_context* c, int first, int name_buffer_used)
+{
+    struct entry *entries = tree_get_entries(c);
+    char *buf = core_get_data(c->cache.name_buffer_handle);
+    uintptr_t start = ALIGN_UP((uintptr_t)(buf + name_buffer_used),
+                               sizeof(char *));
+    uintptr_t end = (uintptr_t)(buf + c->cache.name_buffer_size);
+    struct entry *chunk = (struct entry *)start;
+    int count = c->filesindir - first;
+    int hi = first, dst = c->filesindir;
+
+    if (start > end || (end - start) / sizeof(struct entry) < (size_t)count)
+        return false;
+
+    memcpy(chunk, &entries[first], count * sizeof(struct entry));
+
+    while (count > 0)
+    {
+        const struct entry *e = &chunk[--count];
+        int lo = 0, pos = hi;
+
+        /* find the first of the old ones going after e */
+        while (lo < pos)
+        {
+            int mid = (lo + pos) / 2;
+            if (compare_entries(&entries[mid], e) > 0)
+                pos = mid;
+            else
+                lo = mid + 1;
+        }
+
+        dst -= hi - pos;
+        memmove(&entries[dst], &entries[pos], (hi - pos) * sizeof(struct entry));
+        hi = pos;
+        entries[--dst] = *e;
+    }
+
+    return true;
+}
+
+/* directory still being read into the tree's cache */
+static struct
 {
-    int files_in_dir = 0;
-    int name_buffer_used = 0;
-    struct dirent *entry;
-    bool (*callback_show_item)(char *, int, struct tree_context *) = NULL;
     DIR *dir;
+    int name_buffer_used;
+    bool (*callback_show_item)(char *, int, struct tree_context *);
+} ft_pending;
+
+static void ft_load_close(void)
+{
+    if (ft_pending.dir)
+    {
+        closedir(ft_pending.dir);
+        ft_pending.dir = NULL;
+    }
+}
+
+static int ft_load_open(struct tree_context* c, const char* tempdir)
+{
+    ft_load_close();
 
     if (tempdir)
-        dir = opendir(tempdir);
+    {
+        ft_pending.dir = opendir(tempdir);
+        ft_pending.callback_show_item = NULL;
+    }
     else
     {
-        dir = opendir(c->currdir);
-        callback_show_item = c->browse? c->browse->callback_show_item: NULL;
+        ft_pending.dir = opendir(c->currdir);
+        ft_pending.callback_show_item =
+            c->browse? c->browse->callback_show_item: NULL;
     }
-    if(!dir)
+    if(!ft_pending.dir)
         return -1; /* not a directory */
 
+    ft_pending.name_buffer_used = 0;
+    c->filesindir = 0;
+    c->dirlength = 0;
     c->dirsindir = 0;
     c->dirfull = false;
+    return 0;
+}
+
+/* Read entries until the directory ends, the cache is full or timeout ticks
+ * have passed, then sort what there is. Returns 1 if there's more to read. */
+static int ft_load_step(struct tree_context* c, long timeout)
+{
+    int first = c->filesindir;
+    int files_in_dir = first;
+    int name_buffer_used = ft_pending.name_buffer_used;
+    long end_tick = current_tick + timeout;
+    DIR *dir = ft_pending.dir;
+    struct dirent *entry;
 
     tree_lock_cache(c);
-    while ((entry = readdir(dir))) {
+    while (true) {
         int len;
         struct dirinfo info;
         struct entry* dptr = tree_get_entry_at(c, files_in_dir);
+
+        if (timeout != TIMEOUT_BLOCK && TIME_AFTER(current_tick, end_tick))
+            break;
+
+        entry = readdir(dir);
         if (!entry)
+        {
+            ft_load_close();
             break;
+        }
 
         info = dir_get_info(dir, entry);
         len = strlen((char *)entry->d_name);
@@ -362,7 +591,8 @@ int ft_load(struct tree_context* c, const char* tempdir)
             (*c->dirfilter == SHOW_MOD && (dptr->attr & FILE_ATTR_MASK) != FILE_ATTR_MOD) ||
             (*c->dirfilter == SHOW_PLUGINS && (dptr->attr & FILE_ATTR_MASK) != FILE_ATTR_ROCK &&
                                               (dptr->attr & FILE_ATTR_MASK) != FILE_ATTR_LUA) ||
-            (callback_show_item && !callback_show_item(entry->d_name, dptr->attr, c)))
+            (ft_pending.callback_show_item &&
+             !ft_pending.callback_show_item(entry->d_name, dptr->attr, c)))
         {
             continue;
         }
@@ -371,6 +601,7 @@ int ft_load(struct tree_context* c, const char* tempdir)
             (files_in_dir >= c->cache.max_entries)) {
             /* Tell the world that we ran out of buffer space */
             c->dirfull = true;
+            ft_load_close();
             break;
         }
 
@@ -386,19 +617,65 @@ int ft_load(struct tree_context* c, const char* tempdir)
     }
     c->filesindir = files_in_dir;
     c->dirlength = files_in_dir;
-    closedir(dir);
+    ft_pending.name_buffer_used = name_buffer_used;
 
-    compare_sort_dir = c->sort_dir;
-    qsort(tree_get_entries(c), files_in_dir, sizeof(struct entry), compare);
+    /* sort what was just read and merge it with what's there already */
+    if (files_in_dir > first)
+    {
+        ft_sort(c, tree_get_entries(c) + first, files_in_dir - first,
+                name_buffer_used);
+        if (first > 0 && !ft_merge(c, first, name_buffer_used))
+            ft_sort(c, tree_get_entries(c), files_in_dir, name_buffer_used);
+    }
 
     /* If thumbnail talking is enabled, make an extra run to mark files with
        associated thumbnails, so we don't do unsuccessful spinups later. */
-    if (global_settings.talk_file_clip)
+    if (!ft_pending.dir && global_settings.talk_file_clip)
         check_file_thumbnails(c); /* map .talk to ours */
 
     tree_unlock_cache(c);
+    return ft_pending.dir ? 1 : 0;
+}
+
+/* load and sort directory into the tree's cache. returns NULL on failure. */
+int ft_load(struct tree_context* c, const char* tempdir)
+{
+    if (ft_load_open(c, tempdir) < 0)
+        return -1;
+
+    ft_load_step(c, TIMEOUT_BLOCK);
     return 0;
 }
+
+/* Like ft_load() for the current directory, but stops reading after timeout
+ * ticks so that the first screen of a big directory can be shown early.
+ * Returns -1 on failure, 1 if ft_load_continue() has more to read and 0 when
+ * the whole directory is loaded. */
+int ft_load_start(struct tree_context* c, long timeout)
+{
+    if (ft_load_open(c, NULL) < 0)
+        return -1;
+
+    /* the .talk check wants to see it all */
+    if (global_settings.talk_file_clip)
+        timeout = TIMEOUT_BLOCK;
+
+    return ft_load_step(c, timeout);
+}
+
+/* read more of a directory started with ft_load_start(), returns as above */
+int ft_load_continue(struct tree_context* c, long timeout)
+{
+    if (!ft_pending.dir)
+        return 0;
+
+    return ft_load_step(c, timeout);
+}
+
+bool ft_load_pending(void)
+{
+    return ft_pending.dir != NULL;
+}
 #ifdef HAVE_LCD_BITMAP
 static void ft_load_font(char *file)
 {
@@ -23,6 +23,9 @@
 #include "tree.h"
 
 int ft_load(struct tree_context* c, const char* tempdir);
+int ft_load_start(struct tree_context* c, long timeout);
+int ft_load_continue(struct tree_context* c, long timeout);
+bool ft_load_pending(void);
 int ft_enter(struct tree_context* c);
 int ft_exit(struct tree_context* c);
 int ft_build_playlist(struct tree_context* c, int start_index);
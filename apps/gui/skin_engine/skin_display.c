@@ -186,6 +186,8 @@ void draw_progressbar(struct gui_wps *gwps, int line, struct progressbar *pb)
         y = line*line_height + (0 > center ? 0 : center);
     }
 
+    display->damage_viewport_rect(x, y, width, height);
+
     if (pb->type == SKIN_TOKEN_VOLUMEBAR)
     {
         int minvol = sound_min(SOUND_VOLUME);
@@ -369,6 +371,8 @@ void clear_image_pos(struct gui_wps *gwps, struct gui_img *img)
     gwps->display->set_drawmode(DRMODE_SOLID|DRMODE_INVERSEVID);
     gwps->display->fillrect(img->x, img->y, img->bm.width, img->subimage_height);
     gwps->display->set_drawmode(DRMODE_SOLID);
+    gwps->display->damage_viewport_rect(img->x, img->y,
+                                        img->bm.width, img->subimage_height);
 }
 
 void wps_draw_image(struct gui_wps *gwps, struct gui_img *img,
@@ -379,10 +383,17 @@ void wps_draw_image(struct gui_wps *gwps, struct gui_img *img,
     display->set_drawmode(DRMODE_SOLID);
 
     if (img->is_9_segment)
+    {
         display->nine_segment_bmp(&img->bm, 0, 0, vp->width, vp->height);
+        display->damage_viewport_rect(0, 0, vp->width, vp->height);
+    }
     else
+    {
         display->bmp_part(&img->bm, 0, img->subimage_height * subimage,
                           img->x, img->y, img->bm.width, img->subimage_height);
+        display->damage_viewport_rect(img->x, img->y,
+                                      img->bm.width, img->subimage_height);
+    }
 }
 
 void wps_display_images(struct gui_wps *gwps, struct viewport* vp)
@@ -401,6 +412,9 @@ void wps_display_images(struct gui_wps *gwps, struct viewport* vp)
         if (img->using_preloaded_icons && img->display >= 0)
         {
             screen_put_icon(display, img->x, img->y, img->display);
+            display->damage_viewport_rect(img->x, img->y,
+                                          get_icon_width(display->screen_type),
+                                          get_icon_height(display->screen_type));
         }
         else if (img->loaded)
         {
@@ -638,6 +652,8 @@ void draw_peakmeters(struct gui_wps *gwps, int line_number,
             peak_meter_enable(true);
             peak_meter_screen(gwps->display, 0, peak_meter_y,
                               MIN(h, viewport->y+viewport->height - peak_meter_y));
+            gwps->display->damage_viewport_rect(0, peak_meter_y,
+                                                viewport->width, h);
         }
     }
 }
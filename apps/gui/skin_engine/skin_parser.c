@@ -26,6 +26,8 @@
 #include "config.h"
 #ifndef __PCTOOL__
 #include "core_alloc.h"
+#include "dir.h"
+#include "version.h"
 #endif
 #include "file.h"
 #include "misc.h"
@@ -79,6 +81,11 @@
 
 #define WPS_ERROR_INVALID_PARAM         -1
 
+/* parsed skins are kept next to their source, see skin_cache_save() */
+#if defined(HAVE_LCD_BITMAP) && !defined(__PCTOOL__)
+#define SKIN_CACHE
+#endif
+
 static char* skin_buffer = NULL;
 #if (LCD_DEPTH > 1) || (defined(HAVE_REMOTE_LCD) && (LCD_REMOTE_DEPTH > 1))
 static char *backdrop_filename;
@@ -2389,6 +2396,7 @@ static int skin_element_callback(struct skin_element* element, void* data)
         {
             curr_line = skin_buffer_alloc(sizeof(*curr_line));
             curr_line->update_mode = SKIN_REFRESH_STATIC;
+            curr_line->text_hash = 0;
             element->data = PTRTOSKINOFFSET(skin_buffer, curr_line);
         }
         break;
@@ -2423,6 +2431,525 @@ static int skin_element_callback(struct skin_element* element, void* data)
     return CALLBACK_OK;
 }
 
+/* copy the file's content to buf for parsing, ensuring that every line ends
+   with a newline char. Returns the size used, 0 if there's nothing to parse */
+static size_t skin_read_file(const char *skin_file, char *buf, size_t size)
+{
+    unsigned int start = 0;
+    int fd = open_utf8(skin_file, O_RDONLY);
+
+    if (fd < 0)
+        return 0;
+    while(read_line(fd, buf + start, size - start) > 0)
+    {
+        start += strlen(buf + start);
+        if (start < size - 1)
+        {
+            buf[start++] = '\n';
+            buf[start] = 0;
+        }
+    }
+    close(fd);
+    if (start <= 0)
+        return 0;
+    return start + 1;
+}
+
+#ifdef SKIN_CACHE
+/* Skin cache
+ *
+ * A successfully parsed skin is written to <skin file>c (e.g. cabbiev2.wpsc)
+ * straight from the skin buffer, before any bitmaps or fonts are loaded. As
+ * everything in the buffer is stored as an offset, the next load only has
+ * to read it back and fix up the few real pointers, instead of parsing the
+ * source again.
+ *
+ * The parser bakes the current defaults into the tree (viewport sizes and
+ * colours, the UI font, RTL, ...), so the cache is only used if those, the
+ * build, and the size and time of the source are the same as when it was
+ * written. Bitmaps and fonts are read fresh on every load regardless.
+ */
+#define SKIN_CACHE_MAGIC    0x52425343 /* "RBSC" */
+#define SKIN_CACHE_VERSION  1
+
+/* backdrop_filename values that don't point into the skin buffer */
+#define SKIN_CACHE_BACKDROP_NONE    (-1)
+#define SKIN_CACHE_BACKDROP_DEFAULT (-2)
+#define SKIN_CACHE_BACKDROP_BUFFER  (-3)
+
+struct skin_cache_header {
+    uint32_t magic;
+    uint32_t build;       /* version and struct layouts */
+    uint32_t environment; /* see skin_cache_environment() */
+    uint32_t source;      /* size and time of the skin file */
+    uint32_t size;        /* of the skin buffer that follows */
+    struct wps_data data;
+#ifdef HAVE_BACKDROP_IMAGE
+    skinoffset_t backdrop;
+#endif
+    skinoffset_t font_names[MAXUSERFONTS];
+    int font_glyphs[MAXUSERFONTS];
+};
+
+static uint32_t skin_cache_hash(uint32_t hash, const void *data, size_t len)
+{
+    const unsigned char *p = data;
+    while (len--)
+        hash = (hash ^ *p++) * 16777619;
+    return hash;
+}
+
+static uint32_t skin_cache_build(void)
+{
+    static const unsigned short sizes[] = {
+        SKIN_CACHE_VERSION,
+        sizeof(struct skin_element), sizeof(struct skin_tag_parameter),
+        sizeof(struct wps_data), sizeof(struct wps_token),
+        sizeof(struct skin_viewport), sizeof(struct gui_img),
+        sizeof(struct progressbar),
+#ifdef HAVE_TOUCHSCREEN
+        sizeof(struct touchregion),
+#endif
+    };
+    const struct tag_info *tag;
+    uint32_t hash = skin_cache_hash(2166136261u, rbversion, strlen(rbversion));
+    int i;
+
+    /* the tree stores tags as indexes into the table */
+    for (i = 0; (tag = tag_from_index(i))->type != SKIN_TOKEN_UNKNOWN; i++)
+    {
+        hash = skin_cache_hash(hash, &tag->type, sizeof(tag->type));
+        hash = skin_cache_hash(hash, &tag->flags, sizeof(tag->flags));
+        hash = skin_cache_hash(hash, tag->name, strlen(tag->name) + 1);
+        hash = skin_cache_hash(hash, tag->params, strlen(tag->params) + 1);
+    }
+    return skin_cache_hash(hash, sizes, sizeof(sizes));
+}
+
+/* everything the parser reads from outside of the skin source */
+static uint32_t skin_cache_environment(enum screen_type screen)
+{
+    struct viewport vp;
+    int values[4];
+    uint32_t hash = 2166136261u;
+
+    viewport_set_defaults(&vp, screen);
+    hash = skin_cache_hash(hash, &vp, sizeof(vp));
+    values[0] = font_get(vp.font)->height;
+    viewport_set_fullscreen(&vp, screen);
+    hash = skin_cache_hash(hash, &vp, sizeof(vp));
+
+    values[1] = lang_is_rtl();
+    values[2] = global_settings.glyphs_to_cache;
+#if CONFIG_TUNER
+    values[3] = radio_hardware_present();
+#else
+    values[3] = 0;
+#endif
+    hash = skin_cache_hash(hash, values, sizeof(values));
+#ifdef HAVE_LCD_COLOR
+    values[0] = global_settings.lss_color;
+    values[1] = global_settings.lse_color;
+    values[2] = global_settings.lst_color;
+    values[3] = 0;
+    hash = skin_cache_hash(hash, values, sizeof(values));
+#endif
+    return hash;
+}
+
+/* size and time of the file from its directory entry, 0 if not found */
+static uint32_t skin_cache_stamp(const char *path)
+{
+    char dirname[MAX_PATH];
+    const char *name = strrchr(path, '/');
+    struct dirent *entry;
+    uint32_t stamp = 0;
+    DIR *dir;
+
+    if (!name || name == path)
+        return 0;
+    strlcpy(dirname, path, name - path + 1);
+    name++;
+
+    dir = opendir(dirname);
+    if (!dir)
+        return 0;
+    while ((entry = readdir(dir)))
+    {
+        if (!strcasecmp((char *)entry->d_name, name))
+        {
+            struct dirinfo info = dir_get_info(dir, entry);
+            stamp = skin_cache_hash(2166136261u, &info.size, sizeof(info.size));
+            stamp = skin_cache_hash(stamp, &info.mtime, sizeof(info.mtime));
+            break;
+        }
+    }
+    closedir(dir);
+    return stamp;
+}
+
+/* Swap the pointers in the tree for table indexes (out = true) or back,
+ * redoing what the parser did besides filling in the buffer on the way in */
+static void skin_cache_relocate_tree(struct skin_element *element,
+                                     struct wps_data *data, bool out)
+{
+    for (; element; element = SKINOFFSETTOPTR(skin_buffer, element->next))
+    {
+        skinoffset_t *children = SKINOFFSETTOPTR(skin_buffer, element->children);
+        struct skin_tag_parameter *params =
+                SKINOFFSETTOPTR(skin_buffer, element->params);
+        int i;
+
+        if (out)
+        {
+            /* drop what's set again on the way in, so that the result
+               only depends on the skin */
+            if (element->type == LINE_ALTERNATOR)
+            {
+                struct line_alternator *alternator =
+                        SKINOFFSETTOPTR(skin_buffer, element->data);
+                alternator->next_change_tick = 0;
+            }
+            else if (element->type == TAG &&
+                     element->tag->type == SKIN_TOKEN_LIST_ITEM_CFG)
+            {
+                struct wps_token *token =
+                        SKINOFFSETTOPTR(skin_buffer, element->data);
+                struct listitem_viewport_cfg *cfg =
+                        SKINOFFSETTOPTR(skin_buffer, token->value.data);
+                cfg->data = NULL;
+            }
+            element->tag = (void *)(intptr_t)tag_to_index(element->tag);
+        }
+        else
+        {
+            element->tag = tag_from_index((intptr_t)element->tag);
+            if (element->type == LINE_ALTERNATOR)
+            {
+                struct line_alternator *alternator =
+                        SKINOFFSETTOPTR(skin_buffer, element->data);
+                alternator->next_change_tick = current_tick;
+            }
+            else if (element->type == TAG &&
+                     element->tag->type == SKIN_TOKEN_LIST_TITLE_TEXT)
+            {
+                sb_skin_has_title(curr_screen);
+            }
+            else if (element->type == TAG &&
+                     element->tag->type == SKIN_TOKEN_LIST_ITEM_CFG)
+            {
+                struct wps_token *token =
+                        SKINOFFSETTOPTR(skin_buffer, element->data);
+                struct listitem_viewport_cfg *cfg =
+                        SKINOFFSETTOPTR(skin_buffer, token->value.data);
+                cfg->data = data;
+            }
+        }
+
+        for (i = 0; i < element->children_count; i++)
+            skin_cache_relocate_tree(SKINOFFSETTOPTR(skin_buffer, children[i]),
+                                     data, out);
+        for (i = 0; i < element->params_count; i++)
+        {
+            if (params[i].type == CODE)
+                skin_cache_relocate_tree(
+                        SKINOFFSETTOPTR(skin_buffer, params[i].data.code),
+                        data, out);
+        }
+    }
+}
+
+static void skin_cache_relocate(struct wps_data *data, bool out)
+{
+    struct skin_token_list *list;
+
+    skin_cache_relocate_tree(SKINOFFSETTOPTR(skin_buffer, data->tree),
+                             data, out);
+
+    /* image filenames, until load_skin_bitmaps() replaces them */
+    list = SKINOFFSETTOPTR(skin_buffer, data->images);
+    while (list)
+    {
+        struct wps_token *token = SKINOFFSETTOPTR(skin_buffer, list->token);
+        struct gui_img *img = SKINOFFSETTOPTR(skin_buffer, token->value.data);
+        if (out)
+            img->bm.data = (unsigned char *)(intptr_t)
+                    PTRTOSKINOFFSET(skin_buffer, img->bm.data);
+        else
+            img->bm.data = SKINOFFSETTOPTR(skin_buffer, (intptr_t)img->bm.data);
+        list = SKINOFFSETTOPTR(skin_buffer, list->next);
+    }
+
+#ifdef HAVE_TOUCHSCREEN
+    list = SKINOFFSETTOPTR(skin_buffer, data->touchregions);
+    while (list)
+    {
+        struct wps_token *token = SKINOFFSETTOPTR(skin_buffer, list->token);
+        struct touchregion *region = SKINOFFSETTOPTR(skin_buffer, token->value.data);
+        switch (region->action)
+        {
+            case ACTION_SETTINGS_INC:
+            case ACTION_SETTINGS_DEC:
+            case ACTION_SETTINGS_SET:
+                if (out)
+                    region->setting_data.setting = (void *)(intptr_t)
+                            (region->setting_data.setting - settings);
+                else
+                    region->setting_data.setting =
+                        &settings[(intptr_t)region->setting_data.setting];
+                break;
+            case ACTION_TOUCH_MUTE:
+                if (!out)
+                    region->value = global_settings.volume;
+                break;
+            default:
+                break;
+        }
+        list = SKINOFFSETTOPTR(skin_buffer, list->next);
+    }
+#endif
+}
+
+#ifdef HAVE_BACKDROP_IMAGE
+static skinoffset_t skin_cache_backdrop(void)
+{
+    if (!backdrop_filename)
+        return SKIN_CACHE_BACKDROP_NONE;
+    else if (!strcmp(backdrop_filename, "-"))
+        return SKIN_CACHE_BACKDROP_DEFAULT;
+    else if (!strcmp(backdrop_filename, BACKDROP_BUFFERNAME))
+        return SKIN_CACHE_BACKDROP_BUFFER;
+    return PTRTOSKINOFFSET(skin_buffer, backdrop_filename);
+}
+#endif
+
+static void skin_cache_path(char *path, size_t size, const char *skin_file)
+{
+    snprintf(path, size, "%sc", skin_file);
+}
+
+/* call right after parsing, while the buffer is still as the parser left it */
+static void skin_cache_save(const char *skin_file, uint32_t environment,
+                            struct wps_data *data)
+{
+    struct skin_cache_header header;
+    char path[MAX_PATH];
+    bool ok;
+    int i, fd;
+
+    header.source = skin_cache_stamp(skin_file);
+    if (!header.source)
+        return;
+    header.magic = SKIN_CACHE_MAGIC;
+    header.build = skin_cache_build();
+    header.environment = environment;
+    header.size = skin_buffer_usage();
+    header.data = *data;
+#ifdef HAVE_BACKDROP_IMAGE
+    header.backdrop = skin_cache_backdrop();
+#endif
+    for (i = 0; i < MAXUSERFONTS; i++)
+    {
+        header.font_names[i] = PTRTOSKINOFFSET(skin_buffer, skinfonts[i].name);
+        header.font_glyphs[i] = skinfonts[i].glyphs;
+    }
+
+    skin_cache_path(path, sizeof(path), skin_file);
+    fd = open(path, O_WRONLY|O_CREAT|O_TRUNC, 0666);
+    if (fd < 0)
+        return;
+    skin_cache_relocate(data, true);
+    ok = write(fd, &header, sizeof(header)) == sizeof(header) &&
+         write(fd, skin_buffer, header.size) == (ssize_t)header.size;
+    skin_cache_relocate(data, false);
+    close(fd);
+    if (!ok)
+        remove(path);
+}
+
+/* Fill the skin buffer from the cache instead of parsing skin_file. Leaves
+ * things as a successful parse would, false if there's no usable cache. */
+static bool skin_cache_load(const char *skin_file, uint32_t environment,
+                            struct wps_data *data, char *buffer, size_t size)
+{
+    struct skin_cache_header header;
+    char path[MAX_PATH];
+    int i, fd;
+
+    skin_cache_path(path, sizeof(path), skin_file);
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    buffer = ALIGN_UP(buffer, 4);
+    size -= 3;
+    if (read(fd, &header, sizeof(header)) != sizeof(header) ||
+        header.magic != SKIN_CACHE_MAGIC ||
+        header.environment != environment ||
+        header.size > size ||
+        header.build != skin_cache_build() ||
+        header.source != skin_cache_stamp(skin_file) ||
+        read(fd, buffer, header.size) != (ssize_t)header.size)
+    {
+        close(fd);
+        return false;
+    }
+    close(fd);
+
+    skin_buffer = buffer;
+    skin_buffer_init(skin_buffer, size);
+    skin_buffer_alloc(header.size);
+
+    data->tree = header.data.tree;
+    data->images = header.data.images;
+#ifdef HAVE_BACKDROP_IMAGE
+    data->use_extra_framebuffer = header.data.use_extra_framebuffer;
+#endif
+#ifdef HAVE_TOUCHSCREEN
+    data->touchregions = header.data.touchregions;
+#endif
+#ifdef HAVE_ALBUMART
+    data->albumart = header.data.albumart;
+#endif
+#ifdef HAVE_SKIN_VARIABLES
+    data->skinvars = header.data.skinvars;
+#endif
+    data->peak_meter_enabled = header.data.peak_meter_enabled;
+    data->wps_sb_tag = header.data.wps_sb_tag;
+    data->show_sb_on_wps = header.data.show_sb_on_wps;
+    skin_cache_relocate(data, false);
+
+#ifdef HAVE_BACKDROP_IMAGE
+    data->backdrop_id = -1;
+    if (header.backdrop == SKIN_CACHE_BACKDROP_NONE)
+        backdrop_filename = NULL;
+    else if (header.backdrop == SKIN_CACHE_BACKDROP_DEFAULT)
+        backdrop_filename = "-";
+    else if (header.backdrop == SKIN_CACHE_BACKDROP_BUFFER)
+        backdrop_filename = BACKDROP_BUFFERNAME;
+    else
+        backdrop_filename = SKINOFFSETTOPTR(skin_buffer, header.backdrop);
+#endif
+    for (i = 0; i < MAXUSERFONTS; i++)
+    {
+        skinfonts[i].name = SKINOFFSETTOPTR(skin_buffer, header.font_names[i]);
+        skinfonts[i].glyphs = header.font_glyphs[i];
+    }
+#ifdef HAVE_ALBUMART
+    struct skin_albumart *aa = SKINOFFSETTOPTR(skin_buffer, data->albumart);
+    if (aa)
+    {
+        struct dim dimensions = { .width = aa->width, .height = aa->height };
+        int albumart_slot = playback_claim_aa_slot(&dimensions);
+        if (0 <= albumart_slot)
+            data->playback_aa_slot = albumart_slot;
+    }
+#endif
+    return true;
+}
+
+#ifdef DEBUG
+/* Parse skin_file again behind what skin_cache_load() left in the skin
+ * buffer and check that the load left the same wps_data, buffer contents
+ * and parser globals as the parse. 'fresh' is wps_data as it was before
+ * the load. A cache that doesn't match is removed. */
+static void skin_cache_check(const char *skin_file, struct wps_data *data,
+                             struct wps_data *fresh)
+{
+    char *cached = skin_buffer;
+    size_t used = skin_buffer_usage();
+    size_t size = used + skin_buffer_freespace();
+    char *source = cached + used;
+    size_t source_size = skin_read_file(skin_file, source, size - used);
+    char *parsed = ALIGN_UP(source + source_size, 4);
+#ifdef HAVE_BACKDROP_IMAGE
+    char *cached_backdrop = backdrop_filename;
+    skinoffset_t backdrop = skin_cache_backdrop();
+#endif
+    struct skin_font fonts[MAXUSERFONTS];
+    struct skin_element *tree;
+    const char *mismatch = NULL;
+    int i;
+
+    /* not enough room to parse it again next to the cached copy */
+    if (!source_size || parsed + used > cached + size)
+        return;
+
+    memcpy(fonts, skinfonts, sizeof(fonts));
+    for (i = 0; i < MAXUSERFONTS; i++)
+        skinfonts[i].name = NULL;
+
+    curr_line = NULL;
+    curr_vp = NULL;
+    curr_viewport_element = NULL;
+    first_viewport = NULL;
+#ifdef HAVE_BACKDROP_IMAGE
+    backdrop_filename = "-";
+    fresh->backdrop_id = -1;
+#endif
+    skin_buffer = parsed;
+    skin_buffer_init(skin_buffer, size - (parsed - cached));
+    tree = skin_parse(source, skin_element_callback, fresh);
+    fresh->tree = PTRTOSKINOFFSET(skin_buffer, tree);
+
+    if (!tree)
+        mismatch = "parse";
+    else if (skin_buffer_usage() != used)
+        mismatch = "buffer size";
+    /* fresh started out as a copy of data, so the padding matches too */
+    else if (memcmp(fresh, data, sizeof(*fresh)))
+        mismatch = "wps_data";
+#ifdef HAVE_BACKDROP_IMAGE
+    else if (skin_cache_backdrop() != backdrop)
+        mismatch = "backdrop";
+#endif
+
+    for (i = 0; !mismatch && i < MAXUSERFONTS; i++)
+    {
+        if (PTRTOSKINOFFSET(skin_buffer, skinfonts[i].name) !=
+            PTRTOSKINOFFSET(cached, fonts[i].name) ||
+            skinfonts[i].glyphs != fonts[i].glyphs)
+            mismatch = "fonts";
+    }
+
+    if (!mismatch)
+    {
+        /* compare both buffers as they would be saved */
+        skin_cache_relocate(fresh, true);
+        skin_buffer = cached;
+        skin_cache_relocate(data, true);
+        if (memcmp(cached, parsed, used))
+            mismatch = "skin buffer";
+        skin_cache_relocate(data, false);
+    }
+
+#ifdef HAVE_ALBUMART
+    /* the parse claimed the slot once more, skin_data_reset() left -1 */
+    if (fresh->playback_aa_slot >= 0)
+        playback_release_aa_slot(fresh->playback_aa_slot);
+#endif
+
+    skin_buffer = cached;
+    skin_buffer_init(skin_buffer, size);
+    skin_buffer_alloc(used);
+#ifdef HAVE_BACKDROP_IMAGE
+    backdrop_filename = cached_backdrop;
+#endif
+    memcpy(skinfonts, fonts, sizeof(fonts));
+
+    if (mismatch)
+    {
+        char path[MAX_PATH];
+
+        DEBUGF("skin cache for %s doesn't match the source: %s\n",
+               skin_file, mismatch);
+        skin_cache_path(path, sizeof(path), skin_file);
+        remove(path);
+    }
+}
+#endif /* DEBUG */
+#endif /* SKIN_CACHE */
+
 /* to setup up the wps-data from a format-buffer (isfile = false)
    from a (wps-)file (isfile = true)*/
 bool skin_data_load(enum screen_type screen, struct wps_data *wps_data,
@@ -2463,28 +2990,27 @@ bool skin_data_load(enum screen_type screen, struct wps_data *wps_data,
     curr_viewport_element = NULL;
     first_viewport = NULL;
 
+#ifdef SKIN_CACHE
+    uint32_t environment = skin_cache_environment(screen);
+#ifdef DEBUG
+    struct wps_data fresh = *wps_data;
+#endif
+    if (isfile && skin_cache_load(buf, environment, wps_data,
+                                  wps_buffer, buffersize))
+    {
+#ifdef DEBUG
+        skin_cache_check(buf, wps_data, &fresh);
+#endif
+        goto parsed;
+    }
+#endif
+
     if (isfile)
     {
-        int fd = open_utf8(buf, O_RDONLY);
+        size_t start = skin_read_file(buf, wps_buffer, buffersize);
 
-        if (fd < 0)
-            return false;
-        /* copy the file's content to the buffer for parsing,
-           ensuring that every line ends with a newline char. */
-        unsigned int start = 0;
-        while(read_line(fd, wps_buffer + start, buffersize - start) > 0)
-        {
-            start += strlen(wps_buffer + start);
-            if (start < buffersize - 1)
-            {
-                wps_buffer[start++] = '\n';
-                wps_buffer[start] = 0;
-            }
-        }
-        close(fd);
-        if (start <= 0)
+        if (!start)
             return false;
-        start++;
         skin_buffer = &wps_buffer[start];
         buffersize -= start;
     }
@@ -2511,6 +3037,11 @@ bool skin_data_load(enum screen_type screen, struct wps_data *wps_data,
         skin_data_reset(wps_data);
         return false;
     }
+#ifdef SKIN_CACHE
+    if (isfile)
+        skin_cache_save(buf, environment, wps_data);
+parsed:
+#endif
 
 #ifdef HAVE_LCD_BITMAP
     char bmpdir[MAX_PATH];
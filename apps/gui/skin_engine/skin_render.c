@@ -67,6 +67,7 @@ struct skin_draw_info {
     bool line_scrolls;
     bool force_redraw;
     bool viewport_change;
+    bool drew_graphics; /* a tag on the line drew something */
     
     char *buf;
     size_t buf_size;
@@ -196,7 +197,10 @@ static bool do_non_text_tags(struct gui_wps *gwps, struct skin_draw_info *info,
         case SKIN_TOKEN_PEAKMETER:
             data->peak_meter_enabled = true;
             if (do_refresh)
+            {
                 draw_peakmeters(gwps, info->line_number, vp);
+                info->drew_graphics = true;
+            }
             break;
         case SKIN_TOKEN_DRAWRECTANGLE:
             if (do_refresh)
@@ -223,6 +227,9 @@ static bool do_non_text_tags(struct gui_wps *gwps, struct skin_draw_info *info,
                     vp->fg_pattern = backup;
 #endif
                 }
+                gwps->display->damage_viewport_rect(rect->x, rect->y,
+                                                    rect->width, rect->height);
+                info->drew_graphics = true;
             }
             break;
         case SKIN_TOKEN_PEAKMETER_LEFTBAR:
@@ -240,7 +247,10 @@ static bool do_non_text_tags(struct gui_wps *gwps, struct skin_draw_info *info,
         {
             struct progressbar *bar = (struct progressbar*)SKINOFFSETTOPTR(skin_buffer, token->value.data);
             if (do_refresh)
+            {
                 draw_progressbar(gwps, info->line_number, bar);
+                info->drew_graphics = true;
+            }
         }
 #endif
         break;
@@ -249,7 +259,10 @@ static bool do_non_text_tags(struct gui_wps *gwps, struct skin_draw_info *info,
         {
             struct gui_img *img = SKINOFFSETTOPTR(skin_buffer, token->value.data);
             if (img && img->loaded && do_refresh)
+            {
                 img->display = 0;
+                info->drew_graphics = true;
+            }
         }
         break;
         case SKIN_TOKEN_IMAGE_DISPLAY_LISTICON:
@@ -284,6 +297,7 @@ static bool do_non_text_tags(struct gui_wps *gwps, struct skin_draw_info *info,
 
                     /* Clear the image, as in conditionals */
                     clear_image_pos(gwps, img);
+                    info->drew_graphics = true;
 
                     /* If the token returned a value which is higher than
                      * the amount of subimages, don't draw it. */
@@ -311,6 +325,7 @@ static bool do_non_text_tags(struct gui_wps *gwps, struct skin_draw_info *info,
                 }
 #endif
                 aa->draw_handle = handle;
+                info->drew_graphics = true;
             }
             break;
         }
@@ -319,11 +334,15 @@ static bool do_non_text_tags(struct gui_wps *gwps, struct skin_draw_info *info,
             gui_statusbar_draw(&(statusbars.statusbars[gwps->display->screen_type]),
                                info->refresh_type == SKIN_REFRESH_ALL,
                                SKINOFFSETTOPTR(skin_buffer, token->value.data));
+            info->drew_graphics = true;
             break;
         case SKIN_TOKEN_VIEWPORT_CUSTOMLIST:
             if (do_refresh)
+            {
                 skin_render_playlistviewer(SKINOFFSETTOPTR(skin_buffer, token->value.data), gwps,
                                            info->skin_vp, info->refresh_type);
+                info->drew_graphics = true;
+            }
             break;
         
 #endif /* HAVE_LCD_BITMAP */
@@ -450,6 +469,9 @@ static void do_tags_in_hidden_conditional(struct skin_element* branch,
 #endif
                             gwps->display->set_viewport(&skin_viewport->vp);
                             gwps->display->clear_viewport();
+                            gwps->display->damage_viewport_rect(0, 0,
+                                    skin_viewport->vp.width,
+                                    skin_viewport->vp.height);
                             gwps->display->set_viewport(&info->skin_vp->vp);
                             skin_viewport->hidden_flags |= VP_DRAW_HIDDEN;
 
@@ -627,6 +649,66 @@ static bool skin_render_line(struct skin_element* line, struct skin_draw_info *i
     return needs_update;
 }
 
+#ifdef HAVE_LCD_BITMAP
+static unsigned hash_string(unsigned hash, const char *str)
+{
+    if (str)
+        while (*str)
+            hash = (hash ^ (unsigned char)*str++) * 16777619u;
+    return (hash ^ 0xff) * 16777619u; /* keep "ab|" and "a|b" apart */
+}
+
+static unsigned hash_int(unsigned hash, unsigned val)
+{
+    int i;
+    for (i = 0; i < 4; i++, val >>= 8)
+        hash = (hash ^ (val & 0xff)) * 16777619u;
+    return hash;
+}
+
+/* Remember what a line is about to be written with and tell if it's the same
+ * as last time. A line that isn't rewritten keeps showing the old text, so
+ * this has to be called whenever the line would be written. */
+static bool line_unchanged(struct skin_element *line, struct skin_draw_info *info)
+{
+    unsigned hash = 2166136261u;
+    const struct line_desc *desc = &info->line_desc;
+    const struct viewport *vp = &info->skin_vp->vp;
+    struct line *data;
+
+    if (line->type == LINE_ALTERNATOR)
+    {
+        struct line_alternator *alternator = SKINOFFSETTOPTR(skin_buffer, line->data);
+        line = get_child(line->children, alternator->current_line);
+    }
+    data = SKINOFFSETTOPTR(skin_buffer, line->data);
+    if (!data)
+        return false;
+
+    hash = hash_string(hash, info->align.left);
+    hash = hash_string(hash, info->align.center);
+    hash = hash_string(hash, info->align.right);
+    hash = hash_int(hash, desc->height);
+    hash = hash_int(hash, desc->nlines);
+    hash = hash_int(hash, desc->line);
+    hash = hash_int(hash, desc->text_color);
+    hash = hash_int(hash, desc->line_color);
+    hash = hash_int(hash, desc->line_end_color);
+    hash = hash_int(hash, desc->style);
+    hash = hash_int(hash, desc->scroll);
+    hash = hash_int(hash, desc->separator_height);
+    /* %Vf and %Vb in a conditional change the colours, not the text */
+    hash = hash_int(hash, vp->fg_pattern);
+    hash = hash_int(hash, vp->bg_pattern);
+
+    if (hash == data->text_hash)
+        return true;
+
+    data->text_hash = hash;
+    return false;
+}
+#endif /* HAVE_LCD_BITMAP */
+
 static int get_subline_timeout(struct gui_wps *gwps, struct skin_element* line)
 {
     struct skin_element *element=line;
@@ -741,6 +823,9 @@ void skin_render_viewport(struct skin_element* viewport, struct gui_wps *gwps,
     
     struct align_pos * align = &info.align;
     bool needs_update, update_all = false;
+#ifdef HAVE_LCD_BITMAP
+    bool shares_row = false;
+#endif
     skin_buffer = get_skin_buffer(gwps->data);
 #ifdef HAVE_LCD_BITMAP
     /* Set images to not to be displayed */
@@ -766,6 +851,7 @@ void skin_render_viewport(struct skin_element* viewport, struct gui_wps *gwps,
         info.no_line_break = false;
         info.line_scrolls = false;
         info.force_redraw = false;
+        info.drew_graphics = false;
 #if (LCD_DEPTH > 1) || (defined(HAVE_REMOTE_LCD) && (LCD_REMOTE_DEPTH > 1))
         skin_viewport->fgbg_changed = false;
 #ifdef HAVE_LCD_COLOR
@@ -802,7 +888,20 @@ void skin_render_viewport(struct skin_element* viewport, struct gui_wps *gwps,
         }
 #endif
         /* only update if the line needs to be, and there is something to write */
-        if (refresh_type && (needs_update || update_all))
+        bool write = refresh_type && (needs_update || update_all);
+#ifdef HAVE_LCD_BITMAP
+        /* A dynamic tag doesn't mean the text actually changed. Lines that
+         * would come out the same are left alone, unless something else on
+         * their row was drawn, or they scroll (write_line() restarts the
+         * scroller if it was stopped). */
+        shares_row = shares_row || info.no_line_break;
+        if (write && line_unchanged(line, &info) &&
+            !(refresh_type & SKIN_REFRESH_STATIC) && !update_all &&
+            !info.force_redraw && !info.drew_graphics && !info.line_scrolls &&
+            !shares_row)
+            write = false;
+#endif
+        if (write)
         {
             if (info.force_redraw)
                 display->scroll_stop_viewport_rect(&skin_viewport->vp,
@@ -810,7 +909,15 @@ void skin_render_viewport(struct skin_element* viewport, struct gui_wps *gwps,
                     skin_viewport->vp.width, display->getcharheight());
             write_line(display, align, info.line_number,
                     info.line_scrolls, &info.line_desc);
+#ifdef HAVE_LCD_BITMAP
+            display->damage_viewport_rect(0,
+                    info.line_number*display->getcharheight(),
+                    skin_viewport->vp.width, display->getcharheight());
+#endif
         }
+#ifdef HAVE_LCD_BITMAP
+        shares_row = info.no_line_break;
+#endif
         if (!info.no_line_break)
             info.line_number++;
         line = SKINOFFSETTOPTR(skin_buffer, line->next);
@@ -820,6 +927,35 @@ void skin_render_viewport(struct skin_element* viewport, struct gui_wps *gwps,
 #endif
 }
 
+#ifdef HAVE_LCD_BITMAP
+static struct {
+    unsigned long total;
+    unsigned long second;     /* pixels since second_tick */
+    unsigned long per_second; /* last full second */
+    long second_tick;
+} pixel_stats[NB_SCREENS];
+
+static void count_pixels(enum screen_type screen, unsigned long pixels)
+{
+    pixel_stats[screen].total += pixels;
+    pixel_stats[screen].second += pixels;
+    if (TIME_AFTER(current_tick, pixel_stats[screen].second_tick + HZ))
+    {
+        /* a gap without rendering doesn't count */
+        if (!TIME_AFTER(current_tick, pixel_stats[screen].second_tick + 2*HZ))
+            pixel_stats[screen].per_second = pixel_stats[screen].second;
+        pixel_stats[screen].second = 0;
+        pixel_stats[screen].second_tick = current_tick;
+    }
+}
+
+unsigned long skin_get_pixels_pushed(int screen, unsigned long *per_second)
+{
+    *per_second = pixel_stats[screen].per_second;
+    return pixel_stats[screen].total;
+}
+#endif /* HAVE_LCD_BITMAP */
+
 void skin_render(struct gui_wps *gwps, unsigned refresh_mode)
 {
     struct wps_data *data = gwps->data;
@@ -892,6 +1028,10 @@ void skin_render(struct gui_wps *gwps, unsigned refresh_mode)
         if ((vp_refresh_mode&SKIN_REFRESH_ALL) == SKIN_REFRESH_ALL)
         {
             display->clear_viewport();
+#ifdef HAVE_LCD_BITMAP
+            display->damage_viewport_rect(0, 0, skin_viewport->vp.width,
+                                          skin_viewport->vp.height);
+#endif
         }
         /* render */
         if (viewport->children_count)
@@ -912,7 +1052,15 @@ void skin_render(struct gui_wps *gwps, unsigned refresh_mode)
     }
     /* Restore the default viewport */
     display->set_viewport(NULL);
+#ifdef HAVE_LCD_BITMAP
+    /* push only what was drawn, everything after a full refresh */
+    if ((refresh_mode&SKIN_REFRESH_ALL) == SKIN_REFRESH_ALL)
+        display->damage_viewport_rect(0, 0, display->getwidth(),
+                                      display->getheight());
+    count_pixels(display->screen_type, display->update_damage());
+#else
     display->update();
+#endif
 }
 
 #ifdef HAVE_LCD_BITMAP
@@ -995,6 +1143,9 @@ void skin_render_playlistviewer(struct playlistviewer* viewer,
                     vp->width, display->getcharheight());
             write_line(display, align, info.line_number,
                     info.line_scrolls, &info.line_desc);
+            display->damage_viewport_rect(0,
+                    info.line_number*display->getcharheight(),
+                    vp->width, display->getcharheight());
         }
         info.line_number++;
         info.offset++;
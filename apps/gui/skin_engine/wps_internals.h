@@ -41,6 +41,9 @@ int skin_get_num_skins(void);
 struct skin_stats *skin_get_stats(int number, int screen);
 #define skin_clear_stats(stats) memset(stats, 0, sizeof(struct skin_stats))
 bool skin_backdrop_get_debug(int index, char **path, int *ref_count, size_t *size);
+/* pixels pushed to the screen by skin rendering, in total and in the
+   last full second that was rendered */
+unsigned long skin_get_pixels_pushed(int screen, unsigned long *per_second);
 
 /* Timeout unit expressed in HZ. In WPS, all timeouts are given in seconds
    (possibly with a decimal fraction) but stored as integer values.
@@ -280,6 +283,7 @@ struct skin_albumart {
 
 struct line {
     unsigned update_mode;
+    unsigned text_hash; /* of what was last written, see skin_render.c */
 };
 
 struct line_alternator {
@@ -91,6 +91,7 @@
 #include "audio_thread.h"
 #include "playback.h"
 #include "tdspeed.h"
+#include "seek_index.h"
 #endif
 #if (CONFIG_CODEC == SWCODEC) && defined(HAVE_RECORDING) && !defined(SIMULATOR)
 #include "pcm_record.h"
@@ -376,6 +377,9 @@ static void init(void)
     init_dircache(true);
     init_dircache(false);
 #endif
+#if CONFIG_CODEC == SWCODEC
+    seek_index_init();
+#endif
 #ifdef HAVE_TAGCACHE
     init_tagcache();
 #endif
@@ -666,6 +670,9 @@ static void init(void)
     init_dircache(false);
     CHART("<init_dircache(false)");
 #endif
+#if CONFIG_CODEC == SWCODEC
+    seek_index_init();
+#endif
 #ifdef HAVE_TAGCACHE
     CHART(">init_tagcache");
     init_tagcache();
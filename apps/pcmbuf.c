@@ -28,6 +28,7 @@
 #include "pcm_mixer.h"
 #include "pcmbuf.h"
 #include "dsp-util.h"
+#include "spsc_index.h"
 #include "playback.h"
 #include "codec_thread.h"
 
@@ -110,6 +111,9 @@ static unsigned int pcmbuf_desc_count;
 static unsigned int position_key = 1;
 static unsigned int pcmbuf_sampr = 0;
 
+/* The codec thread owns chunk_widx and the PCM callback owns chunk_ridx;
+   each side reads the other's index with spsc_index_observe() so that chunk
+   data and descriptors are handed over without locking */
 static size_t chunk_ridx;
 static size_t chunk_widx;
 
@@ -152,6 +156,7 @@ static enum
 
 static bool crossfade_mixmode;
 static bool crossfade_auto_skip;
+static unsigned long crossfade_mixramp_ms; /* MixRamp overlap; 0 if none */
 static size_t crossfade_widx;
 static size_t crossfade_bufidx;
 
@@ -215,8 +220,8 @@ static void start_audio_playback(void)
    a full chunk even if only partially filled) */
 static size_t pcmbuf_unplayed_bytes(void)
 {
-    size_t ridx = chunk_ridx;
-    size_t widx = chunk_widx;
+    size_t ridx = spsc_index_observe(&chunk_ridx);
+    size_t widx = spsc_index_observe(&chunk_widx);
 
     if (ridx > widx)
         widx += pcmbuf_size;
@@ -283,8 +288,8 @@ static bool index_committed(size_t index)
     if (index == INVALID_BUF_INDEX)
         return false;
 
-    size_t ridx = chunk_ridx;
-    size_t widx = chunk_widx;
+    size_t ridx = spsc_index_observe(&chunk_ridx);
+    size_t widx = spsc_index_observe(&chunk_widx);
 
     if (widx < ridx)
     {
@@ -309,9 +314,9 @@ void snip_buffer_tail(size_t index, int offset)
     if (!index_committed(index) && index != chunk_widx)
         return;
 
-    chunk_widx = index;
-    pcmbuf_bytes_waiting = 0;
     index_chunkdesc(index)->pos_key = 0;
+    spsc_index_publish(&chunk_widx, index);
+    pcmbuf_bytes_waiting = 0;
 
 #ifdef HAVE_CROSSFADE
     /* Kill crossfade if it would now be operating in the void */
@@ -349,7 +354,8 @@ static void commit_chunks(size_t threshold)
 
         /* Advance the current write chunk and make it available to the
            PCM callback */
-        chunk_widx = index = index_next(index);
+        index = index_next(index);
+        spsc_index_publish(&chunk_widx, index);
         desc = index_chunkdesc(index);
 
         /* Reset it before using it */
@@ -508,7 +514,8 @@ void * pcmbuf_request_buffer(int *count)
 #ifdef HAVE_CROSSFADE
     if (crossfade_status != CROSSFADE_INACTIVE)
     {
-        crossfade_bufidx = index_chunk_offs(chunk_ridx, -1);
+        crossfade_bufidx =
+            index_chunk_offs(spsc_index_observe(&chunk_ridx), -1);
         buf = index_buffer(crossfade_bufidx); /* always CROSSFADE_BUFSIZE */
     }
     else
@@ -621,7 +628,8 @@ size_t pcmbuf_init(void *bufend)
 static void pcmbuf_monitor_track_change_ex(size_t index)
 {
     /* Call with PCM lockout */
-    if (chunk_ridx != chunk_widx && index != INVALID_BUF_INDEX)
+    if (spsc_index_observe(&chunk_ridx) != chunk_widx &&
+        index != INVALID_BUF_INDEX)
     {
         /* If monitoring, set flag for one previous to specified chunk */
         index = index_chunk_offs(index, -1);
@@ -650,7 +658,7 @@ static void pcmbuf_cancel_track_change(bool position)
     if (!position)
         return;
 
-    size_t index = chunk_ridx;
+    size_t index = spsc_index_observe(&chunk_ridx);
 
     while (1)
     {
@@ -801,11 +809,12 @@ static void pcmbuf_pcm_callback(const void **start, size_t *size)
         }
 
         /* Free it for reuse */
-        chunk_ridx = index = index_next(index);
+        index = index_next(index);
+        spsc_index_publish(&chunk_ridx, index);
     }
 
     /*- Process the new one -*/
-    if (index != chunk_widx && !fade_out_complete)
+    if (index != spsc_index_observe(&chunk_widx) && !fade_out_complete)
     {
         current_desc = desc = index_chunkdesc(index);
 
@@ -827,7 +836,7 @@ void pcmbuf_play_start(void)
     logf("pcmbuf_play_start");
 
     if (mixer_channel_status(PCM_MIXER_CHAN_PLAYBACK) == CHANNEL_STOPPED &&
-        chunk_widx != chunk_ridx)
+        chunk_widx != spsc_index_observe(&chunk_ridx))
     {
         current_desc = NULL;
         mixer_channel_play_data(PCM_MIXER_CHAN_PLAYBACK, pcmbuf_pcm_callback,
@@ -924,6 +933,93 @@ static FORCE_INLINE int32_t mixfade_sample(const struct mixfader *faderp, int32_
     return (faderp->factor * s + MIXFADE_UNITY/2) >> MIXFADE_UNITY_BITS;
 }
 
+/* The fader routines below step the envelope per sample only while it
+   ramps; the constant remainder (silence or unity for a finished fade) is
+   handled in bulk, which gives the same result */
+
+/* Fade the input samples into the output */
+static void mixfade_copy(struct mixfader *faderp, int16_t *outbuf,
+                         const int16_t *inbuf, size_t size)
+{
+    for (; size != 0 && !mixfader_finished(faderp);
+         size -= PCMBUF_SAMPLE_SIZE)
+    {
+        *outbuf++ = mixfade_sample(faderp, *inbuf++);
+        *outbuf++ = mixfade_sample(faderp, *inbuf++);
+        mixfader_step(faderp);
+    }
+
+    if (size == 0)
+        return;
+
+    if (faderp->factor == MIXFADE_UNITY)
+        memcpy(outbuf, inbuf, size);
+    else if (faderp->factor == 0)
+        memset(outbuf, 0, size);
+    else
+    {
+        for (; size != 0; size -= sizeof (int16_t))
+            *outbuf++ = mixfade_sample(faderp, *inbuf++);
+    }
+}
+
+/* Fade the input samples and mix them into the output */
+static void mixfade_mix(struct mixfader *faderp, int16_t *outbuf,
+                        const int16_t *inbuf, size_t size)
+{
+    for (; size != 0 && !mixfader_finished(faderp);
+         size -= PCMBUF_SAMPLE_SIZE)
+    {
+        int32_t left  = outbuf[0];
+        int32_t right = outbuf[1];
+        left  += mixfade_sample(faderp, *inbuf++);
+        right += mixfade_sample(faderp, *inbuf++);
+        *outbuf++ = clip_sample_16(left);
+        *outbuf++ = clip_sample_16(right);
+        mixfader_step(faderp);
+    }
+
+    if (size == 0 || faderp->factor == 0)
+        return;
+
+    if (faderp->factor == MIXFADE_UNITY)
+    {
+        for (; size != 0; size -= sizeof (int16_t), outbuf++)
+            *outbuf = clip_sample_16(*outbuf + *inbuf++);
+    }
+    else
+    {
+        for (; size != 0; size -= sizeof (int16_t), outbuf++)
+            *outbuf = clip_sample_16(*outbuf + mixfade_sample(faderp, *inbuf++));
+    }
+}
+
+/* Fade the output samples in place */
+static void mixfade_inplace(struct mixfader *faderp, int16_t *outbuf,
+                            size_t size)
+{
+    for (; size != 0 && !mixfader_finished(faderp);
+         size -= PCMBUF_SAMPLE_SIZE)
+    {
+        int32_t left  = outbuf[0];
+        int32_t right = outbuf[1];
+        *outbuf++ = mixfade_sample(faderp, left);
+        *outbuf++ = mixfade_sample(faderp, right);
+        mixfader_step(faderp);
+    }
+
+    if (size == 0 || faderp->factor == MIXFADE_UNITY)
+        return;
+
+    if (faderp->factor == 0)
+        memset(outbuf, 0, size);
+    else
+    {
+        for (; size != 0; size -= sizeof (int16_t), outbuf++)
+            *outbuf = mixfade_sample(faderp, *outbuf);
+    }
+}
+
 /* Cancel crossfade operation */
 static void crossfade_cancel(void)
 {
@@ -961,7 +1057,7 @@ static size_t crossfade_find_index(size_t index, size_t size)
 static size_t crossfade_find_buftail(bool auto_skip, size_t buffer_rem,
                                      size_t buffer_need, size_t *buffer_rem_outp)
 {
-    size_t index = chunk_ridx;
+    size_t index = spsc_index_observe(&chunk_ridx);
 
     if (buffer_rem > buffer_need)
     {
@@ -1039,42 +1135,25 @@ static void crossfade_mix_fade(struct mixfader *faderp, size_t size,
         if (alloced)
         {
             /* Fade the input buffer into the new destination chunk */
-            for (size_t s = amount; s != 0; s -= PCMBUF_SAMPLE_SIZE)
-            {
-                *outbuf++ = mixfade_sample(faderp, *inbuf++);
-                *outbuf++ = mixfade_sample(faderp, *inbuf++);
-                mixfader_step(faderp);
-            }
-
+            mixfade_copy(faderp, outbuf, inbuf, amount);
             commit_write_buffer(amount);
         }
         else if (inbuf)
         {
             /* Fade the input buffer and mix into the destination chunk */
-            for (size_t s = amount; s != 0; s -= PCMBUF_SAMPLE_SIZE)
-            {
-                int32_t left  = outbuf[0];
-                int32_t right = outbuf[1];
-                left  += mixfade_sample(faderp, *inbuf++);
-                right += mixfade_sample(faderp, *inbuf++);
-                *outbuf++ = clip_sample_16(left);
-                *outbuf++ = clip_sample_16(right);
-                mixfader_step(faderp);
-            }
+            mixfade_mix(faderp, outbuf, inbuf, amount);
         }
         else
         {
             /* Fade the chunk in place */
-            for (size_t s = amount; s != 0; s -= PCMBUF_SAMPLE_SIZE)
-            {
-                int32_t left  = outbuf[0];
-                int32_t right = outbuf[1];
-                *outbuf++ = mixfade_sample(faderp, left);
-                *outbuf++ = mixfade_sample(faderp, right);
-                mixfader_step(faderp);
-            }
+            mixfade_inplace(faderp, outbuf, amount);
         }
 
+        outbuf = SKIPBYTES(outbuf, amount);
+
+        if (inbuf)
+            inbuf = SKIPBYTES(inbuf, amount);
+
         if (outbuf < chunkend)
         {
             index += amount;
@@ -1150,6 +1229,19 @@ static void crossfade_start(void)
         fade_out_delay -= MIN(fade_out_delay, fade_in_delay);
         fade_in_delay = 0;
     }
+    else if (crossfade_mixramp_ms != 0)
+    {
+        /* Both tracks have MixRamp data: overlap the quiet tail and head at
+           full level for the time it gives, within the configured fade */
+        unsigned long overlap_ms =
+            MIN(crossfade_mixramp_ms,
+                (fade_out_delay + fade_out_rem) / BYTERATE * 1000);
+        fade_out_delay = overlap_ms * (pcmbuf_sampr / 10) / 100 *
+                         PCMBUF_SAMPLE_SIZE;
+        fade_out_rem = 0;
+        fade_in_delay = 0;
+        fade_in_duration = 0;
+    }
 
     size_t fade_out_need = fade_out_delay + fade_out_rem;
 
@@ -1246,6 +1338,13 @@ static void pcmbuf_finish_crossfade_enable(void)
         PCMBUF_WATERMARK;
 }
 
+/* Set the MixRamp overlap to use for the next automatic track change
+   crossfade instead of the configured fades; 0 to use the settings */
+void pcmbuf_set_mixramp_overlap(unsigned long overlap_ms)
+{
+    crossfade_mixramp_ms = overlap_ms;
+}
+
 void pcmbuf_request_crossfade_enable(int setting)
 {
     /* Next setting to be used, not applied now */
@@ -53,12 +53,15 @@ void pcmbuf_start_track_change(enum pcm_track_change_type type);
 #ifdef HAVE_CROSSFADE
 void pcmbuf_request_crossfade_enable(int setting);
 bool pcmbuf_is_same_size(void);
+void pcmbuf_set_mixramp_overlap(unsigned long overlap_ms);
 #else
 /* Dummy functions with sensible returns */
 static FORCE_INLINE void pcmbuf_request_crossfade_enable(bool on_off)
     { return; (void)on_off; }
 static FORCE_INLINE bool pcmbuf_is_same_size(void)
     { return true; }
+static FORCE_INLINE void pcmbuf_set_mixramp_overlap(unsigned long overlap_ms)
+    { return; (void)overlap_ms; }
 #endif
 
 /* Debug menu, other metrics */
@@ -38,12 +38,14 @@
 #include "abrepeat.h"
 #include "pcmbuf.h"
 #include "audio_thread.h"
+#include "seek_index.h"
 #include "playback.h"
 #include "misc.h"
 #include "settings.h"
 
 #ifdef HAVE_TAGCACHE
 #include "tagcache.h"
+#include "replaygain.h"
 #endif
 
 #ifdef HAVE_LCD_BITMAP
@@ -1527,6 +1529,28 @@ static bool autoresumable(struct mp3entry *id3)
 
     return is_resumable;
 }
+
+/* Use the database's loudness scan result for a track without ReplayGain
+   tags. Called on the buffering thread as the metadata finishes so that the
+   lookup stays off the audio thread. */
+static void audio_fill_scanned_loudness(struct mp3entry *id3)
+{
+    struct tagcache_search tcs;
+
+    if (!id3 || id3->track_gain || id3->album_gain ||
+        !tagcache_is_usable() || !tagcache_find_index(&tcs, id3->path))
+        return;
+
+    long data = tagcache_get_numeric(&tcs, tag_loudness);
+    tagcache_search_finish(&tcs);
+
+    if (data > 0)
+    {
+        /* Scan stores dB * 128 and Q2.14; this wants dB * 512 and Q7.24 */
+        parse_replaygain_int(false, LOUDNESS_GAIN(data) * 4,
+                             LOUDNESS_PEAK(data) << 10, id3);
+    }
+}
 #endif  /* HAVE_TAGCACHE */
 
 /* Start the codec for the current track scheduled to be decoded */
@@ -1612,6 +1636,9 @@ static bool audio_start_codec(bool auto_skip)
     /* All required data is now available for the codec */
     codec_go();
 
+    /* Get a seek index ready before the user seeks */
+    seek_index_prepare(cur_id3);
+
 #ifdef HAVE_TAGCACHE
     if (!autoresume_enable || cur_id3->elapsed || cur_id3->offset)
 #endif
@@ -1704,8 +1731,10 @@ static bool audio_load_albumart(struct track_info *infop,
         memset(&user_data, 0, sizeof(user_data));
         user_data.dim = &albumart_slots[i].dim;
 
-        /* We can only decode jpeg for embedded AA */
-        if (track_id3->has_embedded_albumart && track_id3->albumart.type == AA_TYPE_JPG)
+        /* We can only decode jpeg and png for embedded AA */
+        if (track_id3->has_embedded_albumart &&
+            (track_id3->albumart.type == AA_TYPE_JPG ||
+             track_id3->albumart.type == AA_TYPE_PNG))
         {
             user_data.embedded_albumart = &track_id3->albumart;
             hid = bufopen(track_id3->path, 0, TYPE_BITMAP, &user_data);
@@ -2395,11 +2424,34 @@ static void audio_finalise_track_change(void)
     audio_playlist_track_change();
 }
 
+#ifdef HAVE_CROSSFADE
+/* Give pcmbuf the MixRamp overlap between the outgoing track (still in the
+   codec slot) and the incoming one, if both have it */
+static void audio_set_mixramp_overlap(void)
+{
+    struct track_info info;
+    struct mp3entry *out_id3 = valid_mp3entry(id3_get(CODEC_ID3));
+    struct mp3entry *in_id3 = track_list_current(0, &info) ?
+                                valid_mp3entry(bufgetid3(info.id3_hid)) : NULL;
+    unsigned long overlap_ms = 0;
+
+    if (out_id3 && in_id3 && out_id3->mixramp_end && in_id3->mixramp_start)
+        overlap_ms = out_id3->mixramp_end + in_id3->mixramp_start;
+
+    pcmbuf_set_mixramp_overlap(overlap_ms);
+}
+#endif /* HAVE_CROSSFADE */
+
 /* Actually begin a transition and take care of the codec change - may complete
    it now or ask pcmbuf for notification depending on the type */
 static void audio_begin_track_change(enum pcm_track_change_type type,
                                      int trackstat)
 {
+#ifdef HAVE_CROSSFADE
+    if (type == TRACK_CHANGE_AUTO)
+        audio_set_mixramp_overlap();
+#endif
+
     /* Even if the new track is bad, the old track must be finished off */
     pcmbuf_start_track_change(type);
 
@@ -2726,7 +2778,7 @@ static void audio_stop_playback(void)
     /* Stop the codec and unload it */
     halt_decoding_track(true);
     pcmbuf_play_stop();
-    codec_unload();
+    codec_unload(); /* Hosted builds keep it resident for the next start */
 
     /* Save resume information  - "filling" might have been set to
        "STATE_ENDED" by caller in order to facilitate end of playlist */
@@ -3328,6 +3380,9 @@ static void buffer_event_finished_callback(unsigned short id, void *ev_data)
     case TYPE_ID3:
         /* The metadata handle for the last loaded track has been buffered.
            We can ask the audio thread to load the rest of the track's data. */
+#ifdef HAVE_TAGCACHE
+        audio_fill_scanned_loudness(bufgetid3(hid));
+#endif
         LOGFQUEUE("buffering > audio Q_AUDIO_FINISH_LOAD_TRACK: %d", hid);
         audio_queue_post(Q_AUDIO_FINISH_LOAD_TRACK, hid);
         break;
@@ -161,12 +161,12 @@ void* plugin_get_buffer(size_t *buffer_size);
 #define PLUGIN_MAGIC 0x526F634B /* RocK */
 
 /* increase this every time the api struct changes */
-#define PLUGIN_API_VERSION 237
+#define PLUGIN_API_VERSION 239
 
 /* update this to latest version if a change to the api struct breaks
    backwards compatibility (and please take the opportunity to sort in any
    new function which are "waiting" at the end of the function table) */
-#define PLUGIN_MIN_API_VERSION 237
+#define PLUGIN_MIN_API_VERSION 239
 
 /* plugin return codes */
 /* internal returns start at 0x100 to make exit(1..255) work */
@@ -798,6 +798,7 @@ struct plugin_api {
                            int tag, char *buf, long size);
     void (*tagcache_search_finish)(struct tagcache_search *tcs);
     long (*tagcache_get_numeric)(const struct tagcache_search *tcs, int tag);
+    void (*tagcache_update_numeric)(int idx_id, int tag, long data);
 #if defined(HAVE_TC_RAMCACHE) && defined(HAVE_DIRCACHE)
     bool (*tagcache_fill_tags)(struct mp3entry *id3, const char *filename);
 #endif
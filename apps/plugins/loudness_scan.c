@@ -0,0 +1,715 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/* Loudness scanner
+ *
+ * Decodes every database track that has no loudness result yet, measures its
+ * EBU R128 integrated loudness and true peak and stores them in the
+ * database's "loudness" field. Playback uses that as the track's ReplayGain
+ * when the file's tags have none.
+ *
+ * Decoding goes through the codec thread like test_codec does, with the
+ * codec's raw output fed straight to the meter and the DSP left out. That
+ * means playback has to be stopped while scanning. Results are committed as
+ * each track finishes, so an interrupted scan picks up where it left off the
+ * next time it's started.
+ */
+
+#include "plugin.h"
+#include "lib/pluginlib_actions.h"
+#include "lib/pluginlib_exit.h"
+
+static const struct button_mapping *plugin_contexts[] = { pla_main_ctx };
+
+#define SCAN_EXITBUTTON  PLA_EXIT
+#define SCAN_EXITBUTTON2 PLA_CANCEL
+
+/* ReplayGain 2.0 reference level in LUFS */
+#define REFERENCE_LUFS   (-18)
+
+/* Number of tracks handed to the database between progress updates */
+#define SCAN_BATCH       8
+
+/* Meter works on Q24 samples (headroom for codecs that overshoot) */
+#define SAMPLE_BITS      24
+
+/* Block energies are kept in Q36: (Q24 >> 6)^2 */
+#define ENERGY_SHIFT     6
+#define ENERGY_BITS      36
+
+/* Gated block loudness histogram: 0.1 LU bins from -70 to +5 LUFS */
+#define HIST_MIN_LUFS    (-70)
+#define HIST_BINS        750
+
+/* 10*log10(2) in Q16 */
+#define DB_PER_LOG2      197283
+
+#define ABS_DIFF(a, b)   ((a) > (b) ? (a) - (b) : (b) - (a))
+
+/** --- Metering --- **/
+
+/* K-weighting coefficients in Q28 for the common sample rates: the
+   high-shelf stage (b0, b1, b2, a1, a2) followed by the a1, a2 of the
+   high-pass stage (its b is always 1, -2, 1). Other rates use the closest
+   entry. */
+static const struct kweight_coefs
+{
+    unsigned long rate;
+    int32_t c[7];
+} kweight_table[] =
+{
+    {   8000, { 354770625, -194952724,  80027655,  -78753804,  50163904,
+               -521036802, 252835143 } },
+    {  11025, { 372195475, -352056837, 124502595, -195448268,  71654045,
+               -525335095, 257023733 } },
+    {  12000, { 376082472, -387468171, 137633621, -221185565,  78998031,
+               -526263196, 257932671 } },
+    {  16000, { 387431611, -491659773, 182981379, -295690720, 106008482,
+               -528895568, 260519426 } },
+    {  22050, { 397237593, -582700525, 231080645, -359248603, 136430860,
+               -531072063, 262667964 } },
+    {  24000, { 399405174, -602961189, 242909693, -373188260, 144106483,
+               -531540891, 263131928 } },
+    {  32000, { 405653729, -661663714, 279611303, -413134272, 168300134,
+               -532868450, 264447933 } },
+    {  44100, { 410932064, -711617024, 313822276, -446584019, 191285879,
+               -533963668, 265536094 } },
+    {  48000, { 412081942, -722546694, 321691121, -453832898, 196623811,
+               -534199296, 265770496 } },
+    {  64000, { 415361664, -753819269, 345000064, -474429168, 212536171,
+               -534865956, 266434249 } },
+    {  88200, { 418092350, -779973330, 365430307, -491483842, 226597713,
+               -535415325, 266981845 } },
+    {  96000, { 418682600, -785641210, 369974174, -495158584, 229738693,
+               -535533444, 267099656 } },
+};
+
+/* ITU-R BS.1770-4 Annex 2 true-peak interpolator: 4 phases of 12 taps,
+   exact in Q13 */
+#define TP_TAPS 12
+static const int16_t truepeak_coefs[4][TP_TAPS] =
+{
+    {   14,   90, -161,  272,  -487, 1125, 7964,  -838,  390, -218,  122,  -68 },
+    { -239,  240, -424,  730, -1364, 3810, 6388, -1641,  832, -477,  271, -155 },
+    { -155,  271, -477,  832, -1641, 6388, 3810, -1364,  730, -424,  240, -239 },
+    {  -68,  122, -218,  390,  -838, 7964, 1125,  -487,  272, -161,   90,   14 },
+};
+
+struct meter_channel
+{
+    int32_t x1, x2;                 /* shelf input history */
+    int32_t s1, s2;                 /* shelf output = high-pass input */
+    int32_t y1, y2;                 /* high-pass output */
+    int32_t hist[TP_TAPS];          /* true-peak history, newest first */
+};
+
+static struct meter
+{
+    unsigned long rate;             /* sample rate set up for */
+    const int32_t *c;               /* K-weighting coefficients */
+    bool truepeak;                  /* oversample for the peak */
+    unsigned int sub_len;           /* samples in 100 ms */
+    unsigned int sub_count;         /* samples in the current 100 ms */
+    unsigned int sub_num;           /* 100 ms sub-blocks seen so far */
+    uint64_t sub_energy[4];         /* last 4 sub-blocks (one 400 ms block) */
+    uint32_t peak;                  /* Q24 */
+    struct meter_channel ch[2];
+    uint32_t hist_count[HIST_BINS];
+    uint64_t hist_energy[HIST_BINS];
+} meter;
+
+static void meter_init(unsigned long rate)
+{
+    const struct kweight_coefs *best = &kweight_table[0];
+
+    for (unsigned int i = 1; i < ARRAYLEN(kweight_table); i++)
+    {
+        if (ABS_DIFF(kweight_table[i].rate, rate) < ABS_DIFF(best->rate, rate))
+            best = &kweight_table[i];
+    }
+
+    rb->memset(&meter, 0, sizeof (meter));
+    meter.rate = rate;
+    meter.c = best->c;
+    meter.truepeak = rate < 96000;
+    meter.sub_len = (rate + 5) / 10;
+}
+
+/* 10*log10(e / 2^ENERGY_BITS) - 0.691 in Q16 (e > 0) */
+static long energy_to_lufs(uint64_t e)
+{
+    int k = 63 - __builtin_clzll(e);
+    uint32_t m = k >= 30 ? e >> (k - 30) : e << (30 - k);
+    long log2 = (long)(k - ENERGY_BITS) * 65536;
+
+    /* m is in [1, 2) in Q30: square it to pull out each fraction bit */
+    for (long bit = 1 << 15; bit; bit >>= 1)
+    {
+        m = ((uint64_t)m * m) >> 30;
+        if (m >= (2u << 30))
+        {
+            m >>= 1;
+            log2 += bit;
+        }
+    }
+
+    return ((int64_t)log2 * DB_PER_LOG2 >> 16) - 691 * 65536 / 1000;
+}
+
+static void meter_add_block(uint64_t energy)
+{
+    if (energy == 0)
+        return;
+
+    long lufs = energy_to_lufs(energy);
+
+    /* Absolute gate */
+    if (lufs <= HIST_MIN_LUFS * 65536)
+        return;
+
+    long bin = (lufs - HIST_MIN_LUFS * 65536) * 10 >> 16;
+    if (bin >= HIST_BINS)
+        bin = HIST_BINS - 1;
+
+    meter.hist_count[bin]++;
+    meter.hist_energy[bin] += energy;
+}
+
+static inline int32_t meter_kweight(struct meter_channel *ch, int32_t x)
+{
+    const int32_t *c = meter.c;
+    int64_t acc;
+
+    acc  = (int64_t)c[0] * x + (int64_t)c[1] * ch->x1 + (int64_t)c[2] * ch->x2
+         - (int64_t)c[3] * ch->s1 - (int64_t)c[4] * ch->s2;
+    int32_t s = acc >> 28;
+    ch->x2 = ch->x1;
+    ch->x1 = x;
+
+    acc  = ((int64_t)s - 2 * (int64_t)ch->s1 + ch->s2) << 28;
+    acc -= (int64_t)c[5] * ch->y1 + (int64_t)c[6] * ch->y2;
+    int32_t y = acc >> 28;
+    ch->s2 = ch->s1;
+    ch->s1 = s;
+    ch->y2 = ch->y1;
+    ch->y1 = y;
+
+    return y;
+}
+
+static inline void meter_peak(struct meter_channel *ch, int32_t x)
+{
+    uint32_t peak = x < 0 ? -x : x;
+
+    if (meter.truepeak)
+    {
+        rb->memmove(&ch->hist[1], &ch->hist[0],
+                    (TP_TAPS - 1) * sizeof (ch->hist[0]));
+        ch->hist[0] = x;
+
+        for (int p = 0; p < 4; p++)
+        {
+            int64_t acc = 0;
+            for (int k = 0; k < TP_TAPS; k++)
+                acc += (int64_t)truepeak_coefs[p][k] * ch->hist[k];
+
+            int32_t v = acc >> 13;
+            uint32_t a = v < 0 ? -v : v;
+            if (a > peak)
+                peak = a;
+        }
+    }
+
+    if (peak > meter.peak)
+        meter.peak = peak;
+}
+
+/* Feed one frame of Q24 samples */
+static void meter_frame(const int32_t *x, int nch)
+{
+    uint64_t e = 0;
+
+    for (int i = 0; i < nch; i++)
+    {
+        struct meter_channel *ch = &meter.ch[i];
+        int32_t y = meter_kweight(ch, x[i]) >> ENERGY_SHIFT;
+        e += (int64_t)y * y;
+        meter_peak(ch, x[i]);
+    }
+
+    meter.sub_energy[meter.sub_num % 4] += e;
+
+    if (++meter.sub_count < meter.sub_len)
+        return;
+
+    /* 100 ms done: the last four make a 400 ms block with 75% overlap */
+    meter.sub_count = 0;
+
+    if (++meter.sub_num >= 4)
+    {
+        uint64_t sum = meter.sub_energy[0] + meter.sub_energy[1] +
+                       meter.sub_energy[2] + meter.sub_energy[3];
+        meter_add_block(sum / (4 * meter.sub_len));
+    }
+
+    meter.sub_energy[meter.sub_num % 4] = 0;
+}
+
+/* Gated integrated loudness in Q16 LUFS; false if nothing passed the
+   absolute gate */
+static bool meter_integrated(long *lufs)
+{
+    uint64_t energy = 0;
+    uint32_t count = 0;
+    long bin;
+
+    for (bin = 0; bin < HIST_BINS; bin++)
+    {
+        energy += meter.hist_energy[bin];
+        count  += meter.hist_count[bin];
+    }
+
+    if (count == 0)
+        return false;
+
+    /* Relative gate 10 LU below the absolute-gated loudness */
+    long gate = energy_to_lufs(energy / count) - 10 * 65536;
+    bin = (gate - HIST_MIN_LUFS * 65536) * 10 >> 16;
+    if (bin < 0)
+        bin = 0;
+
+    energy = 0;
+    count = 0;
+
+    for (; bin < HIST_BINS; bin++)
+    {
+        energy += meter.hist_energy[bin];
+        count  += meter.hist_count[bin];
+    }
+
+    if (count == 0 || energy / count == 0)
+        return false;
+
+    *lufs = energy_to_lufs(energy / count);
+    return true;
+}
+
+/** --- Codec interface --- **/
+
+static struct codec_api ci;
+static struct mp3entry id3;
+
+static unsigned char *codec_mallocbuf;
+static unsigned char *filebuf;
+static size_t filebuf_size;
+static size_t filebuf_len;
+static off_t filebuf_pos;
+static int fd = -1;
+
+static int stereo_mode;
+static int sample_depth;
+
+static volatile bool codec_running;
+static volatile long codec_action;
+
+static void *codec_get_buffer(size_t *size)
+{
+    *size = CODEC_SIZE;
+    return codec_mallocbuf;
+}
+
+static void scan_pcmbuf_insert(const void *ch1, const void *ch2, int count)
+{
+    const int nch = stereo_mode == STEREO_MONO ? 1 : 2;
+    /* 16 bit samples are Q15, deeper ones have sample_depth fraction bits */
+    const int shift = sample_depth <= 16 ?
+                        15 - SAMPLE_BITS : sample_depth - SAMPLE_BITS;
+    int32_t x[2];
+
+    for (int i = 0; i < count; i++)
+    {
+        for (int c = 0; c < nch; c++)
+        {
+            int32_t s;
+
+            if (stereo_mode == STEREO_INTERLEAVED)
+            {
+                s = sample_depth <= 16 ?
+                    ((const int16_t *)ch1)[2*i + c] :
+                    ((const int32_t *)ch1)[2*i + c];
+            }
+            else
+            {
+                const void *src = c ? ch2 : ch1;
+                s = sample_depth <= 16 ?
+                    ((const int16_t *)src)[i] : ((const int32_t *)src)[i];
+            }
+
+            x[c] = shift >= 0 ? s >> shift : s << -shift;
+        }
+
+        meter_frame(x, nch);
+    }
+
+    /* Prevent idle poweroff */
+    rb->reset_poweroff_timer();
+}
+
+static bool fill_filebuf(off_t pos)
+{
+    if (rb->lseek(fd, pos, SEEK_SET) != pos)
+        return false;
+
+    ssize_t n = rb->read(fd, filebuf, filebuf_size);
+    if (n < 0)
+        return false;
+
+    filebuf_pos = pos;
+    filebuf_len = n;
+    return true;
+}
+
+static void *request_buffer(size_t *realsize, size_t reqsize)
+{
+    *realsize = MIN((size_t)(ci.filesize - ci.curpos), reqsize);
+
+    if (ci.curpos < filebuf_pos ||
+        ci.curpos + *realsize > filebuf_pos + filebuf_len)
+    {
+        if (!fill_filebuf(ci.curpos))
+        {
+            *realsize = 0;
+            return filebuf;
+        }
+
+        *realsize = MIN(*realsize, filebuf_len);
+    }
+
+    return filebuf + (ci.curpos - filebuf_pos);
+}
+
+static size_t read_filebuf(void *ptr, size_t size)
+{
+    size_t realsize;
+    void *src = request_buffer(&realsize, size);
+
+    rb->memcpy(ptr, src, realsize);
+    ci.curpos += realsize;
+    return realsize;
+}
+
+static void advance_buffer(size_t amount)
+{
+    ci.curpos += amount;
+}
+
+static bool seek_buffer(size_t newpos)
+{
+    ci.curpos = newpos;
+    return true;
+}
+
+static void seek_complete(void)
+{
+}
+
+static long get_command(intptr_t *param)
+{
+    rb->yield();
+    return codec_action;
+    (void)param;
+}
+
+static bool loop_track(void)
+{
+    return false;
+}
+
+static void set_elapsed(unsigned long value)
+{
+    (void)value;
+}
+
+static void set_offset(size_t value)
+{
+    (void)value;
+}
+
+static void configure(int setting, intptr_t value)
+{
+    switch (setting)
+    {
+    case DSP_SET_FREQUENCY:
+        /* Restart the measurement only if the rate really changes */
+        if ((unsigned long)value != meter.rate)
+            meter_init(value);
+        break;
+    case DSP_SET_SAMPLE_DEPTH:
+        sample_depth = value;
+        break;
+    case DSP_SET_STEREO_MODE:
+        stereo_mode = value;
+        break;
+    }
+}
+
+static void init_ci(void)
+{
+    /* --- Our own implementations of the codec API functions --- */
+
+    ci.dsp = rb->dsp_get_config(CODEC_IDX_AUDIO);
+    ci.codec_get_buffer = codec_get_buffer;
+    ci.pcmbuf_insert = scan_pcmbuf_insert;
+    ci.set_elapsed = set_elapsed;
+    ci.read_filebuf = read_filebuf;
+    ci.request_buffer = request_buffer;
+    ci.advance_buffer = advance_buffer;
+    ci.seek_buffer = seek_buffer;
+    ci.seek_complete = seek_complete;
+    ci.set_offset = set_offset;
+    ci.configure = configure;
+    ci.get_command = get_command;
+    ci.loop_track = loop_track;
+
+    /* --- "Core" functions --- */
+
+    /* kernel/ system */
+    ci.sleep = rb->sleep;
+    ci.yield = rb->yield;
+
+    /* strings and memory */
+    ci.strcpy = rb->strcpy;
+    ci.strlen = rb->strlen;
+    ci.strcmp = rb->strcmp;
+    ci.strcat = rb->strcat;
+    ci.memset = rb->memset;
+    ci.memcpy = rb->memcpy;
+    ci.memmove = rb->memmove;
+    ci.memcmp = rb->memcmp;
+    ci.memchr = rb->memchr;
+#if defined(DEBUG) || defined(SIMULATOR)
+    ci.debugf = rb->debugf;
+#endif
+#ifdef ROCKBOX_HAS_LOGF
+    ci.logf = rb->logf;
+#endif
+
+    ci.qsort = rb->qsort;
+
+#ifdef RB_PROFILE
+    ci.profile_thread = rb->profile_thread;
+    ci.profstop = rb->profstop;
+    ci.profile_func_enter = rb->profile_func_enter;
+    ci.profile_func_exit = rb->profile_func_exit;
+#endif
+
+    ci.commit_dcache = rb->commit_dcache;
+    ci.commit_discard_dcache = rb->commit_discard_dcache;
+    ci.commit_discard_idcache = rb->commit_discard_idcache;
+
+#if NUM_CORES > 1
+    ci.create_thread = rb->create_thread;
+    ci.thread_thaw = rb->thread_thaw;
+    ci.thread_wait = rb->thread_wait;
+    ci.semaphore_init = rb->semaphore_init;
+    ci.semaphore_wait = rb->semaphore_wait;
+    ci.semaphore_release = rb->semaphore_release;
+#endif
+
+#if defined(CPU_ARM) && (CONFIG_PLATFORM & PLATFORM_NATIVE)
+    ci.__div0 = rb->__div0;
+#endif
+}
+
+static void codec_thread(void)
+{
+    const char *codecname = rb->get_codec_filename(id3.codectype);
+    int res = rb->codec_load_file(codecname, &ci);
+
+    if (res >= 0)
+        res = rb->codec_run_proc();
+
+    rb->codec_close();
+
+    if (res < 0)
+        codec_action = CODEC_ACTION_HALT;
+
+    codec_running = false;
+}
+
+/** --- Scanning --- **/
+
+static bool quit;
+
+static bool check_quit(int timeout)
+{
+    int button = pluginlib_getaction(timeout, plugin_contexts,
+                                     ARRAYLEN(plugin_contexts));
+
+    if (button == SCAN_EXITBUTTON || button == SCAN_EXITBUTTON2)
+        quit = true;
+    else
+        exit_on_usb(button);
+
+    return quit;
+}
+
+/* Measure one file; returns the packed database value or 0 on failure */
+static long scan_track(const char *path)
+{
+    long data = 0;
+
+    fd = rb->open(path, O_RDONLY);
+    if (fd < 0)
+        return 0;
+
+    rb->memset(&id3, 0, sizeof (id3));
+
+    if (!rb->get_metadata(&id3, fd, path) || !fill_filebuf(0))
+        goto exit;
+
+    init_ci();
+    ci.filesize = rb->filesize(fd);
+    ci.id3 = &id3;
+    ci.curpos = 0;
+
+    stereo_mode = STEREO_NONINTERLEAVED;
+    sample_depth = 16;
+    meter_init(id3.frequency ? id3.frequency : 44100);
+
+    codec_running = true;
+    codec_action = CODEC_ACTION_NULL;
+
+    rb->codec_thread_do_callback(codec_thread, NULL);
+
+    while (codec_running)
+    {
+        if (check_quit(HZ/4))
+            codec_action = CODEC_ACTION_HALT;
+    }
+
+    /* Be sure it is done */
+    rb->codec_thread_do_callback(NULL, NULL);
+
+    if (codec_action == CODEC_ACTION_HALT)
+        goto exit;
+
+    /* Never store 0 - that marks a track as not scanned */
+    long peak = meter.peak >> (SAMPLE_BITS - 14);
+    peak = MAX(MIN(peak, 0xffff), 1);
+
+    long gain = 0;
+    long lufs;
+    if (meter_integrated(&lufs))
+    {
+        /* Q16 dB -> dB * 128 */
+        gain = ((long)REFERENCE_LUFS * 65536 - lufs) >> 9;
+        gain = MAX(MIN(gain, 0x3fff), -0x4000);
+    }
+
+    data = LOUDNESS_PACK(gain, peak);
+
+exit:
+    rb->close(fd);
+    fd = -1;
+    return data;
+}
+
+static void show_progress(int done, int failed, const char *path)
+{
+    rb->lcd_clear_display();
+    rb->lcd_putsf(0, 0, "Scanned: %d", done);
+    rb->lcd_putsf(0, 1, "Failed: %d", failed);
+    rb->lcd_puts_scroll(0, 2, path);
+    rb->lcd_update();
+}
+
+static enum plugin_status scan_database(void)
+{
+    struct tagcache_search tcs;
+    int done = 0, failed = 0;
+
+    if (!rb->tagcache_search(&tcs, tag_filename))
+    {
+        rb->splash(HZ*2, "Database is not ready");
+        return PLUGIN_ERROR;
+    }
+
+    while (!quit && rb->tagcache_get_next(&tcs))
+    {
+        if (rb->tagcache_get_numeric(&tcs, tag_loudness) != 0)
+            continue;
+
+        if ((done + failed) % SCAN_BATCH == 0)
+        {
+            show_progress(done, failed, tcs.result);
+            if (check_quit(TIMEOUT_NOBLOCK))
+                break;
+        }
+
+        long data = scan_track(tcs.result);
+
+        if (data != 0)
+        {
+            rb->tagcache_update_numeric(tcs.idx_id, tag_loudness, data);
+            done++;
+        }
+        else if (!quit)
+        {
+            failed++;
+        }
+    }
+
+    rb->tagcache_search_finish(&tcs);
+    rb->lcd_scroll_stop();
+
+    rb->splashf(HZ*2, "%s: %d scanned, %d failed",
+                quit ? "Stopped" : "Done", done, failed);
+
+    return PLUGIN_OK;
+}
+
+enum plugin_status plugin_start(const void *parameter)
+{
+    size_t size;
+    enum plugin_status res;
+
+    (void)parameter;
+
+    /* Takes the audio buffer - stops playback */
+    codec_mallocbuf = rb->plugin_get_audio_buffer(&size);
+    codec_mallocbuf = (void *)ALIGN_UP((intptr_t)codec_mallocbuf,
+                                       sizeof (intptr_t));
+    filebuf = SKIPBYTES(codec_mallocbuf, CODEC_SIZE);
+    filebuf_size = size - CODEC_SIZE - sizeof (intptr_t);
+
+#ifdef HAVE_ADJUSTABLE_CPU_FREQ
+    rb->cpu_boost(true);
+#endif
+
+    res = scan_database();
+
+#ifdef HAVE_ADJUSTABLE_CPU_FREQ
+    rb->cpu_boost(false);
+#endif
+
+    return res;
+}
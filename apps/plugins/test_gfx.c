@@ -399,6 +399,139 @@ static void time_text(void) /* tests mono_bitmap performance */
                  count1, count2, count3, count4);
 }
 
+/* Pixel throughput of the bitmap blitters, on a 64x64 pattern. Results are
+ * in kilopixels per second. */
+#define BMP_SIZE 64
+static unsigned char mono_bm[BMP_SIZE/8 * BMP_SIZE];
+#if LCD_DEPTH == 16 && !defined(TEST_GREYLIB)
+static fb_data alpha_bm_data[BMP_SIZE * BMP_SIZE + BMP_SIZE * BMP_SIZE / 2 / sizeof(fb_data)];
+static struct bitmap alpha_bm =
+{
+    .width = BMP_SIZE, .height = BMP_SIZE, .format = FORMAT_NATIVE,
+    .alpha_offset = BMP_SIZE * BMP_SIZE * sizeof(fb_data),
+    .data = (unsigned char *)alpha_bm_data,
+};
+#endif
+
+static void init_bitmaps(void)
+{
+    int i;
+
+    for (i = 0; i < (int)sizeof(mono_bm); i++)
+        mono_bm[i] = rand_table[i & 0x3ff];
+#if LCD_DEPTH == 16 && !defined(TEST_GREYLIB)
+    unsigned char *alpha = alpha_bm.data + alpha_bm.alpha_offset;
+
+    for (i = 0; i < BMP_SIZE * BMP_SIZE; i++)
+        alpha_bm_data[i] = rand_table[(i + 0x155) & 0x3ff];
+    /* the glyph-like mix: mostly clear or solid, some partial edges */
+    for (i = 0; i < BMP_SIZE * BMP_SIZE / 2; i++)
+    {
+        unsigned rnd = rand_table[(i + 0x2aa) & 0x3ff];
+        alpha[i] = (rnd & 0x11) ? ((rnd & 0x22) ? 0xff : 0x00) : rnd;
+    }
+#endif
+}
+
+static void time_bitmap(void) /* tests mono_bitmap pixel throughput */
+{
+    long time_start;  /* start tickcount */
+    long time_end;    /* end tickcount */
+    int count1, count2, count3, count4;
+
+    /* Test 1: DRMODE_SOLID */
+    mylcd_set_drawmode(DRMODE_SOLID);
+    count1 = 0;
+    rb->sleep(0); /* sync to tick */
+    time_start = *rb->current_tick;
+    while((time_end = *rb->current_tick) - time_start < DURATION)
+    {
+        unsigned rnd = rand_table[count1++ & 0x3ff];
+        mylcd_mono_bitmap(mono_bm, (rnd >> 8) & 0x3f, rnd & 0x3f,
+                          BMP_SIZE, BMP_SIZE);
+    }
+
+    /* Test 2: DRMODE_FG */
+    mylcd_set_drawmode(DRMODE_FG);
+    count2 = 0;
+    rb->sleep(0); /* sync to tick */
+    time_start = *rb->current_tick;
+    while((time_end = *rb->current_tick) - time_start < DURATION)
+    {
+        unsigned rnd = rand_table[count2++ & 0x3ff];
+        mylcd_mono_bitmap(mono_bm, (rnd >> 8) & 0x3f, rnd & 0x3f,
+                          BMP_SIZE, BMP_SIZE);
+    }
+
+    /* Test 3: DRMODE_BG */
+    mylcd_set_drawmode(DRMODE_BG);
+    count3 = 0;
+    rb->sleep(0); /* sync to tick */
+    time_start = *rb->current_tick;
+    while((time_end = *rb->current_tick) - time_start < DURATION)
+    {
+        unsigned rnd = rand_table[count3++ & 0x3ff];
+        mylcd_mono_bitmap(mono_bm, (rnd >> 8) & 0x3f, rnd & 0x3f,
+                          BMP_SIZE, BMP_SIZE);
+    }
+
+    /* Test 4: DRMODE_COMPLEMENT */
+    mylcd_set_drawmode(DRMODE_COMPLEMENT);
+    count4 = 0;
+    rb->sleep(0); /* sync to tick */
+    time_start = *rb->current_tick;
+    while((time_end = *rb->current_tick) - time_start < DURATION)
+    {
+        unsigned rnd = rand_table[count4++ & 0x3ff];
+        mylcd_mono_bitmap(mono_bm, (rnd >> 8) & 0x3f, rnd & 0x3f,
+                          BMP_SIZE, BMP_SIZE);
+    }
+
+    rb->fdprintf(log_fd, "lcd_mono_bitmap (kpixels/s): %d/%d/%d/%d\n",
+                 count1 * (BMP_SIZE * BMP_SIZE / 1024),
+                 count2 * (BMP_SIZE * BMP_SIZE / 1024),
+                 count3 * (BMP_SIZE * BMP_SIZE / 1024),
+                 count4 * (BMP_SIZE * BMP_SIZE / 1024));
+}
+
+#if LCD_DEPTH == 16 && !defined(TEST_GREYLIB)
+static void time_alpha_bitmap(void) /* tests alpha blending throughput */
+{
+    long time_start;  /* start tickcount */
+    long time_end;    /* end tickcount */
+    int count1, count2;
+
+    /* Test 1: DRMODE_SOLID, blending onto the background colour */
+    rb->lcd_set_drawmode(DRMODE_SOLID);
+    count1 = 0;
+    rb->sleep(0); /* sync to tick */
+    time_start = *rb->current_tick;
+    while((time_end = *rb->current_tick) - time_start < DURATION)
+    {
+        unsigned rnd = rand_table[count1++ & 0x3ff];
+        rb->lcd_bmp_part(&alpha_bm, 0, 0, (rnd >> 8) & 0x3f, rnd & 0x3f,
+                         BMP_SIZE, BMP_SIZE);
+    }
+
+    /* Test 2: DRMODE_FG, blending onto the framebuffer */
+    rb->lcd_set_drawmode(DRMODE_FG);
+    count2 = 0;
+    rb->sleep(0); /* sync to tick */
+    time_start = *rb->current_tick;
+    while((time_end = *rb->current_tick) - time_start < DURATION)
+    {
+        unsigned rnd = rand_table[count2++ & 0x3ff];
+        rb->lcd_bmp_part(&alpha_bm, 0, 0, (rnd >> 8) & 0x3f, rnd & 0x3f,
+                         BMP_SIZE, BMP_SIZE);
+    }
+    rb->lcd_set_drawmode(DRMODE_SOLID);
+
+    rb->fdprintf(log_fd, "lcd_bmp_part, alpha (kpixels/s): %d/%d\n",
+                 count1 * (BMP_SIZE * BMP_SIZE / 1024),
+                 count2 * (BMP_SIZE * BMP_SIZE / 1024));
+}
+#endif
+
 static void time_put_line(void) /* tests put_line performance */
 {
     long time_start, time_end;
@@ -498,8 +631,9 @@ enum plugin_status plugin_start(const void* parameter)
     backlight_ignore_timeout();
 
     rb->splashf(0, "LCD driver performance test, please wait %d sec",
-                7*4*DURATION/HZ);
+                (8*4+2)*DURATION/HZ);
     init_rand_table();
+    init_bitmaps();
 
 #ifdef HAVE_ADJUSTABLE_CPU_FREQ
     cpu_freq = *rb->cpu_frequency; /* remember CPU frequency */
@@ -511,6 +645,10 @@ enum plugin_status plugin_start(const void* parameter)
     time_vline();
     time_fillrect();
     time_text();
+    time_bitmap();
+#if LCD_DEPTH == 16 && !defined(TEST_GREYLIB)
+    time_alpha_bitmap();
+#endif
     time_put_line();
 
 #ifdef HAVE_ADJUSTABLE_CPU_FREQ
@@ -20,12 +20,16 @@
  ****************************************************************************/
 
 #include <stdio.h>
+#include <stddef.h>
 #include "string-extra.h"
 #include "system.h"
 #include "albumart.h"
 #include "metadata.h"
 #include "buffering.h"
+#include "crc32.h"
+#include "dir.h"
 #include "dircache.h"
+#include "file.h"
 #include "misc.h"
 #include "pathfuncs.h"
 #include "settings.h"
@@ -98,15 +102,22 @@ static void fix_path_part(char* path, int offset, int count)
 }
 
 #ifdef USE_JPEG_COVER
+/* the plugin library has no PNG loader, don't let it find covers it can't
+ * decode */
+#ifndef PLUGIN
+static const char * extensions[] = { "jpeg", "jpg", "png", "bmp" };
+static const unsigned char extension_lens[] = { 4, 3, 3, 3 };
+#else
 static const char * extensions[] = { "jpeg", "jpg", "bmp" };
 static const unsigned char extension_lens[] = { 4, 3, 3 };
+#endif
 /* Try checking for several file extensions, return true if a file is found and
  * leaving the path modified to include the matching extension.
  */
 static bool try_exts(char *path, int len)
 {
     int i;
-    for (i = 0; i < 3; i++)
+    for (i = 0; i < (int)sizeof(extension_lens); i++)
     {
         if (extension_lens[i] + len > MAX_PATH)
             continue;
@@ -123,12 +134,12 @@ static bool try_exts(char *path, int len)
 #endif
 
 /* Look for the first matching album art bitmap in the following list:
- *  ./<trackname><size>.{jpeg,jpg,bmp}
- *  ./<albumname><size>.{jpeg,jpg,bmp}
+ *  ./<trackname><size>.{jpeg,jpg,png,bmp}
+ *  ./<albumname><size>.{jpeg,jpg,png,bmp}
  *  ./cover<size>.bmp
- *  ../<albumname><size>.{jpeg,jpg,bmp}
- *  ../cover<size>.{jpeg,jpg,bmp}
- *  ROCKBOX_DIR/albumart/<artist>-<albumname><size>.{jpeg,jpg,bmp}
+ *  ../<albumname><size>.{jpeg,jpg,png,bmp}
+ *  ../cover<size>.{jpeg,jpg,png,bmp}
+ *  ROCKBOX_DIR/albumart/<artist>-<albumname><size>.{jpeg,jpg,png,bmp}
  * <size> is the value of the size_string parameter, <trackname> and
  * <albumname> are read from the ID3 metadata.
  * If a matching bitmap is found, its filename is stored in buf.
@@ -343,6 +354,8 @@ void draw_album_art(struct gui_wps *gwps, int handle_id, bool clear)
             y += (aa->height - height) / 2;
     }
 
+    gwps->display->damage_viewport_rect(x, y, width, height);
+
     if (!clear)
     {
         /* Draw the bitmap */
@@ -367,4 +380,262 @@ void draw_album_art(struct gui_wps *gwps, int handle_id, bool clear)
     }
 }
 
+/* Album art thumbnail cache
+ *
+ * Decoding and scaling the art, big embedded jpegs especially, is slow and
+ * the same images come by again and again. What load_image() in buffering.c
+ * produces is therefore also written to ALBUMART_CACHE_DIR in the native LCD
+ * format, one file per source image and size, and later loads only have to
+ * read it back.
+ *
+ * Art in its own file is keyed by the path, size and time of that file.
+ * Embedded art is keyed by the image itself, so the tracks of an album that
+ * all carry the same picture share a single entry. The file name is a hash
+ * of the path or the image and the requested size. The header holds the
+ * whole key and is compared on load, so a clash only costs a decode.
+ *
+ * The directory holds at most ALBUMART_CACHE_MAX_FILES entries; the oldest
+ * ones make way for new ones.
+ */
+#define AA_CACHE_MAGIC      0x52424141 /* "RBAA" */
+#define AA_CACHE_VERSION    2
+#define ALBUMART_CACHE_MAX_FILES 256
+
+struct aa_cache_header {
+    uint32_t magic;
+    uint32_t format;        /* version and LCD format */
+    uint32_t filesize;      /* of the source file, 0 for embedded art */
+    uint32_t mtime;         /* of the source file, 0 for embedded art */
+    uint32_t crc;           /* of the embedded image, 0 for a file */
+    int32_t  size;          /* of the embedded image, 0 for a file */
+    int16_t  dim_width;     /* requested size */
+    int16_t  dim_height;
+    uint16_t pathlen;       /* source path follows the header, if a file */
+    uint16_t reserved;
+    /* not part of the key */
+    int16_t  width;         /* of the bitmap */
+    int16_t  height;
+    int32_t  bm_format;
+    int32_t  alpha_offset;
+    int32_t  datasize;      /* bitmap data follows the path */
+};
+
+/* Key and name of the last albumart_cache_load(), for the store that
+   follows a miss */
+static struct aa_cache_header aa_cache_last;
+static char aa_cache_last_name[MAX_PATH];
+
+/* Time of the file at path from its directory entry, 0 if not found */
+static uint32_t aa_cache_mtime(const char *path)
+{
+    char dirname[MAX_PATH];
+    const char *name = strrchr(path, '/');
+    struct dirent *entry;
+    uint32_t mtime = 0;
+    DIR *dir;
+
+    if (!name || name == path || name - path >= (int)sizeof(dirname))
+        return 0;
+    strlcpy(dirname, path, name - path + 1);
+    name++;
+
+    dir = opendir(dirname);
+    if (!dir)
+        return 0;
+    while ((entry = readdir(dir)))
+    {
+        if (!strcasecmp((char *)entry->d_name, name))
+        {
+            mtime = dir_get_info(dir, entry).mtime;
+            break;
+        }
+    }
+    closedir(dir);
+    return mtime;
+}
+
+/* CRC of the embedded image, read through buf. False if it can't be read */
+static bool aa_cache_crc(int fd, const struct mp3_albumart *aa,
+                         void *buf, int bufsize, uint32_t *crc)
+{
+    int left = aa->size;
+
+    if (bufsize <= 0 || lseek(fd, aa->pos, SEEK_SET) != aa->pos)
+        return false;
+
+    *crc = 0xffffffff;
+    while (left > 0)
+    {
+        int n = read(fd, buf, MIN(left, bufsize));
+        if (n <= 0)
+            return false;
+        *crc = crc_32(buf, n, *crc);
+        left -= n;
+    }
+    return true;
+}
+
+/* Fill in the key part of hdr and the cache file name for it, using buf as
+   scratch space. False if there is no key for the image. */
+static bool aa_cache_key(int fd, const char *path,
+                         const struct mp3_albumart *aa, const struct dim *dim,
+                         void *buf, int bufsize,
+                         struct aa_cache_header *hdr, char *name, int namelen)
+{
+    static const int format[] = {
+        AA_CACHE_VERSION, LCD_DEPTH,
+#ifdef LCD_PIXELFORMAT
+        LCD_PIXELFORMAT,
+#endif
+#ifdef LCD_STRIDEFORMAT
+        LCD_STRIDEFORMAT,
+#endif
+    };
+    uint32_t hash;
+
+    memset(hdr, 0, sizeof(*hdr));
+    hdr->magic = AA_CACHE_MAGIC;
+    hdr->format = crc_32(format, sizeof(format), 0xffffffff);
+    hdr->dim_width = dim->width;
+    hdr->dim_height = dim->height;
+    if (aa)
+    {
+        if (!aa_cache_crc(fd, aa, buf, bufsize, &hdr->crc))
+            return false;
+        hdr->size = aa->size;
+        hash = crc_32(&hdr->crc, sizeof(hdr->crc) + sizeof(hdr->size),
+                      0xffffffff);
+    }
+    else
+    {
+        /* a changed file replaces its old entry */
+        hdr->filesize = filesize(fd);
+        hdr->mtime = aa_cache_mtime(path);
+        hdr->pathlen = strlen(path);
+        hash = crc_32(path, hdr->pathlen, 0xffffffff);
+    }
+
+    snprintf(name, namelen, ALBUMART_CACHE_DIR "/%08lx.%dx%d",
+             (unsigned long)hash, dim->width, dim->height);
+    return true;
+}
+
+/* Remove the oldest entries until there is room for one more */
+static void aa_cache_prune(void)
+{
+    char name[MAX_PATH];
+
+    while (1)
+    {
+        struct dirent *entry;
+        uint32_t oldest_time = 0;
+        int count = 0;
+        DIR *dir = opendir(ALBUMART_CACHE_DIR);
+
+        if (!dir)
+            return;
+
+        name[0] = '\0';
+        while ((entry = readdir(dir)))
+        {
+            struct dirinfo info = dir_get_info(dir, entry);
+            if (info.attribute & ATTR_DIRECTORY)
+                continue;
+            if (!count++ || (uint32_t)info.mtime < oldest_time)
+            {
+                oldest_time = info.mtime;
+                snprintf(name, sizeof(name), ALBUMART_CACHE_DIR "/%s",
+                         entry->d_name);
+            }
+        }
+        closedir(dir);
+
+        if (count < ALBUMART_CACHE_MAX_FILES || remove(name) < 0)
+            return;
+    }
+}
+
+int albumart_cache_load(int fd, const char *path,
+                        const struct mp3_albumart *aa, const struct dim *dim,
+                        struct bitmap *bm, int maxsize)
+{
+    struct aa_cache_header *key = &aa_cache_last;
+    struct aa_cache_header hdr;
+    int rc = -1;
+
+    if (!aa_cache_key(fd, path, aa, dim, bm->data, maxsize, key,
+                      aa_cache_last_name, sizeof(aa_cache_last_name)))
+    {
+        key->magic = 0;
+        return -1;
+    }
+
+    int cfd = open(aa_cache_last_name, O_RDONLY);
+    if (cfd < 0)
+        return -1;
+
+    if (read(cfd, &hdr, sizeof(hdr)) == sizeof(hdr) &&
+        !memcmp(&hdr, key, offsetof(struct aa_cache_header, width)) &&
+        hdr.datasize > 0 && hdr.datasize <= maxsize)
+    {
+        char srcpath[MAX_PATH];
+
+        if (hdr.pathlen < sizeof(srcpath) &&
+            read(cfd, srcpath, hdr.pathlen) == hdr.pathlen &&
+            !memcmp(srcpath, path, hdr.pathlen) &&
+            read(cfd, bm->data, hdr.datasize) == hdr.datasize)
+        {
+            bm->width = hdr.width;
+            bm->height = hdr.height;
+#if (LCD_DEPTH > 1) || defined(HAVE_REMOTE_LCD) && (LCD_REMOTE_DEPTH > 1)
+            bm->format = hdr.bm_format;
+#endif
+#ifdef HAVE_LCD_COLOR
+            bm->alpha_offset = hdr.alpha_offset;
+#endif
+            rc = hdr.datasize;
+            logf("Album art from cache:%s", aa_cache_last_name);
+        }
+    }
+
+    close(cfd);
+    return rc;
+}
+
+void albumart_cache_store(const char *path, const struct bitmap *bm, int size)
+{
+    struct aa_cache_header hdr = aa_cache_last;
+    const char *name = aa_cache_last_name;
+
+    if (hdr.magic != AA_CACHE_MAGIC)
+        return;
+    aa_cache_last.magic = 0;
+
+    hdr.width = bm->width;
+    hdr.height = bm->height;
+#if (LCD_DEPTH > 1) || defined(HAVE_REMOTE_LCD) && (LCD_REMOTE_DEPTH > 1)
+    hdr.bm_format = bm->format;
+#endif
+#ifdef HAVE_LCD_COLOR
+    hdr.alpha_offset = bm->alpha_offset;
+#endif
+    hdr.datasize = size;
+
+    aa_cache_prune();
+
+    int cfd = open(name, O_WRONLY|O_CREAT|O_TRUNC, 0666);
+    if (cfd < 0 && mkdir(ALBUMART_CACHE_DIR) == 0)
+        cfd = open(name, O_WRONLY|O_CREAT|O_TRUNC, 0666);
+    if (cfd < 0)
+        return;
+
+    bool ok = write(cfd, &hdr, sizeof(hdr)) == sizeof(hdr) &&
+              write(cfd, path, hdr.pathlen) == hdr.pathlen &&
+              write(cfd, bm->data, size) == size;
+
+    close(cfd);
+    if (!ok)
+        remove(name);
+}
+
 #endif /* PLUGIN */
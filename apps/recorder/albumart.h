@@ -39,6 +39,17 @@ bool find_albumart(const struct mp3entry *id3, char *buf, int buflen,
 /* Draw the album art bitmap from the given handle ID onto the given Skin.
    Call with clear = true to clear the bitmap instead of drawing it. */
 void draw_album_art(struct gui_wps *gwps, int handle_id, bool clear);
+
+/* Thumbnail cache for load_image() in buffering.c. fd is the open source
+ * file (path), aa the embedded image in it, or NULL, and dim the size asked
+ * for. albumart_cache_load() reads the cached bitmap to bm->data and fills
+ * in the rest of bm, and returns the size of the data, or < 0 if there is
+ * no usable entry. It may move the file position of fd. On a miss, pass the
+ * decoded bitmap to albumart_cache_store() before loading another image. */
+int albumart_cache_load(int fd, const char *path,
+                        const struct mp3_albumart *aa, const struct dim *dim,
+                        struct bitmap *bm, int maxsize);
+void albumart_cache_store(const char *path, const struct bitmap *bm, int size);
 #endif
 
 bool search_albumart_files(const struct mp3entry *id3, const char *size_string,
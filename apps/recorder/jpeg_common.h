@@ -30,7 +30,7 @@
 
 #include "bmp.h"
 
-#define HUFF_LOOKAHEAD 8 /* # of bits of lookahead */
+#define HUFF_LOOKAHEAD 9 /* # of bits of lookahead */
 #define JPEG_READ_BUF_SIZE 16
 struct derived_tbl
 {
@@ -46,8 +46,9 @@ struct derived_tbl
     /* Lookahead tables: indexed by the next HUFF_LOOKAHEAD bits of
     the input data stream.  If the next Huffman code is no more
     than HUFF_LOOKAHEAD bits long, we can obtain its length and
-    the corresponding symbol directly from these tables. */
-    int look_nbits[1<<HUFF_LOOKAHEAD]; /* # bits, or 0 if too long */
+    the corresponding symbol directly from these tables. Nine bits covers
+    nearly all AC codes in typical tables, so the slow path is rare. */
+    unsigned char look_nbits[1<<HUFF_LOOKAHEAD]; /* # bits, or 0 if too long */
     unsigned char look_sym[1<<HUFF_LOOKAHEAD]; /* symbol, or unused */
 };
 
@@ -94,6 +94,7 @@ struct jpeg
     int restart_interval; /* number of MCUs between RSTm markers */
     int restart; /* blocks until next restart marker */
     int mcu_row; /* current row relative to first row of this row of MCUs */
+    int mcu_y; /* current row of MCUs, when output from the coefficient store */
     unsigned char *out_ptr; /* pointer to current row to output */
     int cur_row; /* current row relative to top of image */
     int set_rows;
@@ -113,6 +114,17 @@ struct jpeg
 #endif
     jpeg_pix_t *img_buf;
 
+    bool progressive; /* SOF2: coefficients are spread over several scans */
+    int scan_comps; /* components in the current scan */
+    int scan_ss, scan_se; /* spectral selection of the current scan */
+    int scan_ah, scan_al; /* successive approximation bit positions */
+    int16_t *coefs[3]; /* per component coefficient store, progressive only */
+    int coef_stride[3]; /* blocks per row of the coefficient store */
+    int coef_size[2]; /* int16_t per stored block, including nonzero map */
+    int coef_count[2]; /* coefficients stored per block */
+    signed char coef_slot[2][64]; /* zig-zag index -> stored slot, or -1 */
+    unsigned char coef_zz[2][64]; /* stored slot -> zig-zag index */
+
     int16_t quanttable[4][QUANT_TABLE_LENGTH];/* raw quantization tables 0-3 */
 
     struct huffman_table hufftable[2]; /* Huffman tables  */
@@ -615,6 +627,270 @@ extern void jpeg_idct8v(int16_t *ws, int16_t *end);
 extern void jpeg_idct8h(int16_t *ws, unsigned char *out, int16_t *end, int rowstep);
 #endif
 
+/* Hosted builds: the 8-point passes, which do most of the work for the
+ * larger images, on eight columns or rows at once with SSE2 or NEON. The
+ * sums and products are rearranged so that every multiply is one of two
+ * 16-bit inputs by a 16-bit constant, accumulated in 32 bits - the same
+ * arithmetic as the C versions above, so the output is identical for
+ * anything but out of range coefficients. */
+#if (CONFIG_PLATFORM & PLATFORM_HOSTED) && !defined(CPU_ARM) && \
+    !defined(CPU_COLDFIRE) && \
+    (defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define JPEG_IDCT_SIMD
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+typedef __m128i idct_v16;   /* 8 x int16 */
+typedef __m128i idct_v32;   /* 4 x int32 */
+
+#define idct_load(p)        _mm_loadu_si128((const __m128i *)(p))
+#define idct_store(p, v)    _mm_storeu_si128((__m128i *)(p), (v))
+#define idct_add(a, b)      _mm_add_epi32((a), (b))
+#define idct_sub(a, b)      _mm_sub_epi32((a), (b))
+#define idct_dup(n)         _mm_set1_epi32(n)
+#define idct_sra(v, n)      _mm_sra_epi32((v), _mm_cvtsi32_si128(n))
+#define idct_pack(lo, hi)   _mm_packs_epi32((lo), (hi))
+
+/* a * ka + b * kb for the low and high four lanes */
+INLINE void idct_mac(idct_v16 a, idct_v16 b, int ka, int kb,
+                     idct_v32 *lo, idct_v32 *hi)
+{
+    __m128i k = _mm_set1_epi32((kb << 16) | (ka & 0xffff));
+    *lo = _mm_madd_epi16(_mm_unpacklo_epi16(a, b), k);
+    *hi = _mm_madd_epi16(_mm_unpackhi_epi16(a, b), k);
+}
+
+INLINE void idct_transpose(idct_v16 *r)
+{
+    __m128i a0 = _mm_unpacklo_epi16(r[0], r[1]);
+    __m128i a1 = _mm_unpackhi_epi16(r[0], r[1]);
+    __m128i a2 = _mm_unpacklo_epi16(r[2], r[3]);
+    __m128i a3 = _mm_unpackhi_epi16(r[2], r[3]);
+    __m128i a4 = _mm_unpacklo_epi16(r[4], r[5]);
+    __m128i a5 = _mm_unpackhi_epi16(r[4], r[5]);
+    __m128i a6 = _mm_unpacklo_epi16(r[6], r[7]);
+    __m128i a7 = _mm_unpackhi_epi16(r[6], r[7]);
+    __m128i b0 = _mm_unpacklo_epi32(a0, a2);
+    __m128i b1 = _mm_unpackhi_epi32(a0, a2);
+    __m128i b2 = _mm_unpacklo_epi32(a1, a3);
+    __m128i b3 = _mm_unpackhi_epi32(a1, a3);
+    __m128i b4 = _mm_unpacklo_epi32(a4, a6);
+    __m128i b5 = _mm_unpackhi_epi32(a4, a6);
+    __m128i b6 = _mm_unpacklo_epi32(a5, a7);
+    __m128i b7 = _mm_unpackhi_epi32(a5, a7);
+    r[0] = _mm_unpacklo_epi64(b0, b4);
+    r[1] = _mm_unpackhi_epi64(b0, b4);
+    r[2] = _mm_unpacklo_epi64(b1, b5);
+    r[3] = _mm_unpackhi_epi64(b1, b5);
+    r[4] = _mm_unpacklo_epi64(b2, b6);
+    r[5] = _mm_unpackhi_epi64(b2, b6);
+    r[6] = _mm_unpacklo_epi64(b3, b7);
+    r[7] = _mm_unpackhi_epi64(b3, b7);
+}
+
+/* the eight values saturated to 0..255 */
+INLINE void idct_store_u8(unsigned char *out, idct_v16 v)
+{
+    _mm_storel_epi64((__m128i *)out, _mm_packus_epi16(v, v));
+}
+#else /* NEON */
+#include <arm_neon.h>
+
+typedef int16x8_t idct_v16;
+typedef int32x4_t idct_v32;
+
+#define idct_load(p)        vld1q_s16(p)
+#define idct_store(p, v)    vst1q_s16((p), (v))
+#define idct_add(a, b)      vaddq_s32((a), (b))
+#define idct_sub(a, b)      vsubq_s32((a), (b))
+#define idct_dup(n)         vdupq_n_s32(n)
+#define idct_sra(v, n)      vshlq_s32((v), vdupq_n_s32(-(n)))
+#define idct_pack(lo, hi)   vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi))
+
+INLINE void idct_mac(idct_v16 a, idct_v16 b, int ka, int kb,
+                     idct_v32 *lo, idct_v32 *hi)
+{
+    *lo = vmlal_n_s16(vmull_n_s16(vget_low_s16(a), ka), vget_low_s16(b), kb);
+    *hi = vmlal_n_s16(vmull_n_s16(vget_high_s16(a), ka), vget_high_s16(b), kb);
+}
+
+INLINE void idct_transpose(idct_v16 *r)
+{
+    int16x8x2_t t0 = vtrnq_s16(r[0], r[1]);
+    int16x8x2_t t1 = vtrnq_s16(r[2], r[3]);
+    int16x8x2_t t2 = vtrnq_s16(r[4], r[5]);
+    int16x8x2_t t3 = vtrnq_s16(r[6], r[7]);
+    int32x4x2_t u0 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[0]),
+                               vreinterpretq_s32_s16(t1.val[0]));
+    int32x4x2_t u1 = vtrnq_s32(vreinterpretq_s32_s16(t0.val[1]),
+                               vreinterpretq_s32_s16(t1.val[1]));
+    int32x4x2_t u2 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[0]),
+                               vreinterpretq_s32_s16(t3.val[0]));
+    int32x4x2_t u3 = vtrnq_s32(vreinterpretq_s32_s16(t2.val[1]),
+                               vreinterpretq_s32_s16(t3.val[1]));
+#define IDCT_COMBINE(half, x, y) \
+    vcombine_s16(vreinterpret_s16_s32(vget_##half##_s32(x)), \
+                 vreinterpret_s16_s32(vget_##half##_s32(y)))
+    r[0] = IDCT_COMBINE(low,  u0.val[0], u2.val[0]);
+    r[1] = IDCT_COMBINE(low,  u1.val[0], u3.val[0]);
+    r[2] = IDCT_COMBINE(low,  u0.val[1], u2.val[1]);
+    r[3] = IDCT_COMBINE(low,  u1.val[1], u3.val[1]);
+    r[4] = IDCT_COMBINE(high, u0.val[0], u2.val[0]);
+    r[5] = IDCT_COMBINE(high, u1.val[0], u3.val[0]);
+    r[6] = IDCT_COMBINE(high, u0.val[1], u2.val[1]);
+    r[7] = IDCT_COMBINE(high, u1.val[1], u3.val[1]);
+#undef IDCT_COMBINE
+}
+
+INLINE void idct_store_u8(unsigned char *out, idct_v16 v)
+{
+    vst1_u8(out, vqmovun_s16(v));
+}
+#endif /* __SSE2__ */
+
+/* 8-point IDCT of in[0..7], eight lanes at a time, with the DC term scaled
+ * up by CONST_BITS and offset by dc_add, and the results shifted down by
+ * shift. Odd part: with y7, y5, y3, y1 = in[7], in[5], in[3], in[1], each
+ * of tmp0..tmp3 from jpeg_idct8v() expands to four products. */
+#define IDCT_ODD0   FIX_0_298631336 - FIX_0_899976223 - FIX_1_961570560 + \
+                    FIX_1_175875602, FIX_1_175875602, \
+                    FIX_1_175875602 - FIX_1_961570560, \
+                    FIX_1_175875602 - FIX_0_899976223
+#define IDCT_ODD1   FIX_1_175875602, FIX_2_053119869 - FIX_2_562915447 - \
+                    FIX_0_390180644 + FIX_1_175875602, \
+                    FIX_1_175875602 - FIX_2_562915447, \
+                    FIX_1_175875602 - FIX_0_390180644
+#define IDCT_ODD2   FIX_1_175875602 - FIX_1_961570560, \
+                    FIX_1_175875602 - FIX_2_562915447, \
+                    FIX_3_072711026 - FIX_2_562915447 - FIX_1_961570560 + \
+                    FIX_1_175875602, FIX_1_175875602
+#define IDCT_ODD3   FIX_1_175875602 - FIX_0_899976223, \
+                    FIX_1_175875602 - FIX_0_390180644, FIX_1_175875602, \
+                    FIX_1_501321110 - FIX_0_899976223 - FIX_0_390180644 + \
+                    FIX_1_175875602
+
+INLINE void idct_odd(const idct_v16 *in, int k7, int k5, int k3, int k1,
+                     idct_v32 *lo, idct_v32 *hi)
+{
+    idct_v32 lo2, hi2;
+    idct_mac(in[7], in[5], k7, k5, lo, hi);
+    idct_mac(in[3], in[1], k3, k1, &lo2, &hi2);
+    *lo = idct_add(*lo, lo2);
+    *hi = idct_add(*hi, hi2);
+}
+
+INLINE void jpeg_idct8_simd(idct_v16 *in, int dc_add, int shift)
+{
+    idct_v32 tmp0[2], tmp1[2], tmp2[2], tmp3[2];
+    idct_v32 tmp10[2], tmp11[2], tmp12[2], tmp13[2];
+    idct_v32 rnd = idct_dup(dc_add);
+    int h;
+
+    /* Even part */
+    idct_mac(in[0], in[4], ONE << CONST_BITS, ONE << CONST_BITS,
+             &tmp0[0], &tmp0[1]);
+    idct_mac(in[0], in[4], ONE << CONST_BITS, -(ONE << CONST_BITS),
+             &tmp1[0], &tmp1[1]);
+    idct_mac(in[2], in[6], FIX_0_541196100,
+             FIX_0_541196100 - FIX_1_847759065, &tmp2[0], &tmp2[1]);
+    idct_mac(in[2], in[6], FIX_0_541196100 + FIX_0_765366865,
+             FIX_0_541196100, &tmp3[0], &tmp3[1]);
+
+    for (h = 0; h < 2; h++)
+    {
+        tmp0[h] = idct_add(tmp0[h], rnd);
+        tmp1[h] = idct_add(tmp1[h], rnd);
+        tmp10[h] = idct_add(tmp0[h], tmp3[h]);
+        tmp13[h] = idct_sub(tmp0[h], tmp3[h]);
+        tmp11[h] = idct_add(tmp1[h], tmp2[h]);
+        tmp12[h] = idct_sub(tmp1[h], tmp2[h]);
+    }
+
+    /* Odd part */
+    idct_odd(in, IDCT_ODD0, &tmp0[0], &tmp0[1]);
+    idct_odd(in, IDCT_ODD1, &tmp1[0], &tmp1[1]);
+    idct_odd(in, IDCT_ODD2, &tmp2[0], &tmp2[1]);
+    idct_odd(in, IDCT_ODD3, &tmp3[0], &tmp3[1]);
+
+#define IDCT_OUT(n, op, a, b) \
+    in[n] = idct_pack(idct_sra(op(a[0], b[0]), shift), \
+                      idct_sra(op(a[1], b[1]), shift))
+    IDCT_OUT(0, idct_add, tmp10, tmp3);
+    IDCT_OUT(7, idct_sub, tmp10, tmp3);
+    IDCT_OUT(1, idct_add, tmp11, tmp2);
+    IDCT_OUT(6, idct_sub, tmp11, tmp2);
+    IDCT_OUT(2, idct_add, tmp12, tmp1);
+    IDCT_OUT(5, idct_sub, tmp12, tmp1);
+    IDCT_OUT(3, idct_add, tmp13, tmp0);
+    IDCT_OUT(4, idct_sub, tmp13, tmp0);
+#undef IDCT_OUT
+}
+
+/* vertical-pass 8-point IDCT, all eight columns at once */
+static void jpeg_idct8v_simd(int16_t *ws, int16_t *end)
+{
+    idct_v16 in[8];
+    int i;
+
+    if ((end - ws) * V_IN_ST < 64)
+    {
+        jpeg_idct8v(ws, end);
+        return;
+    }
+
+    for (i = 0; i < 8; i++)
+        in[i] = idct_load(ws + 8 * i);
+#ifdef JPEG_IDCT_TRANSPOSE
+    /* columns are stored as rows */
+    idct_transpose(in);
+    ws += 64;
+#endif
+
+    jpeg_idct8_simd(in, ONE << (CONST_BITS - PASS1_BITS - 1),
+                    CONST_BITS - PASS1_BITS);
+
+    for (i = 0; i < 8; i++)
+        idct_store(ws + 8 * i, in[i]);
+}
+
+/* horizontal-pass 8-point IDCT, eight rows at a time */
+static void jpeg_idct8h_simd(int16_t *ws, unsigned char *out, int16_t *end,
+                             int rowstep)
+{
+    idct_v16 in[8];
+    int i, j;
+
+    for (; end - ws >= 64; ws += 64, out += 8 * rowstep)
+    {
+        for (i = 0; i < 8; i++)
+            in[i] = idct_load(ws + 8 * i);
+        idct_transpose(in);
+
+        jpeg_idct8_simd(in, ((ONE << (PASS1_BITS + 2)) +
+                             (128 << (PASS1_BITS + 3))) << CONST_BITS, DS_OUT);
+
+        idct_transpose(in);
+        for (i = 0; i < 8; i++)
+        {
+            unsigned char *row = out + i * rowstep;
+#ifndef HAVE_LCD_COLOR
+            idct_store_u8(row, in[i]);
+#else
+            unsigned char px[8];
+            idct_store_u8(px, in[i]);
+            for (j = 0; j < 8; j++)
+                row[JPEG_PIX_SZ * j] = px[j];
+#endif
+        }
+    }
+
+    if (ws < end)
+        jpeg_idct8h(ws, out, end, rowstep);
+    (void)j;
+}
+#endif /* hosted SIMD */
+
 #ifdef HAVE_LCD_COLOR
 /* vertical-pass 16-point IDCT */
 static void jpeg_idct16v(int16_t *ws, int16_t *end)
@@ -847,7 +1123,11 @@ static const struct idct_entry idct_tbl[] = {
     { PASS1_BITS, NULL, jpeg_idct1h },
     { PASS1_BITS, jpeg_idct2v, jpeg_idct2h },
     { 0, jpeg_idct4v, jpeg_idct4h },
+#ifdef JPEG_IDCT_SIMD
+    { 0, jpeg_idct8v_simd, jpeg_idct8h_simd },
+#else
     { 0, jpeg_idct8v, jpeg_idct8h },
+#endif
 #ifdef HAVE_LCD_COLOR
     { 0, jpeg_idct16v, jpeg_idct16h },
 #endif
@@ -958,15 +1238,25 @@ static int process_markers(struct jpeg* p_jpeg)
     int ret = 0; /* returned flags */
     bool done = false;
 
-    while (!done && (c = e_getc(p_jpeg, -1)))
+    while (!done)
     {
-        if (c != 0xFF) /* no marker? */
+        if (p_jpeg->marker) /* ended the previous scan */
         {
-            JDEBUGF("Non-marker data\n");
-            continue; /* discard */
+            c = p_jpeg->marker;
+            p_jpeg->marker = 0;
         }
+        else
+        {
+            if (!(c = e_getc(p_jpeg, -1)))
+                break;
+            if (c != 0xFF) /* no marker? */
+            {
+                JDEBUGF("Non-marker data\n");
+                continue; /* discard */
+            }
 
-        c = e_getc(p_jpeg, -1);
+            c = e_getc(p_jpeg, -1);
+        }
         JDEBUGF("marker value %X\n",c);
         switch (c)
         {
@@ -976,6 +1266,9 @@ static int process_markers(struct jpeg* p_jpeg)
         case 0x00: /* Zero stuffed byte */
             break; /* discard */
 
+        case 0xC2: /* SOF Huff  - Progressive DCT*/
+            p_jpeg->progressive = true;
+            /* fall through */
         case 0xC0: /* SOF Huff  - Baseline DCT */
             {
                 JDEBUGF("SOF marker ");
@@ -1018,7 +1311,6 @@ static int process_markers(struct jpeg* p_jpeg)
             break;
 
         case 0xC1: /* SOF Huff  - Extended sequential DCT*/
-        case 0xC2: /* SOF Huff  - Progressive DCT*/
         case 0xC3: /* SOF Huff  - Spatial (sequential) lossless*/
         case 0xC5: /* SOF Huff  - Differential sequential DCT*/
         case 0xC6: /* SOF Huff  - Differential progressive DCT*/
@@ -1031,7 +1323,7 @@ static int process_markers(struct jpeg* p_jpeg)
         case 0xCE: /* SOF Arith - Differential progressive DCT*/
         case 0xCF: /* SOF Arith - Differential spatial*/
             {
-                return (-4); /* other DCT model than baseline not implemented */
+                return (-4); /* other DCT models not implemented */
             }
 
         case 0xC4: /* Define Huffman Table(s) */
@@ -1103,6 +1395,7 @@ static int process_markers(struct jpeg* p_jpeg)
             break;
         case 0xD9: /* End of Image */
             JDEBUGF("EOI\n");
+            done = true;
             break;
         case 0x01: /* for temp private use arith code */
             JDEBUGF("private\n");
@@ -1117,7 +1410,7 @@ static int process_markers(struct jpeg* p_jpeg)
                 marker_size -= 2;
 
                 n = (marker_size-1-3)/2;
-                if (e_getc(p_jpeg, -1) != n || (n != 1 && n != 3))
+                if (e_getc(p_jpeg, -1) != n || n < 1 || n > 3)
                 {
                     return (-7); /* Unsupported SOS component specification */
                 }
@@ -1130,7 +1423,14 @@ static int process_markers(struct jpeg* p_jpeg)
                     p_jpeg->scanheader[i].AC_select = c & 0x0F;
                     marker_size -= 2;
                 }
-                /* skip spectral information */
+                p_jpeg->scan_comps = n;
+                /* spectral selection and successive approximation */
+                p_jpeg->scan_ss = e_getc(p_jpeg, -1);
+                p_jpeg->scan_se = e_getc(p_jpeg, -1);
+                c = e_getc(p_jpeg, -1);
+                p_jpeg->scan_ah = c >> 4;
+                p_jpeg->scan_al = c & 0x0F;
+                marker_size -= 3;
                 e_skip_bytes(p_jpeg, marker_size);
                 done = true;
             }
@@ -1568,13 +1868,24 @@ INLINE void fix_quant_tables(struct jpeg *p_jpeg)
 * is evaluated multiple times.
 */
 
+/* Any marker other than RSTm ends the scan: keep it for process_markers()
+ * and feed zeros from there on.
+ */
+INLINE unsigned char end_scan(struct jpeg* p_jpeg, unsigned char marker)
+{
+    while (marker == 0xFF) /* fill bytes */
+        marker = d_getc(p_jpeg, 0xD9);
+    p_jpeg->marker = marker;
+    return 0;
+}
+
 static void fill_bit_buffer(struct jpeg* p_jpeg)
 {
     unsigned char byte, marker;
 
     if (p_jpeg->marker_val)
         p_jpeg->marker_ind += 16;
-    byte = d_getc(p_jpeg, 0);
+    byte = p_jpeg->marker ? 0 : d_getc(p_jpeg, 0);
     if (UNLIKELY(byte == 0xFF)) /* legal marker can be byte stuffing or RSTm */
     {   /* simplification: just skip the (one-byte) marker code */
         marker = d_getc(p_jpeg, 0);
@@ -1583,10 +1894,12 @@ static void fill_bit_buffer(struct jpeg* p_jpeg)
             p_jpeg->marker_val = marker;
             p_jpeg->marker_ind = 8;
         }
+        else if (marker)
+            byte = end_scan(p_jpeg, marker);
     }
     p_jpeg->bitbuf = (p_jpeg->bitbuf << 8) | byte;
 
-    byte = d_getc(p_jpeg, 0);
+    byte = p_jpeg->marker ? 0 : d_getc(p_jpeg, 0);
     if (UNLIKELY(byte == 0xFF)) /* legal marker can be byte stuffing or RSTm */
     {   /* simplification: just skip the (one-byte) marker code */
         marker = d_getc(p_jpeg, 0);
@@ -1595,6 +1908,8 @@ static void fill_bit_buffer(struct jpeg* p_jpeg)
             p_jpeg->marker_val = marker;
             p_jpeg->marker_ind = 0;
         }
+        else if (marker)
+            byte = end_scan(p_jpeg, marker);
     }
     p_jpeg->bitbuf = (p_jpeg->bitbuf << 8) | byte;
     p_jpeg->bitbuf_bits += 16;
@@ -1664,6 +1979,8 @@ static void search_restart(struct jpeg *p_jpeg)
     }
     unsigned char byte;
     p_jpeg->bitbuf_bits = 0;
+    if (p_jpeg->marker) /* don't run into the next segment */
+        return;
     while ((byte = d_getc(p_jpeg, 0xFF)))
     {
         if (byte == 0xff)
@@ -1778,6 +2095,371 @@ static const int extend_offset[16] = /* entry n is (-1 << n) + 1 */
     } /* end slow decode */ \
 }
 
+/* Progressive JPEG (Annex G) sends the coefficients of the whole image in
+ * several scans, each adding a band of them or one more bit of precision, so
+ * they have to be kept until the last scan. Only those the scaled IDCT uses
+ * are stored, the same ones store_row_jpeg() keeps for a sequential image,
+ * along with one bit per coefficient telling whether it is nonzero, which
+ * the refinement scans need to stay in step with the bitstream. When DC is
+ * all that's needed the AC scans are skipped altogether. The store is then a
+ * little over two bytes per component per decoded pixel, at any scale.
+ */
+#define COEF_NZ(map, k)     ((map)[(k) >> 4] & BIT_N((k) & 15))
+#define COEF_SET_NZ(map, k) ((map)[(k) >> 4] |= BIT_N((k) & 15))
+
+/* Lay out the coefficient store in buf. Returns its size, or -1 if it does
+ * not fit in len bytes.
+ */
+static int alloc_coefs(struct jpeg *p_jpeg, unsigned char *buf, int len)
+{
+    int t, ci, k, size = 0;
+
+    for (t = 0; t < (int)ARRAYLEN(p_jpeg->k_need); t++)
+    {
+        int cols = BIT_N(MIN(p_jpeg->h_scale[t], 3));
+        int rows = BIT_N(MIN(p_jpeg->v_scale[t], 3));
+        int n = 0;
+        MEMSET(p_jpeg->coef_slot[t], -1, sizeof(p_jpeg->coef_slot[t]));
+        for (k = 0; k < 64; k++)
+        {
+            int zz = zig[k];
+            if ((k & 7) < cols && (k >> 3) < rows &&
+                (zz == 0 || zz < p_jpeg->k_need[t]))
+            {
+                p_jpeg->coef_slot[t][zz] = n;
+                p_jpeg->coef_zz[t][n++] = zz;
+            }
+        }
+        p_jpeg->coef_count[t] = n;
+        /* four words of nonzero map, unless AC scans are skipped */
+        p_jpeg->coef_size[t] = n + (p_jpeg->k_need[t] ? 4 : 0);
+    }
+    for (ci = 0; ci < (p_jpeg->blocks == 1 ? 1 : 3); ci++)
+    {
+#ifndef HAVE_LCD_COLOR
+        if (ci)
+            break; /* chroma DC is decoded but not kept */
+#endif
+        struct frame_component *fc = &p_jpeg->frameheader[ci];
+        int bytes;
+        p_jpeg->coef_stride[ci] = p_jpeg->x_mbl * fc->horizontal_sampling;
+        bytes = p_jpeg->coef_stride[ci] * p_jpeg->y_mbl *
+            fc->vertical_sampling * p_jpeg->coef_size[!!ci] * sizeof(int16_t);
+        if (bytes > len - size)
+            return -1;
+        p_jpeg->coefs[ci] = (int16_t *)(buf + size);
+        size += bytes;
+    }
+    MEMSET(buf, 0, size);
+    JDEBUGF("coefficient store: %d bytes\n", size);
+    return size;
+}
+
+/* skip the rest of a scan's entropy-coded data, up to the next marker */
+static void skip_scan(struct jpeg *p_jpeg)
+{
+    unsigned char *c;
+
+    while (!p_jpeg->marker)
+    {
+        if (!(c = jpeg_getc(p_jpeg)))
+            p_jpeg->marker = 0xD9; /* truncated, show what there is */
+        else if (*c == 0xFF)
+        {
+            unsigned char marker = d_getc(p_jpeg, 0xD9);
+            if (marker && (marker & ~7) != 0xD0)
+                end_scan(p_jpeg, marker);
+        }
+    }
+}
+
+/* Section G.1.2.2: first scan of a band of AC coefficients */
+INLINE void decode_ac_first(struct jpeg *p_jpeg, struct derived_tbl *actbl,
+                            int16_t *blk, int t, int *eobrun)
+{
+    const signed char *slot = p_jpeg->coef_slot[t];
+    uint16_t *map = (uint16_t *)blk + p_jpeg->coef_count[t];
+    int k, s, r;
+
+    if (*eobrun)
+    {
+        (*eobrun)--;
+        return;
+    }
+    for (k = p_jpeg->scan_ss; k <= p_jpeg->scan_se; k++)
+    {
+        huff_decode_ac(p_jpeg, actbl, s);
+        r = s >> 4;
+        s &= 15;
+        if (s)
+        {
+            k += r;
+            check_bit_buffer(p_jpeg, s);
+            r = get_bits(p_jpeg, s);
+            r = HUFF_EXTEND(r, s);
+            if (k > 63)
+                break;
+            if (slot[k] >= 0)
+                blk[slot[k]] = r << p_jpeg->scan_al;
+            else
+                COEF_SET_NZ(map, k);
+        }
+        else
+        {
+            if (r != 15)
+            {   /* end of band for this and the next eobrun blocks */
+                *eobrun = BIT_N(r) - 1;
+                if (r)
+                {
+                    check_bit_buffer(p_jpeg, r);
+                    *eobrun += get_bits(p_jpeg, r);
+                }
+                break;
+            }
+            k += 15;
+        }
+    }
+}
+
+/* Read the correction bit for coefficient k if it is nonzero already,
+ * returning false if it is still zero.
+ */
+INLINE bool refine_coef(struct jpeg *p_jpeg, int16_t *blk, uint16_t *map,
+                        int slot, int k, int p1)
+{
+    if (slot >= 0)
+    {
+        int16_t *coef = blk + slot;
+        if (!*coef)
+            return false;
+        check_bit_buffer(p_jpeg, 1);
+        if (get_bits(p_jpeg, 1) && !(*coef & p1))
+            *coef += *coef >= 0 ? p1 : -p1;
+    } else {
+        if (!COEF_NZ(map, k))
+            return false;
+        check_bit_buffer(p_jpeg, 1);
+        drop_bits(p_jpeg, 1);
+    }
+    return true;
+}
+
+/* Section G.1.2.3: refinement of a band of AC coefficients */
+INLINE void decode_ac_refine(struct jpeg *p_jpeg, struct derived_tbl *actbl,
+                             int16_t *blk, int t, int *eobrun)
+{
+    const signed char *slot = p_jpeg->coef_slot[t];
+    uint16_t *map = (uint16_t *)blk + p_jpeg->coef_count[t];
+    int p1 = 1 << p_jpeg->scan_al;
+    int k = p_jpeg->scan_ss, se = p_jpeg->scan_se;
+    int s, r;
+
+    if (!*eobrun)
+    {
+        for (; k <= se; k++)
+        {
+            huff_decode_ac(p_jpeg, actbl, s);
+            r = s >> 4;
+            s &= 15;
+            if (s)
+            {   /* a coefficient becoming nonzero, its sign follows */
+                check_bit_buffer(p_jpeg, 1);
+                s = get_bits(p_jpeg, 1) ? p1 : -p1;
+            }
+            else if (r != 15)
+            {
+                *eobrun = BIT_N(r);
+                if (r)
+                {
+                    check_bit_buffer(p_jpeg, r);
+                    *eobrun += get_bits(p_jpeg, r);
+                }
+                break;
+            }
+            /* skip r coefficients that are still zero, refining the nonzero
+               ones on the way */
+            for (; k <= se; k++)
+            {
+                if (refine_coef(p_jpeg, blk, map, slot[k], k, p1))
+                    continue;
+                if (--r < 0)
+                    break;
+            }
+            if (s && k <= se)
+            {
+                if (slot[k] >= 0)
+                    blk[slot[k]] = s;
+                else
+                    COEF_SET_NZ(map, k);
+            }
+        }
+    }
+    if (*eobrun)
+    {   /* rest of the band only refines the nonzero coefficients */
+        for (; k <= se; k++)
+            refine_coef(p_jpeg, blk, map, slot[k], k, p1);
+        (*eobrun)--;
+    }
+}
+
+/* frame component index of a scan component, or -1 */
+static int scan_component(struct jpeg *p_jpeg, int id)
+{
+    int ci;
+
+    for (ci = 0; ci < (p_jpeg->blocks == 1 ? 1 : 3); ci++)
+        if (p_jpeg->frameheader[ci].ID == id)
+            return ci;
+    return -1;
+}
+
+/* Decode the scan whose header was just read into the coefficient store */
+static int decode_scan(struct jpeg *p_jpeg)
+{
+    int n = p_jpeg->scan_comps;
+    int ss = p_jpeg->scan_ss, se = p_jpeg->scan_se;
+    int ah = p_jpeg->scan_ah, al = p_jpeg->scan_al;
+    int comp[3], dc_pred[3] = { 0, 0, 0 };
+    int eobrun = 0, restart = p_jpeg->restart_interval;
+    int16_t unused = 0; /* DC of components that aren't kept */
+    int cols, rows;
+    int i, x, y;
+
+    for (i = 0; i < n; i++)
+    {
+        comp[i] = scan_component(p_jpeg, p_jpeg->scanheader[i].ID);
+        if (comp[i] < 0 || p_jpeg->scanheader[i].DC_select > 1 ||
+            p_jpeg->scanheader[i].AC_select > 1)
+            return -12; /* unknown component or table */
+    }
+    if (ss > se || se > 63 || (!ss && se) || (ss && n > 1) || al > 13)
+        return -13; /* bad spectral selection or successive approximation */
+    JDEBUGF("scan: %d components, band %d-%d, bit %d\n", n, ss, se, al);
+    if (ss && (!p_jpeg->coefs[comp[0]] || !p_jpeg->k_need[!!comp[0]]))
+    {   /* no coefficient in this scan is needed */
+        skip_scan(p_jpeg);
+        return 0;
+    }
+
+    p_jpeg->bitbuf_bits = 0;
+    p_jpeg->marker_val = 0;
+    p_jpeg->marker_ind = 0;
+    if (n == 1)
+    {   /* not interleaved: just the blocks covering the component */
+        struct frame_component *fc = &p_jpeg->frameheader[comp[0]];
+        int h_max = 8 * p_jpeg->frameheader[0].horizontal_sampling;
+        int v_max = 8 * p_jpeg->frameheader[0].vertical_sampling;
+        cols = (p_jpeg->x_size * fc->horizontal_sampling + h_max - 1) / h_max;
+        rows = (p_jpeg->y_size * fc->vertical_sampling + v_max - 1) / v_max;
+    } else {
+        cols = p_jpeg->x_mbl;
+        rows = p_jpeg->y_mbl;
+    }
+
+    for (y = 0; y < rows; y++)
+    {
+        for (x = 0; x < cols; x++)
+        {
+            for (i = 0; i < n; i++)
+            {
+                int ci = comp[i];
+                int hs = n > 1 ? p_jpeg->frameheader[ci].horizontal_sampling : 1;
+                int vs = n > 1 ? p_jpeg->frameheader[ci].vertical_sampling : 1;
+                int bx, by;
+                for (by = y * vs; by < (y + 1) * vs; by++)
+                for (bx = x * hs; bx < (x + 1) * hs; bx++)
+                {
+                    int16_t *blk = &unused;
+                    if (p_jpeg->coefs[ci])
+                        blk = p_jpeg->coefs[ci] + p_jpeg->coef_size[!!ci] *
+                            (by * p_jpeg->coef_stride[ci] + bx);
+                    if (ss)
+                    {
+                        struct derived_tbl *actbl =
+                            &p_jpeg->ac_derived_tbls[p_jpeg->scanheader[i].AC_select];
+                        if (ah)
+                            decode_ac_refine(p_jpeg, actbl, blk, !!ci, &eobrun);
+                        else
+                            decode_ac_first(p_jpeg, actbl, blk, !!ci, &eobrun);
+                    }
+                    else if (ah)
+                    {   /* Section G.1.2.1: DC refinement, one bit */
+                        check_bit_buffer(p_jpeg, 1);
+                        if (get_bits(p_jpeg, 1))
+                            blk[0] |= 1 << al;
+                    } else {
+                        struct derived_tbl *dctbl =
+                            &p_jpeg->dc_derived_tbls[p_jpeg->scanheader[i].DC_select];
+                        int s, r;
+                        huff_decode_dc(p_jpeg, dctbl, s, r);
+                        if (s)
+                            dc_pred[i] += HUFF_EXTEND(r, s);
+                        blk[0] = dc_pred[i] << al;
+                    }
+                }
+            }
+            if (restart && --restart == 0 && (x + 1 < cols || y + 1 < rows))
+            {   /* if a restart marker is due: */
+                restart = p_jpeg->restart_interval;
+                search_restart(p_jpeg);
+                dc_pred[0] = dc_pred[1] = dc_pred[2] = 0;
+                eobrun = 0;
+            }
+        }
+        /* don't starve other threads while a row of blocks decodes */
+        yield();
+    }
+    skip_scan(p_jpeg);
+    return 0;
+}
+
+/* Decode all scans of a progressive image, the first one's header having
+ * been read already.
+ */
+static int decode_progressive(struct jpeg *p_jpeg)
+{
+    int status;
+
+    do {
+        status = decode_scan(p_jpeg);
+        if (status < 0)
+            return status;
+        status = process_markers(p_jpeg);
+        if (status < 0)
+            return status;
+        if (status & DHT)
+            fix_huff_tables(p_jpeg);
+    } while (status & SOS);
+    return 0;
+}
+
+/* Fill in a block for the IDCT from the coefficient store */
+INLINE void load_coefs(struct jpeg *p_jpeg, int16_t *block, int ci,
+                       int bx, int by)
+{
+    int t = !!ci;
+    int16_t *blk = p_jpeg->coefs[ci] +
+        p_jpeg->coef_size[t] * (by * p_jpeg->coef_stride[ci] + bx);
+#ifdef JPEG_IDCT_TRANSPOSE
+    const unsigned char *zz = p_jpeg->v_scale[t] > 2 ? zag : zag + 64;
+#else
+    const unsigned char *zz = zag;
+#endif
+    int i;
+
+    block[0] = MULTIPLY16(blk[0], p_jpeg->quanttable[t][0]);
+    /* coefficient buffer must be cleared */
+    MEMSET(block+1, 0, p_jpeg->zero_need[t] * sizeof(int));
+    for (i = 1; i < p_jpeg->coef_count[t]; i++)
+    {
+        if (blk[i])
+        {
+            int k = p_jpeg->coef_zz[t][i];
+            block[zz[k]] = MULTIPLY16(blk[i], p_jpeg->quanttable[t][k]);
+        }
+    }
+}
+
 static struct img_part *store_row_jpeg(void *jpeg_args)
 {
     struct jpeg *p_jpeg = (struct jpeg*) jpeg_args;
@@ -1824,6 +2506,23 @@ static struct img_part *store_row_jpeg(void *jpeg_args)
                 struct derived_tbl* dctbl = &p_jpeg->dc_derived_tbls[ti];
                 struct derived_tbl* actbl = &p_jpeg->ac_derived_tbls[ti];
 
+                if (p_jpeg->progressive)
+                {   /* all scans are decoded already */
+#ifndef HAVE_LCD_COLOR
+                    if (!ci)
+#endif
+                    {
+                        int hs = p_jpeg->frameheader[0].horizontal_sampling;
+                        int vs = p_jpeg->frameheader[0].vertical_sampling;
+                        if (ci)
+                            load_coefs(p_jpeg, block, ci, x, p_jpeg->mcu_y);
+                        else
+                            load_coefs(p_jpeg, block, ci, x * hs + blkn % hs,
+                                       p_jpeg->mcu_y * vs + blkn / hs);
+                    }
+                    goto block_end;
+                }
+
                 /* Section F.2.2.1: decode the DC coefficient difference */
                 huff_decode_dc(p_jpeg, dctbl, s, r);
 
@@ -1938,6 +2637,8 @@ block_end:
             }
 #endif
             out += mcu_offset;
+            if (p_jpeg->progressive)
+                continue;
             if (p_jpeg->restart_interval && --p_jpeg->restart == 0)
             {   /* if a restart marker is due: */
                 p_jpeg->restart = p_jpeg->restart_interval; /* count again */
@@ -1950,6 +2651,7 @@ block_end:
 #endif
             }
         }
+        p_jpeg->mcu_y++;
     } /* if !p_jpeg->mcu_row */
     p_jpeg->mcu_row = (p_jpeg->mcu_row + 1) & (height - 1);
     p_jpeg->part.len = width;
@@ -2071,7 +2773,7 @@ int clip_jpeg_fd(int fd,
 #endif
     if (status < 0)
         return status;
-    if ((status & (DQT | SOF0)) != (DQT | SOF0))
+    if ((status & (DQT | SOF0 | SOS)) != (DQT | SOF0 | SOS))
         return -(status * 16);
     if (!(status & DHT)) /* if no Huffman table present: */
         default_huff_tbl(p_jpeg); /* use default */
@@ -2176,6 +2878,18 @@ int clip_jpeg_fd(int fd,
     buf_start += decode_buf_size;
     maxsize = buf_end - buf_start;
     memset(p_jpeg->img_buf, 0, decode_buf_size);
+    if (p_jpeg->progressive)
+    {
+        ALIGN_BUFFER(buf_start, maxsize, sizeof(uint32_t));
+        status = alloc_coefs(p_jpeg, (unsigned char *)buf_start, maxsize);
+        if (status < 0)
+            return -1;
+        buf_start += status;
+        maxsize = buf_end - buf_start;
+        status = decode_progressive(p_jpeg);
+        if (status < 0)
+            return status;
+    }
     p_jpeg->mcu_row = 0;
     p_jpeg->restart = p_jpeg->restart_interval;
     rset.rowstart = 0;
@@ -163,6 +163,9 @@ static size_t        num_rec_bytes;      /* Number of bytes recorded       */
 static uint64_t      num_rec_samples;    /* Number of PCM samples recorded */
 static uint64_t      encbuf_rec_count;   /* Count of slots written to buffer
                                             for current file               */
+static long          enc_stat_tick;      /* Tick of encoder's last PCM read */
+static unsigned long enc_busy_ticks;     /* Ticks the encoder spent busy   */
+static uint64_t      enc_busy_samples;   /* PCM samples consumed meanwhile */
 
 /** These apply to current settings **/
 static int           rec_source;         /* Current rec_source setting     */
@@ -585,6 +588,9 @@ static void reset_rec_stats(void)
     num_rec_bytes = 0;
     num_rec_samples = 0;
     encbuf_rec_count = 0;
+    enc_stat_tick = current_tick;
+    enc_busy_ticks = 0;
+    enc_busy_samples = 0;
     clear_warning_status(PCMREC_W_FILE_SIZE);
 }
 
@@ -1057,6 +1063,18 @@ unsigned long audio_num_recorded_bytes(void)
     return num_rec_bytes;
 }
 
+/* Return how many times faster than real time the encoder has been going
+   while it had PCM to work on, in tenths; 0 if not known yet */
+unsigned long audio_encoder_speed(void)
+{
+    if (record_state == REC_STATE_IDLE || enc_sample_rate == 0 ||
+        enc_busy_ticks == 0)
+        return 0;
+
+    return (unsigned long)(10*HZ*enc_busy_samples /
+                           ((uint64_t)enc_busy_ticks*enc_sample_rate));
+}
+
 
 /** Data Flushing **/
 
@@ -1811,6 +1829,15 @@ static int enc_pcmbuf_read(void *buffer, int count)
 {
     size_t avail = pcmbuf_used();
     size_t size = count*PCM_SAMP_SIZE;
+    long tick = current_tick;
+
+    /* Time since the last read counts as busy unless that one found the
+       buffer empty. Short busy spells catch a tick edge only now and then,
+       which averages out to the right total. */
+    if (!pcm_buffer_empty)
+        enc_busy_ticks += tick - enc_stat_tick;
+
+    enc_stat_tick = tick;
 
     if (count > 0 && avail >= size)
     {
@@ -1869,6 +1896,7 @@ static int enc_pcmbuf_advance(int count)
     }
 
     pcm_ridx = pcmbuf_add(pcm_ridx, size);
+    enc_busy_samples += count;
 
     return count;
 }
@@ -0,0 +1,925 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/*
+ * Streaming PNG loader for the core image path.
+ *
+ * The zlib stream is inflated straight from the file, one row at a time,
+ * through a window of the size the stream header asks for. Each row is
+ * unfiltered against the previous one, converted and handed to the scaler
+ * through the same store_part callback the JPEG and BMP loaders use, so a
+ * sequential image needs two source rows of scratch space on top of the
+ * window. Adam7 images can't be output before the last pass, so they are
+ * gathered into a buffer of the full source size and only load if that
+ * fits. Alpha and tRNS are ignored, images are always loaded opaque.
+ */
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "system.h"
+#include "kernel.h"
+#include "file.h"
+#include "debug.h"
+#include "png_load.h"
+/*#define ROCKBOX_DEBUG_PNG*/
+#ifdef ROCKBOX_DEBUG_PNG
+#define PDEBUGF DEBUGF
+#else
+#define PDEBUGF(...)
+#endif
+
+#ifdef HAVE_LCD_COLOR
+typedef struct uint8_rgb png_pix_t;
+#else
+typedef uint8_t png_pix_t;
+#endif
+
+#define PNG_READ_BUF_SIZE 512
+#define PNG_FAST_BITS 9 /* codes this short are decoded with a single lookup */
+#define PNG_MAX_DIM 32767
+
+#define CHUNK(a,b,c,d) (((uint32_t)(a) << 24) | ((b) << 16) | ((c) << 8) | (d))
+#define CHUNK_IHDR CHUNK('I','H','D','R')
+#define CHUNK_PLTE CHUNK('P','L','T','E')
+#define CHUNK_IDAT CHUNK('I','D','A','T')
+#define CHUNK_IEND CHUNK('I','E','N','D')
+
+enum {
+    PNG_GREY = 0,
+    PNG_RGB = 2,
+    PNG_PALETTE = 3,
+    PNG_GREY_ALPHA = 4,
+    PNG_RGBA = 6,
+};
+
+enum {
+    BLOCK_STORED = 0,
+    BLOCK_FIXED,
+    BLOCK_DYNAMIC,
+    BLOCK_NONE, /* between blocks */
+};
+
+/* canonical Huffman decoding table, codes are stored bit-reversed as they
+ * come out of the stream */
+struct png_huff
+{
+    uint16_t fast[1 << PNG_FAST_BITS]; /* (length << 9) | symbol, 0: longer */
+    uint16_t firstcode[16];
+    uint16_t firstsymbol[16];
+    int maxcode[17]; /* first code past each length, left-aligned to 16 bits */
+    uint8_t size[288];
+    uint16_t value[288];
+};
+
+struct png
+{
+    int fd;
+    unsigned long len; /* bytes of the blob not read from the file yet */
+    int buf_left;
+    int buf_index;
+    unsigned long chunk_left; /* bytes left in the current IDAT chunk */
+    bool idat_done;
+    int pad; /* zero bytes fed to the bit buffer past the end of the data */
+    uint32_t bitbuf;
+    int bitbuf_bits;
+    unsigned char *window;
+    unsigned int wmask;
+    unsigned int wpos;
+    unsigned int wfill; /* valid bytes in the window */
+    int block; /* type of the current deflate block */
+    bool final; /* current block is the last one */
+    unsigned int stored_left;
+    unsigned int copy_len; /* match bytes still to be copied */
+    unsigned int copy_dist;
+    struct png_huff lit;
+    struct png_huff dist;
+    int x_size, y_size;
+    int depth;
+    int color_type;
+    int interlace;
+    int bpp; /* bytes per complete pixel, at least 1, for the filters */
+    unsigned char *cur, *prev; /* current and previous unfiltered rows */
+    png_pix_t *pixels; /* output row, or the whole image for Adam7 */
+    int row;
+    struct img_part part;
+    struct uint8_rgb palette[256];
+    unsigned char buf[PNG_READ_BUF_SIZE];
+};
+
+static const unsigned char png_sig[8] = {
+    0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'
+};
+
+static const unsigned char png_channels[7] = { 1, 0, 3, 1, 2, 0, 4 };
+
+/* x0, y0, dx, dy of each Adam7 pass */
+static const unsigned char adam7[7][4] = {
+    { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 },
+    { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 },
+};
+
+static const unsigned char clen_order[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+static const uint16_t len_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+
+static const unsigned char len_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+
+static const uint16_t dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577
+};
+
+static const unsigned char dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+
+/* next byte of the blob, -1 at its end */
+static int png_getc(struct png *p)
+{
+    if (p->buf_left <= 0)
+    {
+        int n = MIN(p->len, sizeof(p->buf));
+        if (n <= 0)
+            return -1;
+        n = read(p->fd, p->buf, n);
+        if (n <= 0)
+            return -1;
+        p->len -= n;
+        p->buf_left = n;
+        p->buf_index = 0;
+    }
+    p->buf_left--;
+    return p->buf[p->buf_index++];
+}
+
+static bool png_read(struct png *p, unsigned char *dst, int n)
+{
+    int c;
+    while (n--)
+    {
+        if ((c = png_getc(p)) < 0)
+            return false;
+        *dst++ = c;
+    }
+    return true;
+}
+
+static bool png_skip(struct png *p, unsigned long n)
+{
+    unsigned long buffered = MIN(n, (unsigned long)p->buf_left);
+    p->buf_left -= buffered;
+    p->buf_index += buffered;
+    n -= buffered;
+    if (!n)
+        return true;
+    if (n > p->len || lseek(p->fd, n, SEEK_CUR) < 0)
+        return false;
+    p->len -= n;
+    return true;
+}
+
+static inline uint32_t get_be32(const unsigned char *b)
+{
+    return ((uint32_t)b[0] << 24) | (b[1] << 16) | (b[2] << 8) | b[3];
+}
+
+/* read the length and type of the next chunk */
+static bool next_chunk(struct png *p, uint32_t *length, uint32_t *type)
+{
+    unsigned char b[8];
+    if (!png_read(p, b, 8))
+        return false;
+    *length = get_be32(b);
+    *type = get_be32(b + 4);
+    return *length <= 0x7fffffff;
+}
+
+/* Read the signature and all chunks up to the first IDAT, leaving the file
+ * at the start of its data */
+static int read_headers(struct png *p)
+{
+    unsigned char b[13];
+    uint32_t length, type;
+    int i;
+
+    if (!png_read(p, b, 8) || memcmp(b, png_sig, 8))
+        return -2;
+    if (!next_chunk(p, &length, &type) || type != CHUNK_IHDR || length != 13
+        || !png_read(p, b, 13) || !png_skip(p, 4))
+        return -3;
+    p->x_size = get_be32(b);
+    p->y_size = get_be32(b + 4);
+    p->depth = b[8];
+    p->color_type = b[9];
+    p->interlace = b[12];
+    if (p->x_size < 1 || p->x_size > PNG_MAX_DIM ||
+        p->y_size < 1 || p->y_size > PNG_MAX_DIM)
+        return -3;
+    switch (p->color_type)
+    {
+        case PNG_GREY:
+            if (p->depth == 1 || p->depth == 2 || p->depth == 4)
+                break;
+            /* fall through */
+        case PNG_RGB:
+        case PNG_GREY_ALPHA:
+        case PNG_RGBA:
+            if (p->depth != 8 && p->depth != 16)
+                return -4;
+            break;
+        case PNG_PALETTE:
+            if (p->depth != 1 && p->depth != 2 && p->depth != 4 &&
+                p->depth != 8)
+                return -4;
+            break;
+        default:
+            return -4;
+    }
+    /* only deflate, adaptive filtering and Adam7 are defined */
+    if (b[10] || b[11] || p->interlace > 1)
+        return -4;
+    p->bpp = (png_channels[p->color_type] * p->depth + 7) >> 3;
+
+    while (1)
+    {
+        if (!next_chunk(p, &length, &type))
+            return -7;
+        if (type == CHUNK_IDAT)
+            break;
+        if (type == CHUNK_IEND)
+            return -7;
+        if (type == CHUNK_PLTE && p->color_type == PNG_PALETTE)
+        {
+            if (length % 3 || length > 3 * 256)
+                return -3;
+            for (i = 0; i < (int)length / 3; i++)
+            {
+                if (!png_read(p, b, 3))
+                    return -7;
+                p->palette[i].red = b[0];
+                p->palette[i].green = b[1];
+                p->palette[i].blue = b[2];
+            }
+            length = 0;
+        }
+        /* skip the rest of the chunk and its CRC */
+        if (!png_skip(p, length + 4UL))
+            return -7;
+    }
+    p->chunk_left = length;
+    return 0;
+}
+
+/* next byte of the zlib stream, which may be split across IDAT chunks */
+static int zlib_getc(struct png *p)
+{
+    uint32_t length, type;
+    int c;
+    while (!p->chunk_left)
+    {
+        if (p->idat_done || !png_skip(p, 4) ||
+            !next_chunk(p, &length, &type) || type != CHUNK_IDAT)
+        {
+            p->idat_done = true;
+            return -1;
+        }
+        p->chunk_left = length;
+    }
+    if ((c = png_getc(p)) < 0)
+    {
+        p->idat_done = true;
+        return -1;
+    }
+    p->chunk_left--;
+    return c;
+}
+
+static void fill_bits(struct png *p)
+{
+    int c;
+    while (p->bitbuf_bits <= 24)
+    {
+        if ((c = zlib_getc(p)) < 0)
+        {
+            /* feed zeros, data_ended() tells whether any got used */
+            c = 0;
+            p->pad++;
+        }
+        p->bitbuf |= (uint32_t)c << p->bitbuf_bits;
+        p->bitbuf_bits += 8;
+    }
+}
+
+static inline bool data_ended(struct png *p)
+{
+    return p->pad * 8 > p->bitbuf_bits;
+}
+
+/* get n <= 16 bits from the stream */
+static inline unsigned int get_bits(struct png *p, int n)
+{
+    unsigned int v;
+    if (p->bitbuf_bits < n)
+        fill_bits(p);
+    v = p->bitbuf & ((1U << n) - 1);
+    p->bitbuf >>= n;
+    p->bitbuf_bits -= n;
+    return v;
+}
+
+static unsigned int bit_reverse16(unsigned int v)
+{
+    v = ((v & 0xaaaa) >> 1) | ((v & 0x5555) << 1);
+    v = ((v & 0xcccc) >> 2) | ((v & 0x3333) << 2);
+    v = ((v & 0xf0f0) >> 4) | ((v & 0x0f0f) << 4);
+    v = ((v & 0xff00) >> 8) | ((v & 0x00ff) << 8);
+    return v;
+}
+
+/* build a decoding table from a list of code lengths, false if the lengths
+ * don't describe a valid prefix code */
+static bool build_huff(struct png_huff *h, const uint8_t *lens, int num)
+{
+    int i, k = 0, code = 0;
+    int next_code[16], sizes[17];
+
+    memset(sizes, 0, sizeof(sizes));
+    memset(h->fast, 0, sizeof(h->fast));
+    for (i = 0; i < num; i++)
+        sizes[lens[i]]++;
+    sizes[0] = 0;
+    for (i = 1; i < 16; i++)
+    {
+        next_code[i] = code;
+        h->firstcode[i] = code;
+        h->firstsymbol[i] = k;
+        code += sizes[i];
+        if (code > (1 << i))
+            return false;
+        h->maxcode[i] = code << (16 - i);
+        code <<= 1;
+        k += sizes[i];
+    }
+    h->maxcode[16] = 0x10000;
+    for (i = 0; i < num; i++)
+    {
+        int s = lens[i];
+        if (!s)
+            continue;
+        int c = next_code[s] - h->firstcode[s] + h->firstsymbol[s];
+        h->size[c] = s;
+        h->value[c] = i;
+        if (s <= PNG_FAST_BITS)
+        {
+            int j = bit_reverse16(next_code[s]) >> (16 - s);
+            for (; j < (1 << PNG_FAST_BITS); j += 1 << s)
+                h->fast[j] = (s << 9) | i;
+        }
+        next_code[s]++;
+    }
+    return true;
+}
+
+/* decode one symbol, -1 for a code that isn't in the table */
+static int huff_decode(struct png *p, const struct png_huff *h)
+{
+    int b, s, k;
+    if (p->bitbuf_bits < 16)
+        fill_bits(p);
+    b = h->fast[p->bitbuf & ((1 << PNG_FAST_BITS) - 1)];
+    if (b)
+    {
+        s = b >> 9;
+        p->bitbuf >>= s;
+        p->bitbuf_bits -= s;
+        return b & 511;
+    }
+    k = bit_reverse16(p->bitbuf & 0xffff);
+    for (s = PNG_FAST_BITS + 1; k >= h->maxcode[s]; s++);
+    if (s >= 16)
+        return -1;
+    b = (k >> (16 - s)) - h->firstcode[s] + h->firstsymbol[s];
+    if (b >= 288 || h->size[b] != s)
+        return -1;
+    p->bitbuf >>= s;
+    p->bitbuf_bits -= s;
+    return h->value[b];
+}
+
+static bool read_dynamic_tables(struct png *p)
+{
+    uint8_t lens[288 + 32];
+    int hlit = get_bits(p, 5) + 257;
+    int hdist = get_bits(p, 5) + 1;
+    int hclen = get_bits(p, 4) + 4;
+    int i, n, c, rep;
+
+    memset(lens, 0, 19);
+    for (i = 0; i < hclen; i++)
+        lens[clen_order[i]] = get_bits(p, 3);
+    /* the code length code is only needed until the real tables are built */
+    if (!build_huff(&p->dist, lens, 19))
+        return false;
+    for (n = 0; n < hlit + hdist; n += rep)
+    {
+        c = huff_decode(p, &p->dist);
+        if (c < 0)
+            return false;
+        if (c < 16)
+        {
+            lens[n] = c;
+            rep = 1;
+            continue;
+        }
+        if (c == 16)
+        {
+            if (!n)
+                return false;
+            c = lens[n - 1];
+            rep = 3 + get_bits(p, 2);
+        }
+        else if (c == 17)
+        {
+            c = 0;
+            rep = 3 + get_bits(p, 3);
+        }
+        else
+        {
+            c = 0;
+            rep = 11 + get_bits(p, 7);
+        }
+        if (n + rep > hlit + hdist)
+            return false;
+        memset(lens + n, c, rep);
+    }
+    if (data_ended(p) || !lens[256])
+        return false;
+    return build_huff(&p->lit, lens, hlit) &&
+           build_huff(&p->dist, lens + hlit, hdist);
+}
+
+static bool start_block(struct png *p)
+{
+    uint8_t lens[288];
+    if (p->final || data_ended(p))
+        return false;
+    p->final = get_bits(p, 1);
+    p->block = get_bits(p, 2);
+    switch (p->block)
+    {
+        case BLOCK_STORED:
+        {
+            unsigned int len, nlen;
+            /* drop the bits up to the next byte boundary */
+            get_bits(p, p->bitbuf_bits & 7);
+            len = get_bits(p, 16);
+            nlen = get_bits(p, 16);
+            if ((len ^ nlen) != 0xffff)
+                return false;
+            p->stored_left = len;
+            if (!len)
+                p->block = BLOCK_NONE;
+            return true;
+        }
+        case BLOCK_FIXED:
+            memset(lens, 8, 144);
+            memset(lens + 144, 9, 112);
+            memset(lens + 256, 7, 24);
+            memset(lens + 280, 8, 8);
+            build_huff(&p->lit, lens, 288);
+            memset(lens, 5, 30);
+            build_huff(&p->dist, lens, 30);
+            return true;
+        case BLOCK_DYNAMIC:
+            return read_dynamic_tables(p);
+        default:
+            return false;
+    }
+}
+
+static inline void put_byte(struct png *p, unsigned char c)
+{
+    p->window[p->wpos] = c;
+    p->wpos = (p->wpos + 1) & p->wmask;
+}
+
+/* Inflate the next len bytes of the image data into dst, picking up where
+ * the last call stopped. Returns false if the stream is corrupt or ends
+ * early. */
+static bool inflate_bytes(struct png *p, unsigned char *dst, int len)
+{
+    unsigned char *end = dst + len;
+    unsigned char c;
+    int sym;
+
+    while (dst < end)
+    {
+        if (p->copy_len)
+        {
+            unsigned int n = MIN(p->copy_len, (unsigned int)(end - dst));
+            unsigned int src = p->wpos - p->copy_dist;
+            p->copy_len -= n;
+            while (n--)
+            {
+                c = p->window[src++ & p->wmask];
+                put_byte(p, c);
+                *dst++ = c;
+            }
+            continue;
+        }
+        if (p->block == BLOCK_NONE)
+        {
+            if (!start_block(p))
+                return false;
+            continue;
+        }
+        if (p->block == BLOCK_STORED)
+        {
+            c = get_bits(p, 8);
+            put_byte(p, c);
+            *dst++ = c;
+            if (p->wfill <= p->wmask)
+                p->wfill++;
+            if (!--p->stored_left)
+                p->block = BLOCK_NONE;
+            continue;
+        }
+        sym = huff_decode(p, &p->lit);
+        if (sym < 256)
+        {
+            if (sym < 0)
+                return false;
+            put_byte(p, sym);
+            *dst++ = sym;
+            if (p->wfill <= p->wmask)
+                p->wfill++;
+        }
+        else if (sym == 256)
+            p->block = BLOCK_NONE;
+        else
+        {
+            sym -= 257;
+            if (sym >= 29)
+                return false;
+            p->copy_len = len_base[sym] + get_bits(p, len_extra[sym]);
+            sym = huff_decode(p, &p->dist);
+            if (sym < 0 || sym >= 30)
+                return false;
+            p->copy_dist = dist_base[sym] + get_bits(p, dist_extra[sym]);
+            if (p->copy_dist > p->wfill)
+                return false;
+            p->wfill = MIN(p->wfill + p->copy_len, p->wmask + 1);
+        }
+    }
+    return !data_ended(p);
+}
+
+/* check the zlib header and set up the window it asks for */
+static int start_zlib(struct png *p, unsigned char *buf, int len)
+{
+    int cmf = get_bits(p, 8);
+    int flg = get_bits(p, 8);
+    unsigned int wsize = 1U << ((cmf >> 4) + 8);
+    if (data_ended(p) || (cmf & 0x0f) != 8 || (cmf >> 4) > 7 ||
+        ((cmf << 8) | flg) % 31 || (flg & 0x20))
+        return -5;
+    if ((unsigned int)len < wsize)
+        return -1;
+    p->window = buf;
+    p->wmask = wsize - 1;
+    p->block = BLOCK_NONE;
+    return wsize;
+}
+
+static inline int paeth(int a, int b, int c)
+{
+    int pa = abs(b - c);
+    int pb = abs(a - c);
+    int pc = abs(a + b - 2 * c);
+    if (pa <= pb && pa <= pc)
+        return a;
+    return pb <= pc ? b : c;
+}
+
+static bool unfilter_row(struct png *p, int filter, int len)
+{
+    unsigned char *cur = p->cur, *prev = p->prev;
+    int bpp = p->bpp, i;
+    switch (filter)
+    {
+        case 0:
+            break;
+        case 1:
+            for (i = bpp; i < len; i++)
+                cur[i] += cur[i - bpp];
+            break;
+        case 2:
+            for (i = 0; i < len; i++)
+                cur[i] += prev[i];
+            break;
+        case 3:
+            for (i = 0; i < bpp; i++)
+                cur[i] += prev[i] >> 1;
+            for (; i < len; i++)
+                cur[i] += (cur[i - bpp] + prev[i]) >> 1;
+            break;
+        case 4:
+            for (i = 0; i < bpp; i++)
+                cur[i] += prev[i];
+            for (; i < len; i++)
+                cur[i] += paeth(cur[i - bpp], prev[i], prev[i - bpp]);
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+
+/* convert width unfiltered pixels from cur to every step'th entry of out */
+static void convert_row(struct png *p, png_pix_t *out, int width, int step)
+{
+    const unsigned char *src = p->cur;
+    const int depth = p->depth;
+    /* distance between samples, 16 bit samples use their high byte */
+    const int ss = depth >> 3;
+    png_pix_t *end = out + width * step;
+    struct uint8_rgb px;
+    int shift = 8;
+
+    for (; out < end; out += step)
+    {
+        if (depth < 8)
+        {
+            unsigned int v;
+            shift -= depth;
+            v = (*src >> shift) & ((1 << depth) - 1);
+            if (!shift)
+            {
+                src++;
+                shift = 8;
+            }
+            if (p->color_type == PNG_PALETTE)
+                px = p->palette[v];
+            else
+                px.red = px.green = px.blue = v * (255 / ((1 << depth) - 1));
+        }
+        else
+        {
+            switch (p->color_type)
+            {
+                case PNG_PALETTE:
+                    px = p->palette[*src];
+                    break;
+                case PNG_GREY:
+                case PNG_GREY_ALPHA:
+                    px.red = px.green = px.blue = *src;
+                    break;
+                default:
+                    px.red = src[0];
+                    px.green = src[ss];
+                    px.blue = src[2 * ss];
+                    break;
+            }
+            src += p->bpp;
+        }
+#ifdef HAVE_LCD_COLOR
+        px.alpha = 0xff;
+        *out = px;
+#else
+        *out = brightness(px);
+#endif
+    }
+}
+
+static inline int row_bytes(struct png *p, int width)
+{
+    return (width * png_channels[p->color_type] * p->depth + 7) >> 3;
+}
+
+/* inflate, unfilter and convert one row of width pixels */
+static bool decode_row(struct png *p, png_pix_t *out, int width, int step)
+{
+    unsigned char filter;
+    unsigned char *tmp;
+    int len = row_bytes(p, width);
+
+    if (!inflate_bytes(p, &filter, 1) || !inflate_bytes(p, p->cur, len) ||
+        !unfilter_row(p, filter, len))
+        return false;
+    convert_row(p, out, width, step);
+    tmp = p->prev;
+    p->prev = p->cur;
+    p->cur = tmp;
+    return true;
+}
+
+/* decode all seven passes of an interlaced image into p->pixels */
+static bool decode_adam7(struct png *p)
+{
+    int pass, y;
+    for (pass = 0; pass < 7; pass++)
+    {
+        int x0 = adam7[pass][0], y0 = adam7[pass][1];
+        int dx = adam7[pass][2], dy = adam7[pass][3];
+        int w = (p->x_size - x0 + dx - 1) / dx;
+        int h = (p->y_size - y0 + dy - 1) / dy;
+        /* empty passes have no rows at all, not even filter bytes */
+        if (w <= 0 || h <= 0)
+            continue;
+        memset(p->prev, 0, row_bytes(p, w));
+        for (y = 0; y < h; y++)
+        {
+            if (!decode_row(p, p->pixels + (y0 + y * dy) * p->x_size + x0,
+                            w, dx))
+                return false;
+            if (!(y & 15))
+                yield();
+        }
+    }
+    return true;
+}
+
+static struct img_part *store_row_png(void *png_args)
+{
+    struct png *p = (struct png *)png_args;
+    if (p->row >= p->y_size)
+        return NULL;
+    if (p->interlace)
+        p->part.buf = p->pixels + p->row * p->x_size;
+    else
+    {
+        if (!decode_row(p, p->pixels, p->x_size, 1))
+            return NULL;
+        p->part.buf = p->pixels;
+        if (!(p->row & 15))
+            yield();
+    }
+    p->row++;
+    p->part.len = p->x_size;
+    return &p->part;
+}
+
+int clip_png_fd(int fd,
+                unsigned long len,
+                struct bitmap *bm,
+                int maxsize,
+                int format,
+                const struct custom_format *cformat)
+{
+    bool resize = false, dither = false;
+    struct rowset rset;
+    struct dim src_dim;
+    int status;
+    int bm_size;
+    struct png *p = (struct png *)bm->data;
+    int tmp_size = maxsize;
+    ALIGN_BUFFER(p, tmp_size, sizeof(long));
+    /* not enough memory for our struct png */
+    if ((size_t)tmp_size < sizeof(struct png))
+        return -1;
+    memset(p, 0, sizeof(struct png));
+    p->fd = fd;
+    p->len = len;
+    if (p->len == 0)
+        p->len = filesize(fd);
+    status = read_headers(p);
+    if (status < 0)
+        return status;
+    src_dim.width = p->x_size;
+    src_dim.height = p->y_size;
+    if (format & FORMAT_RESIZE)
+        resize = true;
+    if (format & FORMAT_DITHER)
+        dither = true;
+#ifdef HAVE_LCD_COLOR
+    bm->alpha_offset = 0; /* no alpha channel */
+#endif
+    if (resize) {
+        struct dim resize_dim = {
+            .width = bm->width,
+            .height = bm->height,
+        };
+        if (format & FORMAT_KEEP_ASPECT)
+            recalc_dimension(&resize_dim, &src_dim);
+        bm->width = resize_dim.width;
+        bm->height = resize_dim.height;
+        if (bm->width == p->x_size && bm->height == p->y_size)
+            resize = false;
+    } else {
+        bm->width = p->x_size;
+        bm->height = p->y_size;
+    }
+    PDEBUGF("png: %dx%d type %d depth %d%s -> %dx%d\n", p->x_size,
+        p->y_size, p->color_type, p->depth, p->interlace ? " interlaced" : "",
+        bm->width, bm->height);
+    if (cformat)
+        bm_size = cformat->get_size(bm);
+    else
+        bm_size = BM_SIZE(bm->width,bm->height,FORMAT_NATIVE,false);
+    if (bm_size > maxsize)
+        return -1;
+    char *buf_start = (char *)bm->data + bm_size;
+    char *buf_end = (char *)bm->data + maxsize;
+    maxsize = buf_end - buf_start;
+    ALIGN_BUFFER(buf_start, maxsize, sizeof(long));
+    if (maxsize < (int)sizeof(struct png))
+        return -1;
+    memmove(buf_start, p, sizeof(struct png));
+    p = (struct png *)buf_start;
+    buf_start += sizeof(struct png);
+    maxsize = buf_end - buf_start;
+    status = start_zlib(p, (unsigned char *)buf_start, maxsize);
+    if (status < 0)
+        return status;
+    buf_start += status;
+    /* two rows for unfiltering, and converted pixels */
+    int rb = row_bytes(p, p->x_size);
+    int pix_size = p->x_size * sizeof(png_pix_t);
+    if (buf_end - buf_start < 2 * rb + pix_size)
+        return -1;
+    if (p->interlace)
+    {
+        if ((buf_end - buf_start - 2 * rb) / pix_size < p->y_size)
+            return -1;
+        pix_size *= p->y_size;
+    }
+    p->cur = (unsigned char *)buf_start;
+    p->prev = p->cur + rb;
+    p->pixels = (png_pix_t *)(p->prev + rb);
+    /* the row above the first one is all zeros for unfiltering */
+    memset(p->prev, 0, rb);
+    buf_start = (char *)(p->pixels) + pix_size;
+    maxsize = buf_end - buf_start;
+    if (p->interlace && !decode_adam7(p))
+        return -6;
+    p->row = 0;
+    rset.rowstart = 0;
+    rset.rowstop = bm->height;
+    rset.rowstep = 1;
+    if (resize)
+    {
+        if (resize_on_load(bm, dither, &src_dim, &rset,
+                           (unsigned char *)buf_start, maxsize, cformat,
+                           IF_PIX_FMT(0,) store_row_png, p))
+            return bm_size;
+    } else {
+        int row;
+        struct scaler_context ctx = {
+            .bm = bm,
+            .dither = dither,
+        };
+        void (*output_row_8)(uint32_t, void*, struct scaler_context*) =
+            output_row_8_native;
+        if (cformat)
+            output_row_8 = cformat->output_row_8;
+        struct img_part *part;
+        for (row = 0; row < bm->height; row++)
+        {
+            part = store_row_png(p);
+            if (!part)
+                return -6;
+            output_row_8(row, part->buf, &ctx);
+        }
+        return bm_size;
+    }
+    return 0;
+}
+
+int read_png_fd(int fd,
+                struct bitmap *bm,
+                int maxsize,
+                int format,
+                const struct custom_format *cformat)
+{
+    return clip_png_fd(fd, 0, bm, maxsize, format, cformat);
+}
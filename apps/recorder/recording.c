@@ -1734,6 +1734,15 @@ bool recording_screen(bool no_source)
                     output_dyn_value(buf2, sizeof buf2,
                                      num_recorded_bytes,
                                      byte_units, 4, true);
+#if CONFIG_CODEC == SWCODEC
+                    /* Encoder throughput as a multiple of real time */
+                    unsigned long speed = audio_encoder_speed();
+                    if (speed)
+                        snprintf(buf, sizeof(buf), "%s %s  %lu.%lux",
+                                 str(LANG_RECORDING_SIZE), buf2,
+                                 speed / 10, speed % 10);
+                    else
+#endif /* CONFIG_CODEC == SWCODEC */
                     snprintf(buf, sizeof(buf), "%s %s",
                              str(LANG_RECORDING_SIZE), buf2);
                 }
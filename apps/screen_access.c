@@ -287,6 +287,10 @@ struct screen screens[NB_SCREENS] =
 #endif
 #endif
         .put_line = screen_helper_put_line,
+#if defined(HAVE_LCD_BITMAP)
+        .damage_viewport_rect = &lcd_damage_viewport_rect,
+        .update_damage = &lcd_update_damage,
+#endif
     },
 #if NB_SCREENS == 2
     {
@@ -381,6 +385,8 @@ struct screen screens[NB_SCREENS] =
         .set_framebuffer = (void*)lcd_remote_set_framebuffer,
 #endif
         .put_line = screen_helper_remote_put_line,
+        .damage_viewport_rect = &lcd_remote_damage_viewport_rect,
+        .update_damage = &lcd_remote_update_damage,
     }
 #endif /* NB_SCREENS == 2 */
 };
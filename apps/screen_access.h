@@ -161,6 +161,10 @@ struct screen
                                 int width, int height);
 #endif
     void (*put_line)(int x, int y, struct line_desc *line, const char *fmt, ...);
+#if defined(HAVE_LCD_BITMAP)
+    void (*damage_viewport_rect)(int x, int y, int width, int height);
+    unsigned long (*update_damage)(void);
+#endif
 };
 
 #if defined(HAVE_LCD_BITMAP) || defined(HAVE_REMOTE_LCD)
@@ -0,0 +1,409 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "config.h"
+#include "system.h"
+#include "kernel.h"
+#include "thread.h"
+#include "usb.h"
+#include "string-extra.h"
+#include "file.h"
+#include "dir.h"
+#include "crc32.h"
+#include "metadata.h"
+#include "mp3data.h"
+#include "logf.h"
+#include "seek_index.h"
+
+#define SEEK_INDEX_DIR        ROCKBOX_DIR "/seekindex"
+#define SEEK_INDEX_FILE       SEEK_INDEX_DIR "/%08lx.idx"
+#define SEEK_INDEX_MAGIC      0x53494458 /* SIDX */
+#define SEEK_INDEX_MAX_FILES  256
+#define SEEK_INDEX_SCAN_BUF   4096
+/* Points kept for one track, 4 bytes each. With SEEK_INDEX_MAX_FPP this
+   covers about 1.9h, 57min, 28min or 14min of 44.1kHz audio */
+#if MEMORYSIZE >= 64
+#define SEEK_INDEX_MAX_POINTS 8192
+#elif MEMORYSIZE >= 16
+#define SEEK_INDEX_MAX_POINTS 4096
+#elif MEMORYSIZE >= 8
+#define SEEK_INDEX_MAX_POINTS 2048
+#else
+#define SEEK_INDEX_MAX_POINTS 1024
+#endif
+
+struct seek_index_header
+{
+    uint32_t magic;
+    uint32_t path_crc;
+    uint32_t filesize;           /* Audio data size as in mp3entry */
+    uint32_t first_frame_offset;
+    uint32_t frame_samples;      /* Samples per MPEG frame */
+    uint32_t frames_per_point;   /* Frames between two index points */
+    uint32_t count;              /* Number of uint32_t offsets that follow */
+};
+
+/* What identifies a track's index */
+struct seek_index_key
+{
+    unsigned long crc;
+    unsigned long filesize;
+    unsigned long first_frame_offset;
+};
+
+/* The table and scan buffer are static so that nothing here ever allocates;
+   lookups come from the codec thread, which mustn't end up in buflib. */
+static uint32_t seek_index_points[SEEK_INDEX_MAX_POINTS];
+static unsigned char seek_index_scan_buf[SEEK_INDEX_SCAN_BUF];
+
+/* state_mutex is only ever held briefly and guards 'loaded' and the
+   request; table_mutex is held while the table is loaded or scanned into.
+   'loaded' describes the table and is cleared while the table is being
+   changed, so a lookup never has to wait for disk IO. */
+static struct mutex state_mutex SHAREDBSS_ATTR;
+static struct mutex table_mutex SHAREDBSS_ATTR;
+static struct seek_index_header loaded;
+
+/* The track the worker should get an index ready for, and the last one
+   it couldn't index so that seeks in it don't keep asking */
+static struct
+{
+    bool pending;
+    struct seek_index_key key;
+    char path[MAX_PATH];
+} request;
+static struct seek_index_key failed;
+
+static struct event_queue seek_index_queue SHAREDBSS_ATTR;
+static long seek_index_stack[(DEFAULT_STACK_SIZE + 0x800)/sizeof(long)];
+static const char seek_index_thread_name[] = "seek index";
+
+#define Q_SEEK_INDEX_PREPARE 1
+
+static void make_key(const char *path, const struct mp3entry *id3,
+                     struct seek_index_key *key)
+{
+    key->crc = crc_32(path, strlen(path), 0xffffffff);
+    key->filesize = id3->filesize;
+    key->first_frame_offset = id3->first_frame_offset;
+}
+
+static void index_file_name(char *buf, size_t size, unsigned long crc)
+{
+    snprintf(buf, size, SEEK_INDEX_FILE, crc);
+}
+
+bool seek_index_wanted(const struct mp3entry *id3)
+{
+    return id3->codectype >= AFMT_MPA_L1 && id3->codectype <= AFMT_MPA_L3 &&
+           id3->vbr && !id3->has_toc;
+}
+
+static bool header_matches(const struct seek_index_header *hdr,
+                           const struct seek_index_key *key)
+{
+    return hdr->magic == SEEK_INDEX_MAGIC &&
+           hdr->path_crc == key->crc &&
+           hdr->filesize == key->filesize &&
+           hdr->first_frame_offset == key->first_frame_offset &&
+           hdr->frame_samples > 0 && hdr->frames_per_point > 0 &&
+           hdr->frames_per_point <= SEEK_INDEX_MAX_FPP &&
+           hdr->count > 0 && hdr->count <= SEEK_INDEX_MAX_POINTS;
+}
+
+static bool table_matches(const struct seek_index_key *key)
+{
+    mutex_lock(&state_mutex);
+    bool match = header_matches(&loaded, key);
+    mutex_unlock(&state_mutex);
+    return match;
+}
+
+static void set_loaded(const struct seek_index_header *hdr)
+{
+    mutex_lock(&state_mutex);
+    if (hdr)
+        loaded = *hdr;
+    else
+        loaded.magic = 0;
+    mutex_unlock(&state_mutex);
+}
+
+/* Read the index file's header, and the points into the table if 'points'.
+   Call with table_mutex held. */
+static bool read_index(const struct seek_index_key *key, bool points)
+{
+    struct seek_index_header hdr;
+    char name[MAX_PATH];
+    bool ok;
+
+    index_file_name(name, sizeof(name), key->crc);
+
+    int fd = open(name, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    ok = read(fd, &hdr, sizeof(hdr)) == (ssize_t)sizeof(hdr) &&
+         header_matches(&hdr, key);
+
+    if (ok && points)
+    {
+        size_t len = hdr.count*sizeof(uint32_t);
+
+        set_loaded(NULL);
+        ok = read(fd, seek_index_points, len) == (ssize_t)len;
+        if (ok)
+            set_loaded(&hdr);
+    }
+
+    close(fd);
+    return ok;
+}
+
+/* Keep the cache to SEEK_INDEX_MAX_FILES, dropping the oldest first */
+static void seek_index_prune(void)
+{
+    char name[MAX_PATH];
+
+    while (1)
+    {
+        struct dirent *entry;
+        uint32_t oldest_time = 0;
+        int count = 0;
+        DIR *dir = opendir(SEEK_INDEX_DIR);
+
+        if (!dir)
+            return;
+
+        name[0] = '\0';
+        while ((entry = readdir(dir)))
+        {
+            struct dirinfo info = dir_get_info(dir, entry);
+            if (info.attribute & ATTR_DIRECTORY)
+                continue;
+            if (!count++ || (uint32_t)info.mtime < oldest_time)
+            {
+                oldest_time = info.mtime;
+                snprintf(name, sizeof(name), SEEK_INDEX_DIR "/%s",
+                         entry->d_name);
+            }
+        }
+        closedir(dir);
+
+        if (count < SEEK_INDEX_MAX_FILES || remove(name) < 0)
+            return;
+    }
+}
+
+/* Scan the track into the table and write its index file. Call with
+   table_mutex held. */
+static bool build_index(const char *path, const struct seek_index_key *key)
+{
+    struct seek_index_header hdr;
+    char name[MAX_PATH];
+    int frames_per_point = 1, frame_samples = 0;
+    int fd, count;
+    bool ok = false;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    set_loaded(NULL);
+    count = build_mp3_seek_index(fd, key->first_frame_offset, key->filesize,
+                                 seek_index_scan_buf, SEEK_INDEX_SCAN_BUF,
+                                 seek_index_points, SEEK_INDEX_MAX_POINTS,
+                                 SEEK_INDEX_MAX_FPP, &frames_per_point,
+                                 &frame_samples);
+    close(fd);
+
+    if (count <= 0 || frame_samples <= 0)
+        return false;
+
+    hdr.magic = SEEK_INDEX_MAGIC;
+    hdr.path_crc = key->crc;
+    hdr.filesize = key->filesize;
+    hdr.first_frame_offset = key->first_frame_offset;
+    hdr.frame_samples = frame_samples;
+    hdr.frames_per_point = frames_per_point;
+    hdr.count = count;
+
+    /* The table is good whether or not it can be stored */
+    set_loaded(&hdr);
+
+    seek_index_prune();
+    index_file_name(name, sizeof(name), key->crc);
+
+    fd = open(name, O_WRONLY|O_CREAT|O_TRUNC, 0666);
+    if (fd < 0 && mkdir(SEEK_INDEX_DIR) == 0)
+        fd = open(name, O_WRONLY|O_CREAT|O_TRUNC, 0666);
+    if (fd >= 0)
+    {
+        size_t len = count*sizeof(uint32_t);
+        ok = write(fd, &hdr, sizeof(hdr)) == (ssize_t)sizeof(hdr) &&
+             write(fd, seek_index_points, len) == (ssize_t)len;
+        close(fd);
+
+        if (!ok)
+            remove(name);
+    }
+
+    logf("seek index: %s: %d points, ok=%d", path, count, ok);
+    return true;
+}
+
+void seek_index_build(const char *path, const struct mp3entry *id3)
+{
+    struct seek_index_key key;
+
+    if (!seek_index_wanted(id3))
+        return;
+
+    make_key(path, id3, &key);
+
+    mutex_lock(&table_mutex);
+
+    /* Keep an index that's still valid */
+    if (!read_index(&key, false))
+        build_index(path, &key);
+
+    mutex_unlock(&table_mutex);
+}
+
+void seek_index_prepare(const struct mp3entry *id3)
+{
+    struct seek_index_key key;
+
+    if (!seek_index_wanted(id3))
+        return;
+
+    make_key(id3->path, id3, &key);
+
+    mutex_lock(&state_mutex);
+
+    if (!header_matches(&loaded, &key) &&
+        memcmp(&failed, &key, sizeof(key)) &&
+        (!request.pending || memcmp(&request.key, &key, sizeof(key))))
+    {
+        request.key = key;
+        strlcpy(request.path, id3->path, sizeof(request.path));
+
+        if (!request.pending)
+        {
+            request.pending = true;
+            queue_post(&seek_index_queue, Q_SEEK_INDEX_PREPARE, 0);
+        }
+    }
+
+    mutex_unlock(&state_mutex);
+}
+
+bool seek_index_lookup(const struct mp3entry *id3, unsigned long sample,
+                       unsigned long *point_sample, size_t *point_pos)
+{
+    struct seek_index_key key;
+    bool ok;
+
+    if (!seek_index_wanted(id3))
+        return false;
+
+    make_key(id3->path, id3, &key);
+
+    mutex_lock(&state_mutex);
+
+    ok = header_matches(&loaded, &key);
+    if (ok)
+    {
+        unsigned long point_samples = loaded.frame_samples *
+                                      loaded.frames_per_point;
+        unsigned long point = sample / point_samples;
+
+        /* The index stops short of tracks too long for the table even at
+           SEEK_INDEX_MAX_FPP; seeks past its end are estimated */
+        ok = point < loaded.count;
+        if (ok)
+        {
+            *point_sample = point * point_samples;
+            *point_pos = seek_index_points[point];
+        }
+    }
+
+    mutex_unlock(&state_mutex);
+
+    /* Not ready; the caller seeks by estimate meanwhile. This does nothing
+       if the index is there but doesn't reach. */
+    if (!ok)
+        seek_index_prepare(id3);
+
+    return ok;
+}
+
+static void seek_index_thread(void)
+{
+    static char path[MAX_PATH];
+    struct seek_index_key key;
+    struct queue_event ev;
+
+    while (1)
+    {
+        queue_wait(&seek_index_queue, &ev);
+
+        switch (ev.id)
+        {
+        case Q_SEEK_INDEX_PREPARE:
+            mutex_lock(&state_mutex);
+            key = request.key;
+            strcpy(path, request.path);
+            request.pending = false;
+            mutex_unlock(&state_mutex);
+
+            mutex_lock(&table_mutex);
+            if (!table_matches(&key) && !read_index(&key, true) &&
+                !build_index(path, &key))
+            {
+                mutex_lock(&state_mutex);
+                failed = key;
+                mutex_unlock(&state_mutex);
+            }
+            mutex_unlock(&table_mutex);
+            break;
+
+        case SYS_USB_CONNECTED:
+            usb_acknowledge(SYS_USB_CONNECTED_ACK);
+            usb_wait_for_disconnect(&seek_index_queue);
+            break;
+        }
+    }
+}
+
+void seek_index_init(void)
+{
+    mutex_init(&state_mutex);
+    mutex_init(&table_mutex);
+
+    queue_init(&seek_index_queue, true);
+    create_thread(seek_index_thread, seek_index_stack,
+                  sizeof(seek_index_stack), 0, seek_index_thread_name
+                  IF_PRIO(, PRIORITY_BACKGROUND)
+                  IF_COP(, CPU));
+}
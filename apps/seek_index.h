@@ -0,0 +1,61 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+#ifndef _SEEK_INDEX_H_
+#define _SEEK_INDEX_H_
+
+#include <stdbool.h>
+#include <sys/types.h>
+#include "metadata.h"
+
+/* Persistent frame offset index for VBR MPEG audio files that have no
+ * Xing/VBRI table of contents, so that seeking in them is exact. */
+
+void seek_index_init(void);
+
+/* True if seeking in this track benefits from an index */
+bool seek_index_wanted(const struct mp3entry *id3);
+
+/* Most frames between two index points. Points are spaced further apart
+ * for longer tracks until this is reached, and the index stops at the end
+ * of the table after that. A seek through the index decodes and drops at
+ * most this many frames plus mpa's SEEK_INDEX_PREROLL (10): 42 frames or
+ * about 1.1s at 44.1kHz. */
+#define SEEK_INDEX_MAX_FPP 32
+
+/* Tracks at least this long (ms) are indexed during database updates */
+#define SEEK_INDEX_SCAN_LENGTH (20*60*1000)
+
+/* Scan the file and write its index to the cache if there isn't one yet.
+ * Used during database updates; blocks while scanning. */
+void seek_index_build(const char *path, const struct mp3entry *id3);
+
+/* Have the seek index thread load the track's index from the cache, or
+ * build it there, in the background. Doesn't block. */
+void seek_index_prepare(const struct mp3entry *id3);
+
+/* Find the last index point at or before decoded sample 'sample' of the
+ * track. Only looks at the index in memory and never blocks on IO; if it
+ * isn't ready this asks for it with seek_index_prepare() and returns false.
+ * Also returns false past the end of an index that stops short. */
+bool seek_index_lookup(const struct mp3entry *id3, unsigned long sample,
+                       unsigned long *point_sample, size_t *point_pos);
+
+#endif /* _SEEK_INDEX_H_ */
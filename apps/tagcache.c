@@ -73,9 +73,13 @@
 #include "string-extra.h"
 #include "usb.h"
 #include "metadata.h"
+#if CONFIG_CODEC == SWCODEC && !defined(__PCTOOL__)
+#include "seek_index.h"
+#endif
 #include "tagcache.h"
 #include "core_alloc.h"
 #include "crc32.h"
+#include "collate.h"
 #include "misc.h"
 #include "settings.h"
 #include "dir.h"
@@ -134,7 +138,8 @@ static int tempbuf_handle;
 static const char *tags_str[] = { "artist", "album", "genre", "title", 
     "filename", "composer", "comment", "albumartist", "grouping", "year", 
     "discnumber", "tracknumber", "bitrate", "length", "playcount", "rating", 
-    "playtime", "lastplayed", "commitid", "mtime", "lastelapsed", "lastoffset" };
+    "playtime", "lastplayed", "commitid", "mtime", "lastelapsed", "lastoffset",
+    "loudness" };
 
 /* Status information of the tagcache. */
 static struct tagcache_stat tc_stat;
@@ -200,7 +205,7 @@ static const char * const tagfile_entry_ec   = "ll";
 /**
  Note: This should be (1 + TAG_COUNT) amount of l's.
  */
-static const char * const index_entry_ec     = "lllllllllllllllllllllll";
+static const char * const index_entry_ec     = "llllllllllllllllllllllll";
 
 static const char * const tagcache_header_ec = "lll";
 static const char * const master_header_ec   = "llllll";
@@ -1930,6 +1935,12 @@ static void NO_INLINE add_tagcache(char *path, unsigned long mtime)
         return ;
 
     logf("-> %s", path);
+
+#if CONFIG_CODEC == SWCODEC && !defined(__PCTOOL__)
+    /* Index long headerless VBR files now rather than on their first seek */
+    if (id3.length >= SEEK_INDEX_SCAN_LENGTH)
+        seek_index_build(path, &id3);
+#endif
     
     if (id3.tracknum <= 0)              /* Track number missing? */
     {
@@ -2098,6 +2109,67 @@ static int compare(const void *p1, const void *p2)
     return strncasecmp(e1->str, e2->str, TAG_MAXLEN);
 }
 
+/* While sorting, each entry's str points to one of these in the free part of
+ * tempbuf, so that qsort() only has to strcmp() the keys. The key starts with
+ * 1 for untagged and 2 for everything else so that untagged goes first. */
+struct tempbuf_key {
+    char *str;
+    char key[];
+};
+
+#define KEY_MIN_LEN 16 /* not worth it for keys shorter than that */
+
+static int compare_keys(const void *p1, const void *p2)
+{
+    do_timed_yield();
+
+    struct tempbuf_searchidx *e1 = (struct tempbuf_searchidx *)p1;
+    struct tempbuf_searchidx *e2 = (struct tempbuf_searchidx *)p2;
+    struct tempbuf_key *k1 = (struct tempbuf_key *)e1->str;
+    struct tempbuf_key *k2 = (struct tempbuf_key *)e2->str;
+    int rc = strcmp(k1->key, k2->key);
+
+    if (rc == 0)
+        rc = strncasecmp(k1->str, k2->str, TAG_MAXLEN);
+    return rc;
+}
+
+/* Sort the tags case folded, the order unsorted lists in the database
+ * browser show them in. This is the on-disk order, so it mustn't depend on
+ * settings: a database built by the PC tool has to come out the same. */
+static void tempbuf_sort_tags(struct tempbuf_searchidx *index, int count)
+{
+    uintptr_t start = ALIGN_UP((uintptr_t)&tempbuf[tempbuf_pos],
+                               sizeof(char *));
+    uintptr_t end = (uintptr_t)&tempbuf[tempbuf_pos] + MAX(tempbuf_left, 0);
+    size_t size = 0;
+    int i;
+
+    if (count > 1 && start < end)
+        size = ALIGN_DOWN((end - start) / count, sizeof(char *));
+
+    if (size < sizeof(struct tempbuf_key) + KEY_MIN_LEN)
+    {   /* no room for keys */
+        qsort(index, count, sizeof(struct tempbuf_searchidx), compare);
+        return;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        struct tempbuf_key *key = (struct tempbuf_key *)(start + i*size);
+        key->str = index[i].str;
+        key->key[0] = strcmp(index[i].str, UNTAGGED) ? 2 : 1;
+        collate_key(&key->key[1], size - sizeof(struct tempbuf_key) - 1,
+                    index[i].str, COLLATE_FOLD_CASE);
+        index[i].str = (char *)key;
+    }
+
+    qsort(index, count, sizeof(struct tempbuf_searchidx), compare_keys);
+
+    for (i = 0; i < count; i++)
+        index[i].str = ((struct tempbuf_key *)index[i].str)->str;
+}
+
 static int tempbuf_sort(int fd)
 {
     struct tempbuf_searchidx *index = (struct tempbuf_searchidx *)tempbuf;
@@ -2140,7 +2212,7 @@ static int tempbuf_sort(int fd)
         do_timed_yield();
     }
     
-    qsort(index, tempbufidx, sizeof(struct tempbuf_searchidx), compare);
+    tempbuf_sort_tags(index, tempbufidx);
     memset(lookup, 0, lookup_buffer_depth * sizeof(struct tempbuf_searchidx **));
     
     for (i = 0; i < tempbufidx; i++)
@@ -2384,6 +2456,7 @@ static bool build_numeric_indices(struct tagcache_header *h, int tmpfd)
                 tmpdb_copy_tag(tag_commitid);
                 tmpdb_copy_tag(tag_lastelapsed);
                 tmpdb_copy_tag(tag_lastoffset);
+                tmpdb_copy_tag(tag_loudness);
                 
                 /* Avoid processing this entry again. */
                 idx.flag |= FLAG_RESURRECTED;
@@ -3427,7 +3500,7 @@ static int parse_changelog_line(int line_n, char *buf, void *parameters)
     long masterfd = (long)(intptr_t)parameters;
     const int import_tags[] = { tag_playcount, tag_rating, tag_playtime,
                                 tag_lastplayed, tag_commitid, tag_lastelapsed,
-                                tag_lastoffset };
+                                tag_lastoffset, tag_loudness };
     int i;
     (void)line_n;
     
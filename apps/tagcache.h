@@ -34,7 +34,7 @@ enum tag_type { tag_artist = 0, tag_album, tag_genre, tag_title,
     tag_filename, tag_composer, tag_comment, tag_albumartist, tag_grouping, tag_year, 
     tag_discnumber, tag_tracknumber, tag_bitrate, tag_length, tag_playcount, tag_rating,
     tag_playtime, tag_lastplayed, tag_commitid, tag_mtime, tag_lastelapsed,
-    tag_lastoffset,
+    tag_lastoffset, tag_loudness,
     /* Real tags end here, count them. */
     TAG_COUNT,
     /* Virtual tags */
@@ -52,7 +52,7 @@ enum tag_type { tag_artist = 0, tag_album, tag_genre, tag_title,
 #define IDX_BUF_DEPTH 64
 
 /* Tag Cache Header version 'TCHxx'. Increment when changing internal structures. */
-#define TAGCACHE_MAGIC  0x5443480f
+#define TAGCACHE_MAGIC  0x54434810
 
 /* Dump store/restore header version 'TCSxx'. */
 #define TAGCACHE_STATEFILE_MAGIC 0x54435301
@@ -109,6 +109,7 @@ enum tag_type { tag_artist = 0, tag_album, tag_genre, tag_title,
     (1LU << tag_playcount) | (1LU << tag_rating) | (1LU << tag_playtime) | \
     (1LU << tag_lastplayed) | (1LU << tag_commitid) | (1LU << tag_mtime) | \
     (1LU << tag_lastelapsed) | (1LU << tag_lastoffset) | \
+    (1LU << tag_loudness) | \
     (1LU << tag_virt_basename) | (1LU << tag_virt_length_min) | \
     (1LU << tag_virt_length_sec) | (1LU << tag_virt_playtime_min) | \
     (1LU << tag_virt_playtime_sec) | (1LU << tag_virt_entryage) | \
@@ -116,6 +117,15 @@ enum tag_type { tag_artist = 0, tag_album, tag_genre, tag_title,
 
 #define TAGCACHE_IS_NUMERIC(tag) (BIT_N(tag) & TAGCACHE_NUMERIC_TAGS)
 
+/* tag_loudness holds the result of a loudness scan: the ReplayGain 2.0 track
+   gain in dB * 128 (biased by 0x4000) in bits 30..16 and the true peak in
+   Q2.14 in bits 15..0. The peak is stored as at least 1, so 0 means the track
+   hasn't been scanned. */
+#define LOUDNESS_PACK(gain, peak) \
+    ((((long)(gain) + 0x4000) << 16) | (long)(peak))
+#define LOUDNESS_GAIN(data) ((((data) >> 16) & 0x7fff) - 0x4000)
+#define LOUDNESS_PEAK(data) ((data) & 0xffff)
+
 /* Flags */
 #define FLAG_DELETED     0x0001  /* Entry has been removed from db */
 #define FLAG_DIRCACHE    0x0002  /* Filename is a dircache pointer */
@@ -54,6 +54,7 @@
 #include "dir.h"
 #include "playback.h"
 #include "strnatcmp.h"
+#include "collate.h"
 #include "panic.h"
 
 #define str_or_empty(x) (x ? x : "(NULL)")
@@ -117,6 +118,7 @@ static long uniqbuf[UNIQBUF_SIZE / sizeof(long)];
 
 #define RELOAD_TAGTREE (-1024)
 static bool sort_inverse;
+static bool sort_ignore_the;
 
 /*
  * "%3d. %s" autoscore title %sort = "inverse" %limit = "100"
@@ -129,6 +131,8 @@ static bool sort_inverse;
  *
  * limit = 100
  * sort_inverse = true
+ *
+ * %sort = "ignorethe" sorts "The Band" as "Band"
  */
 struct display_format {
     char name[32];
@@ -142,6 +146,7 @@ struct display_format {
     int limit;
     int strip;
     bool sort_inverse;
+    bool sort_ignore_the;
 };
 
 static struct display_format *formats[TAGMENU_MAX_FMTS];
@@ -345,6 +350,7 @@ static int get_tag(int *tag)
         {"lastplayed", tag_lastplayed},
         {"lastelapsed", tag_lastelapsed},
         {"lastoffset", tag_lastoffset},
+        {"loudness", tag_loudness},
         {"commitid", tag_commitid},
         {"entryage", tag_virt_entryage},
         {"autoscore", tag_virt_autoscore},
@@ -561,6 +567,8 @@ static int get_format_str(struct display_format *fmt)
                 return -12;
             if (!strcasecmp("inverse", buf))
                 fmt->sort_inverse = true;
+            else if (!strcasecmp("ignorethe", buf))
+                fmt->sort_ignore_the = true;
             break;
 
         case var_limit:
@@ -821,26 +829,104 @@ static bool parse_search(struct menu_entry *entry, const char *str)
     return true;
 }
 
+static const char *sort_name(const char *name)
+{
+    if (sort_ignore_the && !strncasecmp(name, "the ", 4) && name[4])
+        return name + 4;
+    return name;
+}
+
 static int compare(const void *p1, const void *p2)
 {
-    struct tagentry *e1 = (struct tagentry *)p1;
-    struct tagentry *e2 = (struct tagentry *)p2;
+    const char *n1 = sort_name(((struct tagentry *)p1)->name);
+    const char *n2 = sort_name(((struct tagentry *)p2)->name);
 
     if (sort_inverse)
-        return strncasecmp(e2->name, e1->name, MAX_PATH);
+        return strncasecmp(n2, n1, MAX_PATH);
 
-    return strncasecmp(e1->name, e2->name, MAX_PATH);
+    return strncasecmp(n1, n2, MAX_PATH);
 }
 
 static int nat_compare(const void *p1, const void *p2)
 {
-    struct tagentry *e1 = (struct tagentry *)p1;
-    struct tagentry *e2 = (struct tagentry *)p2;
+    const char *n1 = sort_name(((struct tagentry *)p1)->name);
+    const char *n2 = sort_name(((struct tagentry *)p2)->name);
 
     if (sort_inverse)
-        return strnatcasecmp(e2->name, e1->name);
+        return strnatcasecmp(n2, n1);
+
+    return strnatcasecmp(n1, n2);
+}
+
+/* While sorting, each entry's name points to one of these in the unused end
+ * of the name buffer, so that qsort() only has to strcmp() the keys. Names
+ * with keys that come out the same go through compare() or nat_compare(). */
+struct tagentry_key {
+    char *name;
+    char key[];
+};
 
-    return strnatcasecmp(e1->name, e2->name);
+#define KEY_MIN_LEN 16 /* not worth it for keys shorter than that */
+
+static int key_compare(const void *p1, const void *p2)
+{
+    const struct tagentry *e1 = (const struct tagentry *)p1;
+    const struct tagentry *e2 = (const struct tagentry *)p2;
+    const struct tagentry_key *k1 = (const struct tagentry_key *)e1->name;
+    const struct tagentry_key *k2 = (const struct tagentry_key *)e2->name;
+    int rc = strcmp(k1->key, k2->key);
+
+    if (rc == 0)
+    {
+        struct tagentry t1 = *e1, t2 = *e2;
+        t1.name = k1->name;
+        t2.name = k2->name;
+        rc = global_settings.interpret_numbers ? nat_compare(&t1, &t2)
+                                               : compare(&t1, &t2);
+    }
+    return rc;
+}
+
+static void sort_entries(struct tree_context *c, struct tagentry *entries,
+                         int count, int namebufused)
+{
+    char *buf = core_get_data(c->cache.name_buffer_handle);
+    uintptr_t start = ALIGN_UP((uintptr_t)(buf + namebufused), sizeof(char *));
+    uintptr_t end = (uintptr_t)(buf + c->cache.name_buffer_size);
+    unsigned flags = COLLATE_FOLD_CASE;
+    size_t size = 0;
+    int i;
+
+    if (count > 1 && start < end)
+        size = ALIGN_DOWN((end - start) / count, sizeof(char *));
+
+    if (size < sizeof(struct tagentry_key) + KEY_MIN_LEN)
+    {   /* no room for keys */
+        qsort(entries, count, sizeof(struct tagentry),
+              global_settings.interpret_numbers ? nat_compare : compare);
+        return;
+    }
+
+    if (global_settings.interpret_numbers)
+        flags |= COLLATE_NUMBERS;
+    if (sort_ignore_the)
+        flags |= COLLATE_IGNORE_THE;
+    if (sort_inverse)
+        flags |= COLLATE_REVERSE;
+
+    for (i = 0; i < count; i++)
+    {
+        struct tagentry_key *key = (struct tagentry_key *)(start + i*size);
+        key->name = entries[i].name;
+        collate_key(key->key, size - sizeof(struct tagentry_key),
+                    entries[i].name, flags);
+        entries[i].name = (char *)key;
+    }
+
+    qsort(entries, count, sizeof(struct tagentry), key_compare);
+
+    for (i = 0; i < count; i++)
+        entries[i].name = ((struct tagentry_key *)entries[i].name)->name;
 }
 
 static void tagtree_buffer_event(unsigned short id, void *ev_data)
@@ -1511,6 +1597,7 @@ static int retrieve_entries(struct tree_context *c, int offset, bool init)
     if (fmt)
     {
         sort_inverse = fmt->sort_inverse;
+        sort_ignore_the = fmt->sort_ignore_the;
         sort_limit = fmt->limit;
         strip = fmt->strip;
         sort = true;
@@ -1518,6 +1605,7 @@ static int retrieve_entries(struct tree_context *c, int offset, bool init)
     else
     {
         sort_inverse = false;
+        sort_ignore_the = false;
         sort_limit = 0;
         strip = 0;
     }
@@ -1656,10 +1744,8 @@ static int retrieve_entries(struct tree_context *c, int offset, bool init)
     if (sort)
     {
         struct tagentry *entries = get_entries(c);
-        qsort(&entries[special_entry_count],
-              current_entry_count - special_entry_count,
-              sizeof(struct tagentry),
-              global_settings.interpret_numbers ? nat_compare : compare);
+        sort_entries(c, &entries[special_entry_count],
+                     current_entry_count - special_entry_count, namebufused);
     }
 
     if (!init)
@@ -96,6 +96,7 @@ static int lasttable, lastextra, lastfirstpos;
 #endif
 
 static bool reload_dir = false;
+static bool select_lastfile = false; /* lastfile may not be loaded yet */
 
 static bool start_wps = false;
 static int curr_context = false;/* id3db or tree*/
@@ -383,7 +384,9 @@ static int update_dir(void)
         /* if the tc.currdir has been changed, reload it ...*/
         if (strncmp(tc.currdir, lastdir, sizeof(lastdir)) || reload_dir)
         {
-            if (ft_load(&tc, NULL) < 0)
+            /* show what's there after a moment, dirbrowse() reads the rest */
+            if (ft_load_start(&tc, *tc.dirfilter > NUM_FILTER_MODES ?
+                                   TIMEOUT_BLOCK : HZ/10) < 0)
                 return -1;
             strcpy(lastdir, tc.currdir);
             changed = true;
@@ -396,8 +399,12 @@ static int update_dir(void)
         tc.selected_item = tree_get_file_position(lastfile);
 
         /* If the file doesn't exists, select the first one (default) */
+        select_lastfile = false;
         if(tc.selected_item < 0)
+        {
+            select_lastfile = ft_load_pending();
             tc.selected_item = 0;
+        }
         changed = true;
     }
     if (changed)
@@ -488,6 +495,40 @@ static int update_dir(void)
     return tc.filesindir;
 }
 
+/* Read more of a directory that is still loading, keeping the selected
+ * entry selected as the sorted list grows around it. Returns the number of
+ * entries now in the list. */
+static int tree_load_more(long timeout)
+{
+    char name[MAX_PATH];
+    struct entry *entry = tree_get_entry_at(&tc, tc.selected_item);
+
+    name[0] = '\0';
+    if (select_lastfile)
+        strlcpy(name, lastfile, sizeof(name));
+    else if (entry && tc.selected_item < tc.filesindir)
+        strlcpy(name, entry->name, sizeof(name));
+
+    ft_load_continue(&tc, timeout);
+
+    if (name[0])
+    {
+        int pos = tree_get_file_position(name);
+        if (pos >= 0)
+        {
+            tc.selected_item = pos;
+            select_lastfile = false;
+        }
+    }
+
+    gui_synclist_set_nb_items(&tree_lists, tc.filesindir);
+    gui_synclist_select_item(&tree_lists, tc.selected_item);
+    gui_synclist_draw(&tree_lists);
+    if (tc.dirfull)
+        splash(HZ, ID2P(LANG_SHOWDIR_BUFFER_FULL));
+    return tc.filesindir;
+}
+
 /* load tracks from specified directory to resume play */
 void resume_directory(const char *dir)
 {
@@ -677,13 +718,25 @@ static int dirbrowse(void)
 #if CONFIG_CODEC == SWCODEC
         keyclick_set_callback(gui_synclist_keyclick_callback, &tree_lists);
 #endif
-        button = get_action(CONTEXT_TREE,
+        button = get_action(CONTEXT_TREE, ft_load_pending() ? TIMEOUT_NOBLOCK :
                             list_do_action_timeout(&tree_lists, HZ/2));
 #ifdef HAVE_LCD_BITMAP
         oldbutton = button;
 #endif
         gui_synclist_do_button(&tree_lists, &button,LIST_WRAP_UNLESS_HELD);
         tc.selected_item = gui_synclist_get_sel_pos(&tree_lists);
+
+        if (ft_load_pending())
+        {   /* keep reading a big directory between button presses, the list
+               can be scrolled meanwhile but anything else needs all of it */
+            if (button == ACTION_NONE)
+                numentries = tree_load_more(HZ/10);
+            else if (button == ACTION_STD_PREV || button == ACTION_STD_NEXT ||
+                     button == ACTION_REDRAW)
+                select_lastfile = false;
+            else
+                numentries = tree_load_more(TIMEOUT_BLOCK);
+        }
         switch ( button ) {
             case ACTION_STD_OK:
                 /* nothing to do if no files to display */
@@ -0,0 +1,95 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+#include <arm_neon.h>
+#include "dsp-util.h" /* for clip_sample_16 */
+
+#define MIXER_OPTIMIZED_MIX_SAMPLES
+#define MIXER_OPTIMIZED_WRITE_SAMPLES
+
+/* Scale eight samples by a gain factor at 32 bits: (s * amp) >> 16
+ * Unity is 1 << 16 so the product can't overflow */
+static FORCE_INLINE void mix_scale_neon(int16x8_t s, int32_t amp,
+                                        int32x4_t *lo, int32x4_t *hi)
+{
+    *lo = vshrq_n_s32(vmulq_n_s32(vmovl_s16(vget_low_s16(s)), amp), 16);
+    *hi = vshrq_n_s32(vmulq_n_s32(vmovl_s16(vget_high_s16(s)), amp), 16);
+}
+
+/* Mix channels' samples and apply gain factors */
+static FORCE_INLINE void mix_samples(void *out,
+                                     const void *src0,
+                                     int32_t src0_amp,
+                                     const void *src1,
+                                     int32_t src1_amp,
+                                     size_t size)
+{
+    int16_t *d = out;
+    const int16_t *s0 = src0, *s1 = src1;
+    size_t n = size / sizeof (int16_t);
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8)
+    {
+        int32x4_t lo0, hi0, lo1, hi1;
+        mix_scale_neon(vld1q_s16(s0 + i), src0_amp, &lo0, &hi0);
+        mix_scale_neon(vld1q_s16(s1 + i), src1_amp, &lo1, &hi1);
+        vst1q_s16(d + i, vcombine_s16(vqmovn_s32(vaddq_s32(lo0, lo1)),
+                                      vqmovn_s32(vaddq_s32(hi0, hi1))));
+    }
+
+    /* Remaining samples of a partial vector */
+    for (; i < n; i++)
+        d[i] = clip_sample_16((s0[i] * src0_amp >> 16) +
+                              (s1[i] * src1_amp >> 16));
+}
+
+/* Write channel's samples and apply gain factor */
+static FORCE_INLINE void write_samples(void *out,
+                                       const void *src,
+                                       int32_t amp,
+                                       size_t size)
+{
+    if (LIKELY(amp == MIX_AMP_UNITY))
+    {
+        /* Channel is unity amplitude */
+        memcpy(out, src, size);
+    }
+    else
+    {
+        /* Channel needs amplitude cut */
+        int16_t *d = out;
+        const int16_t *s = src;
+        size_t n = size / sizeof (int16_t);
+        size_t i = 0;
+
+        for (; i + 8 <= n; i += 8)
+        {
+            int16x8_t v = vld1q_s16(s + i);
+            int32x4_t lo = vmulq_n_s32(vmovl_s16(vget_low_s16(v)), amp);
+            int32x4_t hi = vmulq_n_s32(vmovl_s16(vget_high_s16(v)), amp);
+            vst1q_s16(d + i, vcombine_s16(vshrn_n_s32(lo, 16),
+                                          vshrn_n_s32(hi, 16)));
+        }
+
+        for (; i < n; i++)
+            d[i] = s[i] * amp >> 16;
+    }
+}
@@ -1,4 +1,6 @@
-#if ARM_ARCH >= 6
+#if ARM_ARCH >= 7 && defined(__ARM_NEON__)
+  #include "pcm-mixer-neon.c"
+#elif ARM_ARCH >= 6
   #include "pcm-mixer-armv6.c"
 #elif ARM_ARCH >= 5
   #include "pcm-mixer-armv5.c"
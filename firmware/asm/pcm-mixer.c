@@ -23,8 +23,16 @@
   #include "arm/pcm-mixer.c"
 #elif defined(CPU_COLDFIRE)
   #include "m68k/pcm-mixer.c"
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+  /* AArch64 hosted */
+  #include "arm/pcm-mixer-neon.c"
+#elif defined(__SSE2__)
+  #include "x86/pcm-mixer-sse2.c"
 #else
 
+/* Single-pass mixing of more than two channels */
+#define MIXER_HAVE_MIX_SAMPLES_N
+
 #include "dsp-util.h" /* for clip_sample_16 */
 /* Mix channels' samples and apply gain factors */
 static FORCE_INLINE void mix_samples(int16_t *out,
@@ -82,6 +90,36 @@ static FORCE_INLINE void mix_samples(int16_t *out,
     }
 }
 
+/* Mix 'count' channels' samples in one pass, apply gain factors and
+   saturate the sum once. There are no more than three mixer channels. */
+static FORCE_INLINE void mix_samples_n(int16_t *out,
+                                       const void * const *src,
+                                       const int32_t *amp,
+                                       unsigned int count,
+                                       size_t size)
+{
+    if (count == 2)
+    {
+        mix_samples(out, src[0], amp[0], src[1], amp[1], size);
+        return;
+    }
+
+    const int16_t *src0 = src[0], *src1 = src[1], *src2 = src[2];
+    int32_t amp0 = amp[0], amp1 = amp[1], amp2 = amp[2];
+
+    /* Unity is 1 << 16 so the products can't overflow 32 bits */
+    do
+    {
+        int32_t l = (*src0++ * amp0 >> 16) + (*src1++ * amp1 >> 16) +
+                    (*src2++ * amp2 >> 16);
+        int32_t h = (*src0++ * amp0 >> 16) + (*src1++ * amp1 >> 16) +
+                    (*src2++ * amp2 >> 16);
+        *out++ = clip_sample_16(l);
+        *out++ = clip_sample_16(h);
+    }
+    while ((size -= 2*sizeof(int16_t)) > 0);
+}
+
 /* Write channel's samples and apply gain factor */
 static FORCE_INLINE void write_samples(int16_t *out,
                                        const int16_t *src,
@@ -0,0 +1,101 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+#include <emmintrin.h>
+#include "dsp-util.h" /* for clip_sample_16 */
+
+#define MIXER_OPTIMIZED_MIX_SAMPLES
+#define MIXER_OPTIMIZED_WRITE_SAMPLES
+
+/* Scale eight samples by a sub-unity gain factor: (s * amp) >> 16
+ * SSE2 has no signed-by-unsigned high multiply, so do an unsigned one and
+ * take back the extra 'amp' it adds for each negative sample. */
+static FORCE_INLINE __m128i mix_scale_sse2(__m128i s, __m128i amp)
+{
+    __m128i hi = _mm_mulhi_epu16(s, amp);
+    return _mm_sub_epi16(hi, _mm_and_si128(amp, _mm_srai_epi16(s, 15)));
+}
+
+/* Load eight samples and apply the channel's gain factor */
+static FORCE_INLINE __m128i mix_load_sse2(const int16_t *src, int32_t amp,
+                                          __m128i ampv)
+{
+    __m128i s = _mm_loadu_si128((const __m128i *)src);
+    return amp == MIX_AMP_UNITY ? s : mix_scale_sse2(s, ampv);
+}
+
+/* Mix channels' samples and apply gain factors */
+static FORCE_INLINE void mix_samples(void *out,
+                                     const void *src0,
+                                     int32_t src0_amp,
+                                     const void *src1,
+                                     int32_t src1_amp,
+                                     size_t size)
+{
+    int16_t *d = out;
+    const int16_t *s0 = src0, *s1 = src1;
+    size_t n = size / sizeof (int16_t);
+    size_t i = 0;
+    __m128i amp0 = _mm_set1_epi16((int16_t)src0_amp);
+    __m128i amp1 = _mm_set1_epi16((int16_t)src1_amp);
+
+    /* Saturating add of two terms is exactly a clipped sum */
+    for (; i + 8 <= n; i += 8)
+    {
+        __m128i a = mix_load_sse2(s0 + i, src0_amp, amp0);
+        __m128i b = mix_load_sse2(s1 + i, src1_amp, amp1);
+        _mm_storeu_si128((__m128i *)(d + i), _mm_adds_epi16(a, b));
+    }
+
+    for (; i < n; i++)
+        d[i] = clip_sample_16((s0[i] * src0_amp >> 16) +
+                              (s1[i] * src1_amp >> 16));
+}
+
+/* Write channel's samples and apply gain factor */
+static FORCE_INLINE void write_samples(void *out,
+                                       const void *src,
+                                       int32_t amp,
+                                       size_t size)
+{
+    if (LIKELY(amp == MIX_AMP_UNITY))
+    {
+        /* Channel is unity amplitude */
+        memcpy(out, src, size);
+    }
+    else
+    {
+        /* Channel needs amplitude cut */
+        int16_t *d = out;
+        const int16_t *s = src;
+        size_t n = size / sizeof (int16_t);
+        size_t i = 0;
+        __m128i ampv = _mm_set1_epi16((int16_t)amp);
+
+        for (; i + 8 <= n; i += 8)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i *)(s + i));
+            _mm_storeu_si128((__m128i *)(d + i), mix_scale_sse2(v, ampv));
+        }
+
+        for (; i < n; i++)
+            d[i] = s[i] * amp >> 16;
+    }
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/* Collation keys: a string turned into bytes that strcmp() orders the way
+ * the flags ask for, so that sorting a list can build a key per item once
+ * instead of comparing the strings the slow way O(n log n) times.
+ *
+ * Case is folded with tolower(). With COLLATE_NUMBERS every run of digits
+ * becomes '0', a length byte and the digits without leading zeros, so that
+ * numbers compare by value much like strnatcmp(), except that leading zeros
+ * don't matter. For COLLATE_REVERSE the bytes are inverted and a complete
+ * key gets a 0xff so that it still goes after the longer strings it's a
+ * prefix of.
+ *
+ * Strings that differ only in ways the key doesn't see, or whose keys were
+ * cut short, come out equal and need comparing some other way. */
+
+#include <ctype.h>
+#include "string-extra.h"
+#include "system.h"
+#include "collate.h"
+
+/* Write the key for str to key, at most size bytes including the terminating
+ * 0. Returns the length of the key. */
+size_t collate_key(char *key, size_t size, const char *str, unsigned flags)
+{
+    const unsigned char *s = (const unsigned char *)str;
+    unsigned char *p = (unsigned char *)key;
+    unsigned char *end = p + size - 1;
+    unsigned char flip = (flags & COLLATE_REVERSE) ? 0xff : 0;
+
+    if (size == 0)
+        return 0;
+
+    if ((flags & COLLATE_IGNORE_THE) && !strncasecmp(str, "the ", 4) && s[4])
+        s += 4;
+
+    while (*s && p < end)
+    {
+        if ((flags & COLLATE_NUMBERS) && isdigit(*s))
+        {
+            const unsigned char *d;
+            while (*s == '0' && isdigit(s[1]))
+                s++;
+            for (d = s; isdigit(*d); d++);
+
+            *p++ = '0' ^ flip;
+            if (p < end)
+                *p++ = MIN(d - s + 1, 0xfe) ^ flip;
+            while (s < d && p < end)
+                *p++ = *s++ ^ flip;
+        }
+        else
+        {
+            unsigned char ch = (flags & COLLATE_FOLD_CASE) ? tolower(*s) : *s;
+            *p++ = MIN(ch, 0xfe) ^ flip;
+            s++;
+        }
+    }
+
+    if (!*s && flip && p < end)
+        *p++ = 0xff;
+    *p = '\0';
+
+    return p - (unsigned char *)key;
+}
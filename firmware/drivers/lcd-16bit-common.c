@@ -263,6 +263,178 @@ void lcd_fillrect(int x, int y, int width, int height)
     while (dst <= dst_end);
 }
 
+/* Hosted builds with SSE2 or NEON draw bitmaps a framebuffer row at a time,
+ * 8 pixels per step. Only for the horizontal layout, where a row is
+ * contiguous in memory. The targets keep the per-pixel loops below (ARM and
+ * ColdFire already blend all three channels at once through the BLEND_*
+ * multiply-accumulate macros). */
+#if (COL_INC == 1) && (CONFIG_PLATFORM & PLATFORM_HOSTED) && \
+    !defined(CPU_ARM) && !defined(CPU_COLDFIRE) && \
+    (defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__))
+#define LCD_ROW_SIMD
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+
+typedef __m128i lcd_vec_t;
+
+#define lcd_vload(p)        _mm_loadu_si128((const __m128i *)(p))
+#define lcd_vstore(p, x)    _mm_storeu_si128((__m128i *)(p), (x))
+#define lcd_vdup(c)         _mm_set1_epi16((short)(c))
+#define lcd_vxor(x, y)      _mm_xor_si128((x), (y))
+#define lcd_vsel(m, x, y)   _mm_or_si128(_mm_and_si128((m), (x)), \
+                                         _mm_andnot_si128((m), (y)))
+
+/* the 8 bytes at p, zero extended to 16 bit lanes */
+static inline lcd_vec_t lcd_vbytes(const unsigned char *p)
+{
+    return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)p),
+                             _mm_setzero_si128());
+}
+
+/* the 8 alpha values at p, scaled from 0..15 to 0..16 */
+static inline lcd_vec_t lcd_valpha(const unsigned char *p)
+{
+    lcd_vec_t a = lcd_vbytes(p);
+    return _mm_add_epi16(a, _mm_srli_epi16(a, 3));
+}
+
+/* all-ones in the lanes where the byte at p has the bit set */
+static inline lcd_vec_t lcd_vbits(const unsigned char *p, unsigned bit)
+{
+    lcd_vec_t b = lcd_vdup(bit);
+    return _mm_cmpeq_epi16(_mm_and_si128(lcd_vbytes(p), b), b);
+}
+
+#if (LCD_PIXELFORMAT == RGB565SWAPPED)
+static inline lcd_vec_t lcd_vswap(lcd_vec_t x)
+{
+    return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+}
+#endif
+
+/* c2 + (((c1 - c2) * a) >> 4) on each channel, a being 0..16. That is
+ * (c1 * a + c2 * (16 - a)) >> 4 as in blend_two_colors(), since c2 * 16
+ * drops out of the shift. */
+static inline lcd_vec_t lcd_vblend(lcd_vec_t c1, lcd_vec_t c2, lcd_vec_t a)
+{
+    const lcd_vec_t m5 = lcd_vdup(0x1f), m6 = lcd_vdup(0x3f);
+    lcd_vec_t r1 = _mm_srli_epi16(c1, 11);
+    lcd_vec_t r2 = _mm_srli_epi16(c2, 11);
+    lcd_vec_t g1 = _mm_and_si128(_mm_srli_epi16(c1, 5), m6);
+    lcd_vec_t g2 = _mm_and_si128(_mm_srli_epi16(c2, 5), m6);
+    lcd_vec_t b1 = _mm_and_si128(c1, m5);
+    lcd_vec_t b2 = _mm_and_si128(c2, m5);
+    lcd_vec_t r = _mm_add_epi16(r2, _mm_srai_epi16(
+                        _mm_mullo_epi16(_mm_sub_epi16(r1, r2), a), 4));
+    lcd_vec_t g = _mm_add_epi16(g2, _mm_srai_epi16(
+                        _mm_mullo_epi16(_mm_sub_epi16(g1, g2), a), 4));
+    lcd_vec_t b = _mm_add_epi16(b2, _mm_srai_epi16(
+                        _mm_mullo_epi16(_mm_sub_epi16(b1, b2), a), 4));
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11),
+                                     _mm_slli_epi16(g, 5)), b);
+}
+
+#else /* NEON */
+#include <arm_neon.h>
+
+typedef uint16x8_t lcd_vec_t;
+
+#define lcd_vload(p)        vld1q_u16((const uint16_t *)(p))
+#define lcd_vstore(p, x)    vst1q_u16((uint16_t *)(p), (x))
+#define lcd_vdup(c)         vdupq_n_u16((uint16_t)(c))
+#define lcd_vxor(x, y)      veorq_u16((x), (y))
+#define lcd_vsel(m, x, y)   vbslq_u16((m), (x), (y))
+
+static inline lcd_vec_t lcd_vbytes(const unsigned char *p)
+{
+    return vmovl_u8(vld1_u8(p));
+}
+
+static inline lcd_vec_t lcd_valpha(const unsigned char *p)
+{
+    lcd_vec_t a = lcd_vbytes(p);
+    return vsraq_n_u16(a, a, 3);
+}
+
+static inline lcd_vec_t lcd_vbits(const unsigned char *p, unsigned bit)
+{
+    return vtstq_u16(lcd_vbytes(p), lcd_vdup(bit));
+}
+
+#if (LCD_PIXELFORMAT == RGB565SWAPPED)
+static inline lcd_vec_t lcd_vswap(lcd_vec_t x)
+{
+    return vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(x)));
+}
+#endif
+
+static inline lcd_vec_t lcd_vblend(lcd_vec_t c1, lcd_vec_t c2, lcd_vec_t a)
+{
+    const lcd_vec_t m5 = lcd_vdup(0x1f), m6 = lcd_vdup(0x3f);
+    int16x8_t sa = vreinterpretq_s16_u16(a);
+    int16x8_t r1 = vreinterpretq_s16_u16(vshrq_n_u16(c1, 11));
+    int16x8_t r2 = vreinterpretq_s16_u16(vshrq_n_u16(c2, 11));
+    int16x8_t g1 = vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(c1, 5), m6));
+    int16x8_t g2 = vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(c2, 5), m6));
+    int16x8_t b1 = vreinterpretq_s16_u16(vandq_u16(c1, m5));
+    int16x8_t b2 = vreinterpretq_s16_u16(vandq_u16(c2, m5));
+    uint16x8_t r = vreinterpretq_u16_s16(
+                    vaddq_s16(r2, vshrq_n_s16(vmulq_s16(vsubq_s16(r1, r2), sa), 4)));
+    uint16x8_t g = vreinterpretq_u16_s16(
+                    vaddq_s16(g2, vshrq_n_s16(vmulq_s16(vsubq_s16(g1, g2), sa), 4)));
+    uint16x8_t b = vreinterpretq_u16_s16(
+                    vaddq_s16(b2, vshrq_n_s16(vmulq_s16(vsubq_s16(b1, b2), sa), 4)));
+    return vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b);
+}
+
+#endif /* __SSE2__ */
+
+/* Where a row kernel takes its colours from: a framebuffer-shaped row (the
+ * destination itself, the backdrop or an image), or one solid colour */
+struct lcd_row_src
+{
+    const fb_data *p;   /* NULL for the solid colour */
+    unsigned fill;
+    unsigned flip;      /* xor'ed into every pixel read */
+};
+
+static inline unsigned lcd_row_get(const struct lcd_row_src *s, int i)
+{
+    return (fb_data)((s->p ? s->p[i] : s->fill) ^ s->flip);
+}
+
+static inline lcd_vec_t lcd_row_vget(const struct lcd_row_src *s, int i)
+{
+    return lcd_vxor(s->p ? lcd_vload(s->p + i) : lcd_vdup(s->fill),
+                    lcd_vdup(s->flip));
+}
+
+/* One row of a mono bitmap: src points to the bitmap bytes of the row, bit
+ * selects the row within them. Pixels with the bit set (cleared if inv) take
+ * their colour from on, the others from off. */
+static void lcd_mono_row(fb_data *dst, const unsigned char *src,
+                         unsigned bit, unsigned inv,
+                         const struct lcd_row_src *on,
+                         const struct lcd_row_src *off, int width)
+{
+    lcd_vec_t vinv = lcd_vdup(inv ? 0xffff : 0);
+    int i = 0;
+
+    for (; i <= width - 8; i += 8)
+    {
+        lcd_vec_t m = lcd_vxor(lcd_vbits(src + i, bit), vinv);
+        lcd_vstore(dst + i, lcd_vsel(m, lcd_row_vget(on, i),
+                                        lcd_row_vget(off, i)));
+    }
+    for (; i < width; i++)
+    {
+        unsigned set = !(src[i] & bit) == !!inv;
+        dst[i] = set ? lcd_row_get(on, i) : lcd_row_get(off, i);
+    }
+}
+#endif /* hosted SIMD */
+
 /* About Rockbox' internal monochrome bitmap format:
  *
  * A bitmap contains one bit for every pixel that defines if that pixel is
@@ -281,7 +453,6 @@ void ICODE_ATTR lcd_mono_bitmap_part(const unsigned char *src, int src_x,
                                      int src_y, int stride, int x, int y,
                                      int width, int height)
 {
-    const unsigned char *src_end;
     fb_data *dst, *dst_col;
     unsigned dmask = 0x100; /* bit 8 == sentinel */
     int drmode = current_vp->drawmode;
@@ -342,7 +513,6 @@ void ICODE_ATTR lcd_mono_bitmap_part(const unsigned char *src, int src_x,
 
     src += stride * (src_y >> 3) + src_x; /* move starting point */
     src_y  &= 7;
-    src_end = src + width;
     dst_col = FBADDR(x, y);
 
 
@@ -356,6 +526,33 @@ void ICODE_ATTR lcd_mono_bitmap_part(const unsigned char *src, int src_x,
     if ((drmode & DRMODE_BG) && lcd_backdrop)
         drmode |= DRMODE_INT_BD;
 
+#ifdef LCD_ROW_SIMD
+    /* go through each row; on and off pixels take their colour from the
+     * pattern, the backdrop or the framebuffer itself, see lcd_mono_row() */
+    struct lcd_row_src on = { NULL, current_vp->fg_pattern, 0 };
+    struct lcd_row_src off = { NULL, current_vp->bg_pattern, 0 };
+
+    if (drmode == DRMODE_COMPLEMENT)
+        on.flip = 0xffff;
+
+    for (row = 0; row < height; row++)
+    {
+        dst = dst_col;
+        dst_col += ROW_INC;
+
+        if (!(drmode & DRMODE_FG))
+            on.p = dst;
+        if (!(drmode & DRMODE_BG))
+            off.p = dst;
+        else if (drmode & DRMODE_INT_BD)
+            off.p = PTR_ADD(dst, lcd_backdrop_offset);
+
+        lcd_mono_row(dst, src + stride * ((src_y + row) >> 3),
+                     1u << ((src_y + row) & 7), dmask & 1, &on, &off, width);
+    }
+#else
+    const unsigned char *src_end = src + width;
+
     /* go through each column and update each pixel  */
     do
     {
@@ -456,6 +653,7 @@ void ICODE_ATTR lcd_mono_bitmap_part(const unsigned char *src, int src_x,
         }
     }
     while (src < src_end);
+#endif /* LCD_ROW_SIMD */
 }
 /* Draw a full monochrome bitmap */
 void lcd_mono_bitmap(const unsigned char *src, int x, int y, int width, int height)
@@ -538,6 +736,32 @@ static inline unsigned blend_two_colors(unsigned c1, unsigned c2, unsigned a)
 #endif
 }
 
+#ifdef LCD_ROW_SIMD
+/* One row of lcd_alpha_bitmap_part_mix(): blend_two_colors() of c1 and c2
+ * with the unpacked alpha values */
+static void lcd_alpha_row(fb_data *dst, const unsigned char *alpha,
+                          const struct lcd_row_src *c1,
+                          const struct lcd_row_src *c2, int width)
+{
+    int i = 0;
+
+    for (; i <= width - 8; i += 8)
+    {
+        lcd_vec_t v1 = lcd_row_vget(c1, i);
+        lcd_vec_t v2 = lcd_row_vget(c2, i);
+#if (LCD_PIXELFORMAT == RGB565SWAPPED)
+        lcd_vstore(dst + i, lcd_vswap(lcd_vblend(lcd_vswap(v1), lcd_vswap(v2),
+                                                 lcd_valpha(alpha + i))));
+#else
+        lcd_vstore(dst + i, lcd_vblend(v1, v2, lcd_valpha(alpha + i)));
+#endif
+    }
+    for (; i < width; i++)
+        dst[i] = blend_two_colors(lcd_row_get(c1, i), lcd_row_get(c2, i),
+                                  alpha[i]);
+}
+#endif /* LCD_ROW_SIMD */
+
 /* Blend an image with an alpha channel
  * if image is NULL, drawing will happen according to the drawmode
  * src is the alpha channel (4bit per pixel) */
@@ -638,6 +862,54 @@ static void ICODE_ATTR lcd_alpha_bitmap_part_mix(const fb_data* image,
 
     dst_row = FBADDR(x, y);
 
+#ifdef LCD_ROW_SIMD
+    /* go through the rows, unpack the alpha values of each and blend them
+     * in one go. c1 and c2 follow the cases of the switch further down */
+    unsigned char alpha[LCD_WIDTH];
+    struct lcd_row_src c1 = { NULL, current_vp->bg_pattern, 0 };
+    struct lcd_row_src c2 = { NULL, current_vp->fg_pattern, 0 };
+    unsigned pos = src_y * stride_src + src_x;
+    int row, col;
+
+    /* image without the foreground (BG, COMPLEMENT) draws nothing */
+    if ((drmode & (DRMODE_FG|DRMODE_INT_IMG)) == DRMODE_INT_IMG)
+    {
+        BLEND_FINISH;
+        return;
+    }
+
+    if (drmode == DRMODE_COMPLEMENT)
+        c2.flip = 0xffff;
+
+    image += src_y * stride_image + src_x;
+    for (row = 0; row < height; row++)
+    {
+        dst = dst_row;
+        dst_row += ROW_INC;
+
+        if (!(drmode & DRMODE_BG))
+            c1.p = dst;
+        else if (drmode & DRMODE_INT_BD)
+            c1.p = PTR_ADD(dst, lcd_backdrop_offset);
+        if (!(drmode & DRMODE_FG))
+            c2.p = dst;
+        else if (drmode & DRMODE_INT_IMG)
+            c2.p = image;
+
+        for (col = 0; col < width; col++)
+        {
+            unsigned i = pos + col;
+            alpha[col] = ((src[i / ALPHA_COLOR_PIXEL_PER_BYTE] ^ dmask)
+                            >> ((i % ALPHA_COLOR_PIXEL_PER_BYTE)
+                                * ALPHA_COLOR_LOOKUP_SHIFT))
+                         & ALPHA_COLOR_LOOKUP_SIZE;
+        }
+        lcd_alpha_row(dst, alpha, &c1, &c2, width);
+
+        pos += stride_src;
+        image += stride_image;
+    }
+#else
     int col, row = height;
     unsigned data, pixels;
     unsigned skip_end = (stride_src - width);
@@ -707,7 +979,7 @@ static void ICODE_ATTR lcd_alpha_bitmap_part_mix(const fb_data* image,
             case DRMODE_COMPLEMENT:
                 do
                 {
-                    *dst = blend_two_colors(*dst, ~(*dst),
+                    *dst = blend_two_colors(*dst, (fb_data)~(*dst),
                                 data & ALPHA_COLOR_LOOKUP_SIZE );
                     dst += COL_INC;
                     UPDATE_SRC_ALPHA;
@@ -833,6 +1105,7 @@ static void ICODE_ATTR lcd_alpha_bitmap_part_mix(const fb_data* image,
 
         image += STRIDE_MAIN(stride_image,1);
     } while (--row);
+#endif /* LCD_ROW_SIMD */
 
     BLEND_FINISH;
 }
@@ -118,6 +118,109 @@ void LCDFN(update_viewport_rect)(int x, int y, int width, int height)
     LCDFN(update_rect)(current_vp->x + x, current_vp->y + y, width, height);
 }
 
+/*** Damage tracking ***/
+
+/* Callers that redraw only parts of the screen note what they drew and then
+ * push just that with update_damage(). Overlapping or touching areas are
+ * merged, and when all slots are taken the new area goes into the one that
+ * grows the least. */
+#define DAMAGE_RECTS 8
+
+static struct damage_rect
+{
+    int x1, y1, x2, y2; /* x2/y2 exclusive */
+} LCDFN(damage)[DAMAGE_RECTS];
+static int LCDFN(damage_count);
+
+static inline long LCDFN(damage_area)(const struct damage_rect *r)
+{
+    return (long)(r->x2 - r->x1) * (r->y2 - r->y1);
+}
+
+static inline void LCDFN(damage_union)(struct damage_rect *r,
+                                       const struct damage_rect *s)
+{
+    r->x1 = MIN(r->x1, s->x1);
+    r->y1 = MIN(r->y1, s->y1);
+    r->x2 = MAX(r->x2, s->x2);
+    r->y2 = MAX(r->y2, s->y2);
+}
+
+void LCDFN(damage_viewport_rect)(int x, int y, int width, int height)
+{
+    struct damage_rect r, *d;
+    int i;
+
+    /* clip to the viewport, then make it absolute */
+    r.x1 = MAX(x, 0);
+    r.y1 = MAX(y, 0);
+    r.x2 = MIN(x + width, current_vp->width);
+    r.y2 = MIN(y + height, current_vp->height);
+
+    if (r.x1 >= r.x2 || r.y1 >= r.y2)
+        return;
+
+    r.x1 += current_vp->x;
+    r.x2 += current_vp->x;
+    r.y1 += current_vp->y;
+    r.y2 += current_vp->y;
+
+    /* grow whatever it touches, and keep merging while the grown
+       rectangle touches others */
+    for (i = 0; i < LCDFN(damage_count); i++)
+    {
+        d = &LCDFN(damage)[i];
+        if (r.x1 <= d->x2 && d->x1 <= r.x2 && r.y1 <= d->y2 && d->y1 <= r.y2)
+        {
+            LCDFN(damage_union)(&r, d);
+            *d = LCDFN(damage)[--LCDFN(damage_count)];
+            i = -1;
+        }
+    }
+
+    if (LCDFN(damage_count) < DAMAGE_RECTS)
+    {
+        LCDFN(damage)[LCDFN(damage_count)++] = r;
+        return;
+    }
+
+    /* no slot left */
+    int best = 0;
+    long best_growth = -1;
+    for (i = 0; i < DAMAGE_RECTS; i++)
+    {
+        struct damage_rect u = LCDFN(damage)[i];
+        LCDFN(damage_union)(&u, &r);
+        long growth = LCDFN(damage_area)(&u) -
+                      LCDFN(damage_area)(&LCDFN(damage)[i]);
+        if (best_growth < 0 || growth < best_growth)
+        {
+            best = i;
+            best_growth = growth;
+        }
+    }
+
+    LCDFN(damage_union)(&LCDFN(damage)[best], &r);
+}
+
+/* Update the damaged areas and forget them. Returns the number of pixels
+ * that were pushed. */
+unsigned long LCDFN(update_damage)(void)
+{
+    unsigned long pixels = 0;
+    int i;
+
+    for (i = 0; i < LCDFN(damage_count); i++)
+    {
+        struct damage_rect *d = &LCDFN(damage)[i];
+        LCDFN(update_rect)(d->x1, d->y1, d->x2 - d->x1, d->y2 - d->y1);
+        pixels += LCDFN(damage_area)(d);
+    }
+
+    LCDFN(damage_count) = 0;
+    return pixels;
+}
+
 /* put a string at a given pixel position, skipping first ofs pixel columns */
 static void LCDFN(putsxyofs)(int x, int y, int ofs, const unsigned char *str)
 {
@@ -147,10 +250,37 @@ static void LCDFN(putsxyofs)(int x, int y, int ofs, const unsigned char *str)
         }
     }
 
+    ucs = bidi_l2v(str, 1);
+
+#ifdef HAVE_FONT_STRING_CACHE
+    /* the whole string in one go if it has been drawn before */
+    {
+        int width;
+        const unsigned char *bits = font_get_string_bits(pf, ucs, &width);
+
+        if (bits)
+        {
+            if (ofs < width)
+            {
+#if defined(MAIN_LCD) && defined(HAVE_LCD_COLOR)
+                if (pf->depth)
+                    lcd_alpha_bitmap_part(bits, ofs, 0, width, x, y,
+                                          width - ofs, pf->height);
+                else
+#endif
+                    LCDFN(mono_bitmap_part)(bits, ofs, 0, width, x, y,
+                                            width - ofs, pf->height);
+            }
+            font_lock(current_vp->font, false);
+            return;
+        }
+    }
+#endif
+
     rtl_next_non_diac_width = 0;
     last_non_diacritic_width = 0;
     /* Mark diacritic and rtl flags for each character */
-    for (ucs = bidi_l2v(str, 1); *ucs; ucs++)
+    for (; *ucs; ucs++)
     {
         bool is_rtl, is_diac;
         const unsigned char *bits;
@@ -209,6 +209,7 @@ unsigned long audio_num_recorded_bytes(void);
 #if CONFIG_CODEC == SWCODEC
 /* SWCODEC recording functions */
 unsigned long audio_prerecorded_time(void);
+unsigned long audio_encoder_speed(void);
 #endif /* CONFIG_CODEC == SWCODEC */
 
 #endif /* HAVE_RECORDING */
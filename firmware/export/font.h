@@ -139,6 +139,17 @@ int font_getstringsize(const unsigned char *str, int *w, int *h, int fontnumber)
 int font_get_width(struct font* ft, unsigned short ch);
 const unsigned char * font_get_bits(struct font* ft, unsigned short ch);
 
+#if (MEMORYSIZE >= 8) && !defined(BOOTLOADER) && !defined(__PCTOOL__)
+/* Whole strings rendered in the glyph format, for text that is drawn over
+ * and over (scrolling lines, lists). ucs is in visual order, as returned by
+ * bidi_l2v(). Returns NULL if the string isn't cached (yet), otherwise the
+ * bitmap and its width; the height is the font's. */
+#define HAVE_FONT_STRING_CACHE
+const unsigned char* font_get_string_bits(struct font *pf,
+                                          const unsigned short *ucs,
+                                          int *width);
+#endif
+
 #else /* HAVE_LCD_BITMAP */
 
 #define font_init()
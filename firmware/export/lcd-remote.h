@@ -185,6 +185,8 @@ extern void lcd_remote_update(void);
 extern void lcd_remote_update_rect(int x, int y, int width, int height);
 extern void lcd_remote_update_viewport(void);
 extern void lcd_remote_update_viewport_rect(int x, int y, int width, int height);
+extern void lcd_remote_damage_viewport_rect(int x, int y, int width, int height);
+extern unsigned long lcd_remote_update_damage(void);
 
 extern void lcd_remote_set_invert_display(bool yesno);
 extern void lcd_remote_set_flip(bool yesno);
@@ -218,6 +218,9 @@ extern void lcd_blit_grey_phase(unsigned char *values, unsigned char *phases,
 
 /* update a fraction of the screen */
 extern void lcd_update_rect(int x, int y, int width, int height);
+/* note a part of the current viewport as redrawn / push what was noted */
+extern void lcd_damage_viewport_rect(int x, int y, int width, int height);
+extern unsigned long lcd_update_damage(void);
 
 #ifdef HAVE_REMOTE_LCD
 extern void lcd_remote_update(void);
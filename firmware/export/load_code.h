@@ -59,6 +59,13 @@ extern void *lc_open_from_mem(void* addr, size_t blob_size);
 extern void *lc_get_header(void *handle);
 extern void  lc_close(void *handle);
 
+/* Save the writable data of a freshly opened object, so it can be put back
+ * to that state before the object is used again without reopening it.
+ * lc_state_save() returns NULL where that isn't possible. */
+extern void *lc_state_save(void *handle);
+extern void  lc_state_restore(void *state);
+extern void  lc_state_free(void *state);
+
 #endif
 
 /* this struct needs to be the first part of other headers
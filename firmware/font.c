@@ -162,6 +162,10 @@ static inline unsigned char *buffer_from_handle(int handle)
 /* Font cache structures */
 static void cache_create(struct font* pf);
 static void glyph_cache_load(const char *font_path, struct font *pf);
+#ifdef HAVE_FONT_STRING_CACHE
+static bool string_cache_failed; /* don't retry until the next font load */
+static void string_cache_flush(void);
+#endif
 /* End Font cache structures */
 
 void font_init(void)
@@ -575,6 +579,9 @@ int font_load_ex( const char *path, size_t buf_size, int glyphs )
         }
     }
     buflib_allocations[font_id] = handle;
+#ifdef HAVE_FONT_STRING_CACHE
+    string_cache_failed = false;
+#endif
     //printf("%s -> [%d] -> %d\n", path, font_id, *handle);
     lock_font_handle( handle, false );
     return font_id; /* success!*/
@@ -606,6 +613,10 @@ void font_unload(int font_id)
         if (handle > 0)
             core_free(handle);
         buflib_allocations[font_id] = -1;
+#ifdef HAVE_FONT_STRING_CACHE
+        /* the handle may come back as a different font */
+        string_cache_flush();
+#endif
 
     }
 }
@@ -855,6 +866,213 @@ const unsigned char* font_get_bits(struct font* pf, unsigned short char_code)
     return bits;
 }
 
+#ifdef HAVE_FONT_STRING_CACHE
+/* Rendered strings are packed into one buflib allocation as a ring, each
+ * the UCS-2 text followed by its bitmap; new ones overwrite the oldest. A
+ * string is only rendered the second time it is seen, as text that changes
+ * all the time (a running clock) isn't worth copying. */
+#define STRING_CACHE_SIZE    (MEMORYSIZE >= 32 ? 0x8000 : 0x4000)
+#define STRING_CACHE_ENTRIES 32
+#define STRING_CACHE_SEEN    16
+
+struct string_cache_entry
+{
+    int font_handle;    /* font the string was rendered with */
+    uint32_t hash;      /* of the font and the text */
+    int len;            /* in characters, 0 if unused */
+    int width;          /* in pixels */
+    size_t offset;      /* in the buffer */
+    size_t size;
+};
+
+static struct string_cache_entry string_cache[STRING_CACHE_ENTRIES];
+static uint32_t string_cache_seen[STRING_CACHE_SEEN];
+static int string_cache_handle = -1; /* 0 while being allocated */
+static size_t string_cache_pos;
+static unsigned int string_cache_next, string_cache_next_seen;
+
+static void string_cache_flush(void)
+{
+    memset(string_cache, 0, sizeof(string_cache));
+    string_cache_pos = 0;
+}
+
+static int string_cache_move(int handle, void* current, void* new)
+{
+    /* entries are kept as offsets */
+    (void)handle; (void)current; (void)new;
+    return BUFLIB_CB_OK;
+}
+
+static int string_cache_shrink(int handle, unsigned hints, void* start,
+                               size_t old_size)
+{
+    /* only a cache: give it back entirely */
+    (void)hints; (void)start; (void)old_size;
+    string_cache_flush();
+    core_free(handle);
+    string_cache_handle = -1;
+    string_cache_failed = true;
+    return BUFLIB_CB_OK;
+}
+
+static struct buflib_callbacks string_cache_ops =
+{
+    .move_callback = string_cache_move,
+    .shrink_callback = string_cache_shrink,
+};
+
+/* True if drawing the glyph doesn't need to read the font file */
+static bool glyph_in_ram(struct font *pf, unsigned short char_code)
+{
+    if (pf->fd < 0 || pf == &sysfont)
+        return true;
+
+    if (char_code < pf->firstchar || char_code >= pf->firstchar+pf->size)
+        char_code = pf->defaultchar;
+    char_code -= pf->firstchar;
+
+    return font_cache_get(&pf->cache, char_code, true, NULL, NULL) != NULL;
+}
+
+/* The font must be locked (font_lock()) while the returned bitmap is used */
+const unsigned char* font_get_string_bits(struct font *pf,
+                                          const unsigned short *ucs,
+                                          int *width)
+{
+    const unsigned short *u;
+    uint32_t hash = (2166136261u ^ pf->handle) * 16777619u;
+    struct string_cache_entry *e;
+    unsigned char *buf, *bits;
+    size_t text_size, bits_size, size;
+    int i, len, x, y, w;
+
+    for (u = ucs; *u; u++)
+        hash = (hash ^ *u) * 16777619u;
+    len = u - ucs;
+    text_size = len * sizeof(*ucs);
+    if (len == 0)
+        return NULL;
+
+    if (string_cache_handle > 0)
+    {
+        buf = core_get_data(string_cache_handle);
+        for (i = 0; i < STRING_CACHE_ENTRIES; i++)
+        {
+            e = &string_cache[i];
+            if (e->len == len && e->hash == hash &&
+                e->font_handle == pf->handle &&
+                !memcmp(buf + e->offset, ucs, text_size))
+            {
+                *width = e->width;
+                return buf + e->offset + text_size;
+            }
+        }
+    }
+
+    for (i = 0; i < STRING_CACHE_SEEN; i++)
+        if (string_cache_seen[i] == hash)
+            break;
+    if (i == STRING_CACHE_SEEN)
+    {
+        string_cache_seen[string_cache_next_seen++ % STRING_CACHE_SEEN] = hash;
+        return NULL;
+    }
+
+    /* Loading a glyph from disk yields, so a string with glyphs that aren't
+     * in RAM yet is drawn glyph by glyph (and loads them) one more time.
+     * Diacritics are drawn over their base glyph, always glyph by glyph. */
+    w = 0;
+    for (u = ucs; *u; u++)
+    {
+        if (is_diacritic(*u, NULL) || !glyph_in_ram(pf, *u))
+            return NULL;
+        w += font_get_width(pf, *u);
+    }
+
+    if (pf->depth)
+        bits_size = (w * pf->height + 1) / 2;
+    else
+        bits_size = w * ((pf->height + 7) / 8);
+    size = ALIGN_UP(text_size + bits_size, 4);
+    if (size > STRING_CACHE_SIZE / 4)
+        return NULL;
+
+    if (string_cache_handle <= 0)
+    {
+        if (string_cache_failed || string_cache_handle == 0)
+            return NULL;
+        /* keeps everyone else out should the allocation yield */
+        string_cache_handle = 0;
+        int handle = core_alloc_ex("font strings", STRING_CACHE_SIZE,
+                                   &string_cache_ops);
+        if (handle <= 0)
+        {
+            string_cache_handle = -1;
+            string_cache_failed = true;
+            return NULL;
+        }
+        string_cache_handle = handle;
+        string_cache_flush();
+    }
+
+    /* take the next entry and drop the ones the new string overwrites */
+    if (string_cache_pos + size > STRING_CACHE_SIZE)
+        string_cache_pos = 0;
+    e = &string_cache[string_cache_next++ % STRING_CACHE_ENTRIES];
+    e->len = 0;
+    for (i = 0; i < STRING_CACHE_ENTRIES; i++)
+    {
+        struct string_cache_entry *o = &string_cache[i];
+        if (o->len && o->offset < string_cache_pos + size &&
+            string_cache_pos < o->offset + o->size)
+            o->len = 0;
+    }
+    e->offset = string_cache_pos;
+    e->size = size;
+    string_cache_pos += size;
+
+    buf = core_get_data(string_cache_handle);
+    memcpy(buf + e->offset, ucs, text_size);
+    bits = buf + e->offset + text_size;
+    memset(bits, 0, bits_size);
+
+    for (x = 0, u = ucs; *u; u++)
+    {
+        int gw = font_get_width(pf, *u);
+        const unsigned char *gb = font_get_bits(pf, *u);
+
+        if (pf->depth)
+        {
+            /* 4 bit alpha, rows packed back to back */
+            for (y = 0; y < (int)pf->height; y++)
+            {
+                for (i = 0; i < gw; i++)
+                {
+                    int s = y * gw + i, d = y * w + x + i;
+                    bits[d / 2] |= ((gb[s / 2] >> ((s & 1) * 4)) & 0xf)
+                                        << ((d & 1) * 4);
+                }
+            }
+        }
+        else
+        {
+            /* one byte per column for each 8 pixel rows */
+            for (y = 0; y < (int)(pf->height + 7) / 8; y++)
+                memcpy(bits + y * w + x, gb + y * gw, gw);
+        }
+        x += gw;
+    }
+
+    e->font_handle = pf->handle;
+    e->hash = hash;
+    e->width = w;
+    e->len = len;
+    *width = w;
+    return bits;
+}
+#endif /* HAVE_FONT_STRING_CACHE */
+
 static void font_path_to_glyph_path( const char *font_path, char *glyph_path)
 {
     /* take full file name, cut extension, and add .glyphcache */
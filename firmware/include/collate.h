@@ -0,0 +1,35 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+#ifndef __COLLATE_H__
+#define __COLLATE_H__
+
+#include <stddef.h>
+
+/* flags for collate_key() */
+#define COLLATE_FOLD_CASE   0x01 /* ignore case, like strcasecmp() */
+#define COLLATE_NUMBERS     0x02 /* runs of digits sort by their value */
+#define COLLATE_IGNORE_THE  0x04 /* skip a leading "The " */
+#define COLLATE_REVERSE     0x08 /* sort backwards */
+
+size_t collate_key(char *key, size_t size, const char *str, unsigned flags);
+
+#endif /* __COLLATE_H__ */
@@ -31,14 +31,15 @@ struct font_cache
     struct lru _lru;
     int _size;
     int _capacity;
-    int _prev_char_code;
-    int _prev_result;
-    short *_index; /* index of lru handles in char_code order */
+    int _hash_mask;
+    short _prev_handle; /* last hit, tried before the hash lookup */
+    short *_index; /* hash buckets: first lru handle of each chain */
 };
 
 struct font_cache_entry
 {
     unsigned short _char_code;
+    short _next; /* next lru handle in the same bucket, -1 at the end */
     unsigned char width;
     unsigned char bitmap[1]; /* place holder */
 };
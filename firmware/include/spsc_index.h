@@ -0,0 +1,71 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+#ifndef SPSC_INDEX_H
+#define SPSC_INDEX_H
+
+#include <stddef.h>
+#include "config.h"
+#include "gcc_extensions.h"
+
+/* Ring buffer indexes shared between exactly one producer and one consumer
+ * without a lock.
+ *
+ * Each index is written only by the side that owns it. The owner stores it
+ * with spsc_index_publish() after it's done with the data the index moves
+ * past. The other side reads it with spsc_index_observe() before touching
+ * that data. This gives the release/acquire pairing that keeps slot
+ * contents and index updates in order.
+ *
+ * On hosted builds the two sides may be real OS threads on different cores,
+ * so the accesses are atomic with explicit ordering. Native targets run both
+ * sides on one core (thread vs. interrupt), so keeping the compiler from
+ * reordering is all that's needed. */
+
+#if defined(__PCTOOL__) || (CONFIG_PLATFORM & PLATFORM_HOSTED)
+
+static FORCE_INLINE size_t spsc_index_observe(const size_t *idxp)
+{
+    return __atomic_load_n(idxp, __ATOMIC_ACQUIRE);
+}
+
+static FORCE_INLINE void spsc_index_publish(size_t *idxp, size_t idx)
+{
+    __atomic_store_n(idxp, idx, __ATOMIC_RELEASE);
+}
+
+#else /* native */
+
+static FORCE_INLINE size_t spsc_index_observe(const size_t *idxp)
+{
+    size_t idx = *(const volatile size_t *)idxp;
+    asm volatile ("" : : : "memory");
+    return idx;
+}
+
+static FORCE_INLINE void spsc_index_publish(size_t *idxp, size_t idx)
+{
+    asm volatile ("" : : : "memory");
+    *(volatile size_t *)idxp = idx;
+}
+
+#endif /* hosted */
+
+#endif /* SPSC_INDEX_H */
@@ -68,9 +68,9 @@
 
 #if CONFIG_CODEC == SWCODEC
 # ifdef HAVE_HARDWARE_CLICK
-#  define BASETHREADS  17
+#  define BASETHREADS  18
 # else
-#  define BASETHREADS  16
+#  define BASETHREADS  17
 # endif
 #else
 # define BASETHREADS   11
@@ -184,6 +184,26 @@ fill_frame:
         }
         else
         {
+#ifdef MIXER_HAVE_MIX_SAMPLES_N
+            /* Mix all channels into the downmix in a single pass */
+            const void *src[PCM_MIXER_NUM_CHANNELS];
+            int32_t amp[PCM_MIXER_NUM_CHANNELS];
+            unsigned int count = 0;
+
+            chan_p = active_channels;
+
+            do
+            {
+                chan = *chan_p;
+                chan->last_size = mixsize;
+                src[count] = chan->start;
+                amp[count] = chan->amplitude;
+                count++;
+            }
+            while (*++chan_p);
+
+            mix_samples_n(mixptr, src, amp, count, mixsize);
+#else /* !MIXER_HAVE_MIX_SAMPLES_N */
             const void *src0, *src1;
             unsigned int amp0, amp1;
 
@@ -211,6 +231,7 @@ fill_frame:
                 src1 = chan->start;
                 amp1 = chan->amplitude;
             }
+#endif /* MIXER_HAVE_MIX_SAMPLES_N */
         }
 
         chan->last_size = mixsize;
@@ -0,0 +1,196 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+#define _GNU_SOURCE /* dl_iterate_phdr() */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "load_code.h"
+
+#ifdef __ELF__
+#include <unistd.h>
+#include <link.h>
+
+/* A shared object's writable data is its writable PT_LOAD segments, less
+ * the part that the dynamic linker makes read-only again after relocating
+ * (PT_GNU_RELRO). Each segment holds p_filesz bytes of initialised data,
+ * which are saved as they are after relocation, followed by zero filled
+ * bss up to p_memsz. */
+
+#define LC_STATE_MAX_SEGS 4
+
+struct lc_state
+{
+    int count;
+    struct
+    {
+        unsigned char *addr;
+        size_t data_size;   /* Saved initialised data */
+        size_t bss_size;    /* Zero filled after it */
+        unsigned char *copy;
+    } seg[LC_STATE_MAX_SEGS];
+};
+
+struct lc_state_find
+{
+    const void *addr;   /* Anything inside the object */
+    struct lc_state *state;
+    bool found;
+};
+
+static int find_object(struct dl_phdr_info *info, size_t size, void *data)
+{
+    struct lc_state_find *find = data;
+    uintptr_t addr = (uintptr_t)find->addr;
+    uintptr_t page = sysconf(_SC_PAGESIZE);
+    uintptr_t relro_start = 0, relro_end = 0;
+    bool inside = false;
+
+    (void)size;
+
+    for (int i = 0; i < info->dlpi_phnum; i++)
+    {
+        const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+        uintptr_t start = info->dlpi_addr + ph->p_vaddr;
+
+        if (ph->p_type == PT_LOAD &&
+            addr >= start && addr < start + ph->p_memsz)
+            inside = true;
+
+        /* Rounded the way the dynamic linker protects it */
+        if (ph->p_type == PT_GNU_RELRO)
+        {
+            relro_start = start & ~(page - 1);
+            relro_end = (start + ph->p_memsz) & ~(page - 1);
+        }
+    }
+
+    if (!inside)
+        return 0;
+
+    find->found = true;
+
+    for (int i = 0; i < info->dlpi_phnum; i++)
+    {
+        const ElfW(Phdr) *ph = &info->dlpi_phdr[i];
+        uintptr_t start = info->dlpi_addr + ph->p_vaddr;
+        uintptr_t data_end = start + ph->p_filesz;
+        uintptr_t end = start + ph->p_memsz;
+
+        if (ph->p_type != PT_LOAD || !(ph->p_flags & PF_W))
+            continue;
+
+        /* RELRO sits at the start of the writable segment */
+        if (start >= relro_start && start < relro_end)
+            start = relro_end;
+
+        if (start >= end)
+            continue;
+
+        if (find->state->count >= LC_STATE_MAX_SEGS)
+            return -1;
+
+        if (data_end < start)
+            data_end = start;
+
+        int n = find->state->count++;
+        find->state->seg[n].addr = (unsigned char *)start;
+        find->state->seg[n].data_size = data_end - start;
+        find->state->seg[n].bss_size = end - data_end;
+        find->state->seg[n].copy = malloc(data_end - start + 1);
+
+        if (!find->state->seg[n].copy)
+            return -1;
+
+        memcpy(find->state->seg[n].copy, (void *)start, data_end - start);
+    }
+
+    return 1;
+}
+
+void * lc_state_save(void *handle)
+{
+    struct lc_state *state = calloc(1, sizeof (*state));
+    struct lc_state_find find = { lc_get_header(handle), state, false };
+
+    if (!state || !find.addr)
+    {
+        free(state);
+        return NULL;
+    }
+
+    if (dl_iterate_phdr(find_object, &find) != 1 || !find.found)
+    {
+        lc_state_free(state);
+        return NULL;
+    }
+
+    return state;
+}
+
+void lc_state_restore(void *handle_state)
+{
+    struct lc_state *state = handle_state;
+
+    for (int i = 0; i < state->count; i++)
+    {
+        memcpy(state->seg[i].addr, state->seg[i].copy,
+               state->seg[i].data_size);
+        memset(state->seg[i].addr + state->seg[i].data_size, 0,
+               state->seg[i].bss_size);
+    }
+}
+
+void lc_state_free(void *handle_state)
+{
+    struct lc_state *state = handle_state;
+
+    if (!state)
+        return;
+
+    for (int i = 0; i < state->count; i++)
+        free(state->seg[i].copy);
+
+    free(state);
+}
+
+#else /* !__ELF__ */
+
+/* No way to find the object's data here; callers must not reuse it */
+void * lc_state_save(void *handle)
+{
+    (void)handle;
+    return NULL;
+}
+
+void lc_state_restore(void *handle_state)
+{
+    (void)handle_state;
+}
+
+void lc_state_free(void *handle_state)
+{
+    (void)handle_state;
+}
+
+#endif /* __ELF__ */
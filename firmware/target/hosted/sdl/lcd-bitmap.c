@@ -86,35 +86,97 @@ unsigned long (*lcd_ex_getpixel)(int, int) = NULL;
 #if LCD_DEPTH == 2
 /* Only defined for positive, non-split LCD for now */
 static const unsigned char colorindex[4] = {128, 85, 43, 0};
+#if LCD_PIXELFORMAT == HORIZONTAL_PACKING
+/* the four colour indexes of each framebuffer byte, leftmost first */
+static unsigned char byte_to_index[256][4];
+#endif
+#elif LCD_DEPTH >= 16
+/* what a surface pixel looks like to the CPU */
+#if LCD_DEPTH == 16
+typedef Uint16 surface_pixel;
+#if LCD_PIXELFORMAT == RGB565SWAPPED
+#define FB_TO_SURFACE(fb) ((Uint16)(((fb) >> 8) | ((fb) << 8)))
+#else
+#define FB_TO_SURFACE(fb) (fb)
+#endif
+#elif LCD_DEPTH == 24
+/* a 24 bit surface keeps {b,g,r} in memory on little endian hosts */
+typedef fb_data surface_pixel;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define FB_TO_SURFACE(fb) (fb)
+#else
+#define FB_TO_SURFACE(fb) FB_RGBPACK((fb).b, (fb).g, (fb).r)
+#endif
+#else
+typedef Uint32 surface_pixel;
+#define FB_TO_SURFACE(fb) ((Uint32)FB_UNPACK_SCALAR_LCD(fb))
 #endif
+#endif /* LCD_DEPTH */
 
-static unsigned long get_lcd_pixel(int x, int y)
+/* Convert a rectangle of the framebuffer to lcd_surface pixels, colour
+ * indexes for greyscale and mono */
+static void get_lcd_rect(int x, int y, int width, int height,
+                         void *dst, int pitch)
 {
+    unsigned char *row = dst;
+    int i;
+
+#if defined(LCD_STRIDEFORMAT) && LCD_STRIDEFORMAT == VERTICAL_STRIDE
+    /* the framebuffer is column major, so transpose it in strips of eight
+       columns, to read eight runs and write one at a time */
+    int strip;
+    for (strip = 0; strip < width; strip += 8)
+    {
+        int n = MIN(8, width - strip);
+        int yy;
+        for (yy = 0; yy < height; yy++)
+        {
+            surface_pixel *d = (surface_pixel *)(row + yy * pitch) + strip;
+            const fb_data *s = FBADDR(x + strip, y + yy);
+            for (i = 0; i < n; i++)
+                d[i] = FB_TO_SURFACE(s[i * LCD_FBHEIGHT]);
+        }
+    }
+#else
+    for (; height > 0; height--, y++, row += pitch)
+    {
 #if LCD_DEPTH == 1
+        const fb_data *s = FBADDR(x, y/8);
+        unsigned mask = 1 << (y & 7);
+        for (i = 0; i < width; i++)
 #ifdef HAVE_NEGATIVE_LCD
-    return (*FBADDR(x, y/8) & (1 << (y & 7))) ? (NUM_SHADES-1) : 0;
+            row[i] = (s[i] & mask) ? (NUM_SHADES-1) : 0;
 #else
-    return (*FBADDR(x, y/8) & (1 << (y & 7))) ? 0 : (NUM_SHADES-1);
+            row[i] = (s[i] & mask) ? 0 : (NUM_SHADES-1);
 #endif
 #elif LCD_DEPTH == 2
 #if LCD_PIXELFORMAT == HORIZONTAL_PACKING
-    return colorindex[(*FBADDR(x/4, y) >> (2 * (~x & 3))) & 3];
+        for (i = 0; i < width; i++)
+            row[i] = byte_to_index[*FBADDR((x + i)/4, y)][(x + i) & 3];
 #elif LCD_PIXELFORMAT == VERTICAL_PACKING
-    return colorindex[(*FBADDR(x, y/4) >> (2 * (y & 3))) & 3];
+        const fb_data *s = FBADDR(x, y/4);
+        int shift = 2 * (y & 3);
+        for (i = 0; i < width; i++)
+            row[i] = colorindex[(s[i] >> shift) & 3];
 #elif LCD_PIXELFORMAT == VERTICAL_INTERLEAVED
-    unsigned bits = (*FBADDR(x, y/8) >> (y & 7)) & 0x0101;
-    return colorindex[(bits | (bits >> 7)) & 3];
-#endif
-#elif LCD_DEPTH == 16
-#if LCD_PIXELFORMAT == RGB565SWAPPED
-    unsigned bits = *FBADDR(x, y);
-    return (bits >> 8) | (bits << 8);
-#else
-    return *FBADDR(x, y);
-#endif
-#elif LCD_DEPTH >= 24
-    return FB_UNPACK_SCALAR_LCD(*FBADDR(x, y));
+        const fb_data *s = FBADDR(x, y/8);
+        int shift = y & 7;
+        for (i = 0; i < width; i++)
+        {
+            unsigned bits = (s[i] >> shift) & 0x0101;
+            row[i] = colorindex[(bits | (bits >> 7)) & 3];
+        }
 #endif
+#else /* LCD_DEPTH >= 16 */
+        /* plain copies where the layouts match, compiled to memcpy or a
+           vectorised loop otherwise */
+        surface_pixel *d = (surface_pixel *)row;
+        const fb_data *s = FBADDR(x, y);
+        for (i = 0; i < width; i++)
+            d[i] = FB_TO_SURFACE(s[i]);
+#endif /* LCD_DEPTH */
+    }
+#endif /* LCD_STRIDEFORMAT */
 }
 
 void lcd_update(void)
@@ -135,8 +197,8 @@ void lcd_update_rect(int x_start, int y_start, int width, int height)
         return;
 #endif
 
-    sdl_update_rect(lcd_surface, x_start, y_start, width, height,
-                    LCD_WIDTH, LCD_HEIGHT, get_lcd_pixel);
+    sdl_convert_rect(lcd_surface, x_start, y_start, width, height,
+                     LCD_WIDTH, LCD_HEIGHT, get_lcd_rect);
     sdl_gui_update(lcd_surface, x_start, y_start, width,
                    height + LCD_SPLIT_LINES, SIM_LCD_WIDTH, SIM_LCD_HEIGHT,
                    background ? UI_LCD_POSX : 0, background? UI_LCD_POSY : 0);
@@ -192,6 +254,12 @@ void lcd_init_device(void)
                                        SIM_LCD_WIDTH * display_zoom,
                                        SIM_LCD_HEIGHT * display_zoom,
                                        8, 0, 0, 0, 0);
+#if LCD_DEPTH == 2 && LCD_PIXELFORMAT == HORIZONTAL_PACKING
+    int b, i;
+    for (b = 0; b < 256; b++)
+        for (i = 0; i < 4; i++)
+            byte_to_index[b][i] = colorindex[(b >> (2 * (3 - i))) & 3];
+#endif
 
 #ifdef HAVE_BACKLIGHT
     sdl_set_gradient(lcd_surface, &lcd_bl_color_dark,
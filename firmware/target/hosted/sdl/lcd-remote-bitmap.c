@@ -47,16 +47,31 @@ SDL_Color remote_color_bright  = {RED_CMP(LCD_REMOTE_BRIGHTCOLOR),
 static const unsigned char colorindex[4] = {128, 85, 43, 0};
 #endif
 
-static unsigned long get_lcd_remote_pixel(int x, int y)
+/* Convert a rectangle of the remote framebuffer to colour indexes */
+static void get_lcd_remote_rect(int x, int y, int width, int height,
+                                void *dst, int pitch)
 {
+    unsigned char *row = dst;
+    int i;
+
+    for (; height > 0; height--, y++, row += pitch)
+    {
+        const fb_remote_data *s = FBREMOTEADDR(x, y/8);
 #if LCD_REMOTE_DEPTH == 1
-    return *FBREMOTEADDR(x, y/8) & (1 << (y & 7)) ? 0 : (NUM_SHADES-1);
+        unsigned mask = 1 << (y & 7);
+        for (i = 0; i < width; i++)
+            row[i] = (s[i] & mask) ? 0 : (NUM_SHADES-1);
 #elif LCD_REMOTE_DEPTH == 2
 #if LCD_REMOTE_PIXELFORMAT == VERTICAL_INTERLEAVED
-    unsigned bits = (*FBREMOTEADDR(x, y/8) >> (y & 7)) & 0x0101;
-    return colorindex[(bits | (bits >> 7)) & 3];
+        int shift = y & 7;
+        for (i = 0; i < width; i++)
+        {
+            unsigned bits = (s[i] >> shift) & 0x0101;
+            row[i] = colorindex[(bits | (bits >> 7)) & 3];
+        }
 #endif
 #endif
+    }
 }
 
 void lcd_remote_update (void)
@@ -68,8 +83,8 @@ void lcd_remote_update_rect(int x_start, int y_start, int width, int height)
 {
     if (remote_surface)
     {
-        sdl_update_rect(remote_surface, x_start, y_start, width, height,
-            LCD_REMOTE_WIDTH, LCD_REMOTE_HEIGHT, get_lcd_remote_pixel);
+        sdl_convert_rect(remote_surface, x_start, y_start, width, height,
+            LCD_REMOTE_WIDTH, LCD_REMOTE_HEIGHT, get_lcd_remote_rect);
         sdl_gui_update(remote_surface, x_start, y_start, width, height,
             LCD_REMOTE_WIDTH, LCD_REMOTE_HEIGHT, background ? UI_REMOTE_POSX : 0,
             background ? UI_REMOTE_POSY : LCD_HEIGHT);
@@ -19,6 +19,8 @@
  *
  ****************************************************************************/
 
+#include <stdlib.h>
+#include <string.h>
 #include <SDL.h>
 #include "lcd-sdl.h"
 #include "sim-ui-defines.h"
@@ -26,79 +28,190 @@
 
 double display_zoom = 1;
 
-void sdl_update_rect(SDL_Surface *surface, int x_start, int y_start, int width,
-                     int height, int max_x, int max_y,
-                     unsigned long (*getpixel)(int, int))
+/* Scratch space for one converted row when zooming */
+static Uint8 *zoom_row = NULL;
+static size_t zoom_row_size = 0;
+
+/* count copies of the bpp byte pixel at src */
+static void put_pixels(Uint8 *dst, const Uint8 *src, int bpp, int count)
 {
-    SDL_Rect dest;
-#if LCD_DEPTH >= 8 && (LCD_PIXELFORMAT == RGB565) \
-    && !defined(LCD_STRIDEFORMAT) && !defined(HAVE_LCD_SPLIT) \
-    && !defined(HAVE_REMOTE_LCD)
-    SDL_Rect src;
-    (void)max_x;
-    (void)max_y;
-    (void)getpixel;
-    /* Update complete screen via one blit operation (fast) */
-    SDL_Surface *lcd = SDL_CreateRGBSurfaceFrom(lcd_framebuffer, LCD_FBWIDTH,
-                                                LCD_FBHEIGHT, LCD_DEPTH,
-                                                LCD_FBWIDTH * LCD_DEPTH/8,
-                                                0, 0, 0, 0);
-    src.x = x_start;
-    src.y = y_start;
-    src.w = width;
-    src.h = height;
-
-    if (display_zoom == 1) {
-        dest = src;
-        SDL_BlitSurface(lcd, &src, surface, &dest);
-    } else {
-        /* Note: SDL_SoftStretch is currently marked as DO NOT USE
-           but there are no real alternatives for efficent zooming. */
-        dest.x = src.x * display_zoom;
-        dest.y = src.y * display_zoom;
-        dest.w = src.w * display_zoom;
-        dest.h = src.h * display_zoom;
-        SDL_SoftStretch(lcd, &src, surface, &dest);
+    switch (bpp)
+    {
+        case 1:
+            memset(dst, *src, count);
+            break;
+        case 2:
+        {
+            Uint16 *d = (Uint16 *)dst, p = *(const Uint16 *)src;
+            while (count--)
+                *d++ = p;
+            break;
+        }
+        case 4:
+        {
+            Uint32 *d = (Uint32 *)dst, p = *(const Uint32 *)src;
+            while (count--)
+                *d++ = p;
+            break;
+        }
+        default:
+            while (count--)
+            {
+                memcpy(dst, src, bpp);
+                dst += bpp;
+            }
+            break;
     }
-    SDL_FreeSurface(lcd);
-#else
-    int x, y;
-    int xmax, ymax;
-    /* Very slow pixel-by-pixel drawing */
-    ymax = y_start + height;
-    xmax = x_start + width;
+}
 
-    if(xmax > max_x)
-        xmax = max_x;
-    if(ymax >= max_y)
-        ymax = max_y;
+/* Convert lcd rows y to y + height - 1 straight into the surface, scaling
+ * them by display_zoom on the way. dest_y is the row they are shown at and
+ * or_mask is or'ed into every converted pixel of paletted surfaces. */
+static void blit_rows(SDL_Surface *surface, int x, int y, int width,
+                      int height, int dest_y, Uint8 or_mask,
+                      sdl_convert_fn *convert)
+{
+    int bpp = surface->format->BytesPerPixel;
+    int pitch = surface->pitch;
+    Uint8 *pixels = surface->pixels;
+    int i;
 
-    dest.w = display_zoom;
-    dest.h = display_zoom;
+    if (width <= 0 || height <= 0)
+        return;
+    if (bpp != 1)
+        or_mask = 0;
 
-    for (x = x_start; x < xmax; x++) {
-        dest.x = x * display_zoom;
+    if (display_zoom == 1)
+    {
+        Uint8 *dst = pixels + dest_y * pitch + x * bpp;
+        convert(x, y, width, height, dst, pitch);
+        if (or_mask)
+        {
+            for (; height > 0; height--, dst += pitch)
+                for (i = 0; i < width; i++)
+                    dst[i] |= or_mask;
+        }
+        return;
+    }
 
-#ifdef HAVE_LCD_SPLIT
-        for (y = y_start; y < MIN(ymax, LCD_SPLIT_POS); y++) {
-            dest.y = y * display_zoom;
+    if (zoom_row_size < (size_t)(width * bpp))
+    {
+        free(zoom_row);
+        zoom_row_size = width * bpp;
+        zoom_row = malloc(zoom_row_size);
+        if (!zoom_row)
+        {
+            zoom_row_size = 0;
+            return;
+        }
+    }
+
+    /* each lcd pixel covers the surface pixels from x * zoom up to, but not
+       including, (x + 1) * zoom, which works for any zoom factor */
+    int dx_start = x * display_zoom;
+    int dx_end = MIN((int)((x + width) * display_zoom), surface->w);
+    for (; height > 0; height--, y++, dest_y++)
+    {
+        int dy_start = dest_y * display_zoom;
+        int dy_end = MIN((int)((dest_y + 1) * display_zoom), surface->h);
+        Uint8 *dst = pixels + dy_start * pitch;
+        if (dy_start >= dy_end)
+            continue;
 
-            SDL_FillRect(surface, &dest, (Uint32)(getpixel(x, y) | 0x80));
+        convert(x, y, width, 1, zoom_row, 0);
+        if (or_mask)
+        {
+            for (i = 0; i < width; i++)
+                zoom_row[i] |= or_mask;
         }
-        for (y = MAX(y_start, LCD_SPLIT_POS); y < ymax; y++) {
-            dest.y = (y + LCD_SPLIT_LINES) * display_zoom ;
 
-            SDL_FillRect(surface, &dest, (Uint32)getpixel(x, y));
+        for (i = 0; i < width; i++)
+        {
+            int dx0 = (x + i) * display_zoom;
+            int dx1 = MIN((int)((x + i + 1) * display_zoom), dx_end);
+            if (dx1 > dx0)
+                put_pixels(dst + dx0 * bpp, zoom_row + i * bpp, bpp, dx1 - dx0);
         }
+        for (dy_start++; dy_start < dy_end; dy_start++)
+            memcpy(pixels + dy_start * pitch + dx_start * bpp,
+                   dst + dx_start * bpp, (dx_end - dx_start) * bpp);
+    }
+}
+
+void sdl_convert_rect(SDL_Surface *surface, int x_start, int y_start,
+                      int width, int height, int max_x, int max_y,
+                      sdl_convert_fn *convert)
+{
+    int xmax = MIN(x_start + width, max_x);
+    int ymax = MIN(y_start + height, max_y);
+
+    if (x_start < 0)
+        x_start = 0;
+    if (y_start < 0)
+        y_start = 0;
+    if (x_start >= xmax || y_start >= ymax)
+        return;
+
+    if (SDL_MUSTLOCK(surface) && SDL_LockSurface(surface) < 0)
+        return;
+
+#ifdef HAVE_LCD_SPLIT
+    int split = MIN(ymax, LCD_SPLIT_POS);
+    blit_rows(surface, x_start, y_start, xmax - x_start, split - y_start,
+              y_start, 0x80, convert);
+    split = MAX(y_start, LCD_SPLIT_POS);
+    blit_rows(surface, x_start, split, xmax - x_start, ymax - split,
+              split + LCD_SPLIT_LINES, 0, convert);
 #else
-        for (y = y_start; y < ymax; y++) {
-            dest.y = y * display_zoom;
+    blit_rows(surface, x_start, y_start, xmax - x_start, ymax - y_start,
+              y_start, 0, convert);
+#endif
 
-            SDL_FillRect(surface, &dest, (Uint32)getpixel(x, y));
-        }
+    if (SDL_MUSTLOCK(surface))
+        SDL_UnlockSurface(surface);
+}
+
+/* sdl_update_rect() in terms of sdl_convert_rect() */
+static unsigned long (*pixel_getpixel)(int, int);
+static int pixel_bpp;
+
+static void convert_getpixel(int x, int y, int width, int height,
+                             void *dst, int pitch)
+{
+    Uint8 *row = dst;
+    int i;
+
+    for (; height > 0; height--, y++, row += pitch)
+    {
+        Uint8 *d = row;
+        for (i = 0; i < width; i++, d += pixel_bpp)
+        {
+            Uint32 p = pixel_getpixel(x + i, y);
+            switch (pixel_bpp)
+            {
+                case 1: *d = p; break;
+                case 2: *(Uint16 *)d = p; break;
+                case 4: *(Uint32 *)d = p; break;
+                default:
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+                    d[0] = p; d[1] = p >> 8; d[2] = p >> 16;
+#else
+                    d[0] = p >> 16; d[1] = p >> 8; d[2] = p;
 #endif
+                    break;
+            }
+        }
     }
-#endif
+}
+
+void sdl_update_rect(SDL_Surface *surface, int x_start, int y_start, int width,
+                     int height, int max_x, int max_y,
+                     unsigned long (*getpixel)(int, int))
+{
+    pixel_getpixel = getpixel;
+    pixel_bpp = surface->format->BytesPerPixel;
+    sdl_convert_rect(surface, x_start, y_start, width, height, max_x, max_y,
+                     convert_getpixel);
 }
 
 void sdl_gui_update(SDL_Surface *surface, int x_start, int y_start, int width,
@@ -28,6 +28,16 @@
 /* Default display zoom level */
 extern SDL_Surface *gui_surface;
 
+/* Converts the lcd pixels in the given rectangle to the pixel format of the
+ * surface showing them, writing one row every pitch bytes to dst */
+typedef void sdl_convert_fn(int x, int y, int width, int height,
+                            void *dst, int pitch);
+
+void sdl_convert_rect(SDL_Surface *surface, int x_start, int y_start,
+                      int width, int height, int max_x, int max_y,
+                      sdl_convert_fn *convert);
+
+/* Same, but asking for one pixel value at a time */
 void sdl_update_rect(SDL_Surface *surface, int x_start, int y_start, int width,
                      int height, int max_x, int max_y,
                      unsigned long (*getpixel)(int, int));
@@ -0,0 +1,223 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/* Checks the host's pcm mixer kernels against a plain C model and times
+ * write_samples(), mix_samples() and, where available, mix_samples_n() */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "gcc_extensions.h"
+
+/* Normally from pcm_mixer.h, which needs the full target config */
+#define MIX_AMP_UNITY          0x00010000
+#define PCM_MIXER_NUM_CHANNELS 3
+
+#include "asm/pcm-mixer.c"
+
+#define FRAME_SAMPLES   256 /* Stereo samples, as MIX_FRAME_SAMPLES */
+#define FRAME_SIZE      (FRAME_SAMPLES*4)
+#define BENCH_FRAMES    200000
+
+/* Keep the compiler from hoisting or dropping the benchmarked calls */
+#define BENCH_BARRIER() asm volatile ("" : : : "memory")
+
+static int16_t src_buf[PCM_MIXER_NUM_CHANNELS][FRAME_SAMPLES*2 + 2];
+static int16_t out_buf[FRAME_SAMPLES*2 + 2];
+static int16_t ref_buf[FRAME_SAMPLES*2 + 2];
+
+static const int32_t test_amps[] =
+    { MIX_AMP_UNITY, 0xffff, 0x8000, 0x4001, 0x0001, 0x0000 };
+#define NUM_AMPS (sizeof (test_amps) / sizeof (test_amps[0]))
+
+static int failures = 0;
+
+static int32_t ref_clip(int32_t s)
+{
+    return s > INT16_MAX ? INT16_MAX : (s < INT16_MIN ? INT16_MIN : s);
+}
+
+static void fill_sources(unsigned int seed)
+{
+    srand(seed);
+
+    for (int c = 0; c < PCM_MIXER_NUM_CHANNELS; c++)
+    {
+        for (int i = 0; i < FRAME_SAMPLES*2 + 2; i++)
+        {
+            /* Bias towards the rails so clipping is exercised */
+            int r = rand();
+            src_buf[c][i] = (r & 3) == 0 ? ((r & 4) ? INT16_MAX : INT16_MIN)
+                                         : (int16_t)(r >> 3);
+        }
+    }
+}
+
+static void check(const char *what, size_t size, int32_t a0, int32_t a1)
+{
+    if (memcmp(out_buf, ref_buf, size) != 0)
+    {
+        printf("FAIL: %s size=%zu amp=%05x/%05x\n", what, size,
+               (unsigned)a0, (unsigned)a1);
+        failures++;
+    }
+}
+
+static void verify(void)
+{
+    /* Odd sample counts and unaligned sources hit the scalar tails */
+    static const size_t sizes[] = { 4, 12, 28, 32, 36, 60, FRAME_SIZE };
+
+    for (unsigned int seed = 1; seed <= 8; seed++)
+    {
+        fill_sources(seed);
+
+        for (size_t z = 0; z < sizeof (sizes) / sizeof (sizes[0]); z++)
+        {
+            size_t size = sizes[z];
+            size_t n = size / sizeof (int16_t);
+            int off = seed & 1; /* 2-byte misalignment */
+
+            for (size_t a = 0; a < NUM_AMPS; a++)
+            {
+                int32_t a0 = test_amps[a];
+
+                for (size_t i = 0; i < n; i++)
+                    ref_buf[i] = src_buf[0][i + off] * a0 >> 16;
+
+                write_samples(out_buf, src_buf[0] + off, a0, size);
+                check("write_samples", size, a0, 0);
+
+                for (size_t b = 0; b < NUM_AMPS; b++)
+                {
+                    int32_t a1 = test_amps[b];
+
+                    for (size_t i = 0; i < n; i++)
+                        ref_buf[i] = ref_clip((src_buf[0][i + off] * a0 >> 16) +
+                                              (src_buf[1][i] * a1 >> 16));
+
+                    mix_samples(out_buf, src_buf[0] + off, a0,
+                                src_buf[1], a1, size);
+                    check("mix_samples", size, a0, a1);
+
+#ifdef MIXER_HAVE_MIX_SAMPLES_N
+                    const void *src[3] =
+                        { src_buf[0] + off, src_buf[1], src_buf[2] + off };
+                    const int32_t amp[3] =
+                        { a0, a1, test_amps[(a + b) % NUM_AMPS] };
+
+                    for (size_t i = 0; i < n; i++)
+                        ref_buf[i] = ref_clip((src_buf[0][i + off] * a0 >> 16) +
+                                              (src_buf[1][i] * a1 >> 16) +
+                                              (src_buf[2][i + off] * amp[2] >> 16));
+
+                    mix_samples_n(out_buf, src, amp, 3, size);
+                    check("mix_samples_n", size, a0, a1);
+
+                    for (size_t i = 0; i < n; i++)
+                        ref_buf[i] = ref_clip((src_buf[0][i + off] * a0 >> 16) +
+                                              (src_buf[1][i] * a1 >> 16));
+
+                    mix_samples_n(out_buf, src, amp, 2, size);
+                    check("mix_samples_n (2)", size, a0, a1);
+#endif
+                }
+            }
+        }
+    }
+}
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void report(const char *what, double t)
+{
+    printf("%-28s %8.1f Msamples/s\n", what,
+           (double)BENCH_FRAMES * FRAME_SAMPLES / t / 1e6);
+}
+
+static void bench(void)
+{
+    double t;
+
+    t = now();
+    for (int i = 0; i < BENCH_FRAMES; i++)
+    {
+        write_samples(out_buf, src_buf[0], 0x8000, FRAME_SIZE);
+        BENCH_BARRIER();
+    }
+    report("write_samples (cut)", now() - t);
+
+    t = now();
+    for (int i = 0; i < BENCH_FRAMES; i++)
+    {
+        mix_samples(out_buf, src_buf[0], MIX_AMP_UNITY,
+                    src_buf[1], 0x8000, FRAME_SIZE);
+        BENCH_BARRIER();
+    }
+    report("mix_samples (2 ch)", now() - t);
+
+    t = now();
+    for (int i = 0; i < BENCH_FRAMES; i++)
+    {
+        /* What pcm_mixer does for three channels without mix_samples_n() */
+        mix_samples(out_buf, src_buf[0], MIX_AMP_UNITY,
+                    src_buf[1], 0x8000, FRAME_SIZE);
+        mix_samples(out_buf, out_buf, MIX_AMP_UNITY,
+                    src_buf[2], 0x4000, FRAME_SIZE);
+        BENCH_BARRIER();
+    }
+    report("mix_samples x2 (3 ch)", now() - t);
+
+#ifdef MIXER_HAVE_MIX_SAMPLES_N
+    const void *src[3] = { src_buf[0], src_buf[1], src_buf[2] };
+    const int32_t amp[3] = { MIX_AMP_UNITY, 0x8000, 0x4000 };
+
+    t = now();
+    for (int i = 0; i < BENCH_FRAMES; i++)
+    {
+        mix_samples_n(out_buf, src, amp, 3, FRAME_SIZE);
+        BENCH_BARRIER();
+    }
+    report("mix_samples_n (3 ch)", now() - t);
+#endif
+}
+
+int main(void)
+{
+    verify();
+
+    if (failures)
+    {
+        printf("%d mismatches\n", failures);
+        return 1;
+    }
+
+    printf("All kernels match the C model\n");
+    bench();
+    return 0;
+}
@@ -0,0 +1,31 @@
+/***************************************************************************
+*             __________               __   ___.
+*   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+*   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+*   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+*   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+*                     \/            \/     \/    \/            \/
+* $Id$
+*
+* This program is free software; you can redistribute it and/or
+* modify it under the terms of the GNU General Public License
+* as published by the Free Software Foundation; either version 2
+* of the License, or (at your option) any later version.
+*
+* This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+* KIND, either express or implied.
+*
+****************************************************************************/
+
+#ifndef _COMMON_UNITTEST_H
+#define _COMMON_UNITTEST_H
+
+/* logf is provided by logf.h; pcmbuf.c has no use for debugf */
+#ifndef panicf
+#define panicf(...) do { fprintf(stderr, __VA_ARGS__); \
+                         putc('\n', stderr);           \
+                         exit(-1);                     \
+                  } while (0)
+#endif
+
+#endif /* _COMMON_UNITTEST_H */
@@ -0,0 +1,348 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/* Stress test for the lock-free pcmbuf ring: the real apps/pcmbuf.c is built
+ * in here with the mixer and playback hooks stubbed out. A producer thread
+ * plays codec, writing numbered frames and gapless track changes, while a
+ * consumer thread plays mixer, calling the PCM callback the way the DMA
+ * interrupt would and checking every frame, position stamp and track change
+ * it's handed. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* Keep the playback side headers out; pcmbuf.c only needs a few of their
+   declarations, which are supplied below */
+#define __SETTINGS_H__
+#define _PLAYBACK_H
+#define _CODEC_THREAD_H
+#define VOICE_THREAD_H
+
+#include "pcmbuf.c"
+
+#define NUM_TRACKS      300
+#define ARENA_SIZE      (1024*1024)
+
+/* Frame n of the stream holds n split over its two channels */
+#define FRAME_L(n)      ((int16_t)((n) & 0xffff))
+#define FRAME_R(n)      ((int16_t)((n) >> 16))
+
+static unsigned char arena[ARENA_SIZE] __attribute__((aligned(16)));
+
+static pthread_mutex_t pcm_mutex;
+static volatile int channel_status = CHANNEL_STOPPED;
+static pcm_play_callback_type channel_cb;
+static volatile bool producer_done;
+
+/* Consumer side bookkeeping */
+static unsigned long tracks_seen;
+static bool pos_pending;
+static unsigned long pos_elapsed;
+static off_t pos_offset;
+static unsigned long errors;
+
+/* Track start frames, for checking the position stamps */
+static uint32_t track_start[NUM_TRACKS + 1];
+
+
+/** Stubs for what pcmbuf.c calls out to **/
+
+void pcm_play_lock(void)
+{
+    pthread_mutex_lock(&pcm_mutex);
+}
+
+void pcm_play_unlock(void)
+{
+    pthread_mutex_unlock(&pcm_mutex);
+}
+
+enum channel_status mixer_channel_status(enum pcm_mixer_channel channel)
+{
+    (void)channel;
+    return __atomic_load_n(&channel_status, __ATOMIC_SEQ_CST);
+}
+
+void mixer_channel_play_data(enum pcm_mixer_channel channel,
+                             pcm_play_callback_type get_more,
+                             const void *start, size_t size)
+{
+    (void)channel; (void)start; (void)size;
+    channel_cb = get_more;
+    __atomic_store_n(&channel_status, CHANNEL_PLAYING, __ATOMIC_SEQ_CST);
+}
+
+void mixer_channel_play_pause(enum pcm_mixer_channel channel, bool play)
+{
+    (void)channel; (void)play;
+}
+
+void mixer_channel_stop(enum pcm_mixer_channel channel)
+{
+    (void)channel;
+    pcm_play_lock();
+    __atomic_store_n(&channel_status, CHANNEL_STOPPED, __ATOMIC_SEQ_CST);
+    pcm_play_unlock();
+}
+
+void mixer_channel_set_amplitude(enum pcm_mixer_channel channel,
+                                 unsigned int amplitude)
+{
+    (void)channel; (void)amplitude;
+}
+
+unsigned int mixer_get_frequency(void)
+{
+    return 44100;
+}
+
+int tick_add_task(void (*f)(void))
+{
+    (void)f;
+    return 0;
+}
+
+int tick_remove_task(void (*f)(void))
+{
+    (void)f;
+    return 0;
+}
+
+bool audio_pcmbuf_may_play(void)
+{
+    return true;
+}
+
+void audio_pcmbuf_sync_position(void)
+{
+}
+
+void audio_pcmbuf_position_callback(unsigned long elapsed, off_t offset,
+                                    unsigned int key)
+{
+    (void)key;
+    pos_pending = true;
+    pos_elapsed = elapsed;
+    pos_offset = offset;
+}
+
+void audio_pcmbuf_track_change(bool pcmbuf)
+{
+    /* Either played out of the buffer by the callback or posted by the
+       producer because the buffer had already run dry; both happen under
+       the PCM lock so the count isn't racy */
+    (void)pcmbuf;
+    __atomic_add_fetch(&tracks_seen, 1, __ATOMIC_SEQ_CST);
+}
+
+
+/** Codec side **/
+
+static void * producer(void *arg)
+{
+    (void)arg;
+    uint32_t frame = 0;
+
+    srand(1);
+
+    for (int track = 0; track < NUM_TRACKS; track++)
+    {
+        /* Mix of short tracks, which leave partial chunks and sometimes
+           drain the buffer, with ones long enough to wrap it */
+        uint32_t len = (rand() % 4) ? rand() % 200000 : rand() % 3000;
+        uint32_t end = frame + len;
+
+        track_start[track] = frame;
+
+        while (frame < end)
+        {
+            int want = 1 + rand() % 4096;
+            int count = want;
+            int16_t *buf = pcmbuf_request_buffer(&count);
+
+            if (!buf)
+            {
+                sched_yield();
+                continue;
+            }
+
+            if (count > want)
+                count = want;
+
+            if ((uint32_t)count > end - frame)
+                count = end - frame;
+
+            for (int i = 0; i < count; i++)
+            {
+                buf[2*i + 0] = FRAME_L(frame + i);
+                buf[2*i + 1] = FRAME_R(frame + i);
+            }
+
+            pcmbuf_write_complete(count, frame, track);
+            frame += count;
+        }
+
+        /* Like playback.c, hold off the next transition until the last one
+           has been played out since pcmbuf marks one at a time */
+        if (__atomic_load_n(&tracks_seen, __ATOMIC_SEQ_CST) < (unsigned)track)
+        {
+            pcmbuf_start_track_change(TRACK_CHANGE_AUTO_PILEUP);
+
+            while (__atomic_load_n(&tracks_seen, __ATOMIC_SEQ_CST) <
+                   (unsigned)track)
+                sched_yield();
+        }
+
+        pcmbuf_start_track_change(track < NUM_TRACKS - 1 ?
+                                  TRACK_CHANGE_AUTO : TRACK_CHANGE_END_OF_DATA);
+    }
+
+    track_start[NUM_TRACKS] = frame;
+
+    /* Wait for it to play out, end of data counting as a track change */
+    while (pcmbuf_unplayed_bytes() != 0)
+    {
+        pcmbuf_play_start();
+        sched_yield();
+    }
+
+    __atomic_store_n(&producer_done, true, __ATOMIC_SEQ_CST);
+    return NULL;
+}
+
+
+/** Mixer side **/
+
+static void check_chunk(const int16_t *p, size_t size, uint32_t *frame,
+                        unsigned long track)
+{
+    if (size == 0 || size > PCMBUF_CHUNK_SIZE || size % PCMBUF_SAMPLE_SIZE)
+    {
+        printf("bad chunk size %zu at frame %u\n", size, *frame);
+        errors++;
+        return;
+    }
+
+    uint32_t first = *frame;
+    size_t count = size / PCMBUF_SAMPLE_SIZE;
+
+    for (size_t i = 0; i < count; i++, (*frame)++)
+    {
+        if (p[2*i + 0] != FRAME_L(*frame) || p[2*i + 1] != FRAME_R(*frame))
+        {
+            printf("data mismatch at frame %u\n", *frame);
+            errors++;
+            *frame = (uint16_t)p[2*i + 0] | ((uint32_t)p[2*i + 1] << 16);
+            break;
+        }
+    }
+
+    if (pos_pending)
+    {
+        /* The stamp is the first frame of the first write that went into
+           this chunk, and the chunk's data is all from one track */
+        pos_pending = false;
+
+        if (pos_elapsed < first || pos_elapsed >= first + count ||
+            pos_offset != (off_t)track)
+        {
+            printf("bad stamp %lu/%ld for frames %u..%zu of track %lu\n",
+                   pos_elapsed, (long)pos_offset, first, first + count - 1,
+                   track);
+            errors++;
+        }
+    }
+}
+
+static void * consumer(void *arg)
+{
+    (void)arg;
+    uint32_t frame = 0;
+
+    while (!__atomic_load_n(&producer_done, __ATOMIC_SEQ_CST))
+    {
+        if (mixer_channel_status(PCM_MIXER_CHAN_PLAYBACK) != CHANNEL_PLAYING)
+        {
+            sched_yield();
+            continue;
+        }
+
+        const void *start = NULL;
+        size_t size = 0;
+        unsigned long track;
+
+        /* Like the DMA interrupt: the callback and stopping the channel
+           when it runs dry can't interleave with a locked producer */
+        pcm_play_lock();
+        channel_cb(&start, &size);
+        track = __atomic_load_n(&tracks_seen, __ATOMIC_SEQ_CST);
+        if (size == 0)
+            __atomic_store_n(&channel_status, CHANNEL_STOPPED,
+                             __ATOMIC_SEQ_CST);
+        pcm_play_unlock();
+
+        if (size == 0)
+            continue;
+
+        check_chunk(start, size, &frame, track);
+
+        /* Scribble over it so that data the producer didn't rewrite is
+           caught if it's handed out again */
+        memset((void *)start, 0xa5, size);
+    }
+
+    if (frame != track_start[NUM_TRACKS])
+    {
+        printf("played %u of %u frames\n", frame, track_start[NUM_TRACKS]);
+        errors++;
+    }
+
+    return NULL;
+}
+
+int main(void)
+{
+    pthread_t prod, cons;
+    pthread_mutexattr_t attr;
+
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&pcm_mutex, &attr);
+
+    pcmbuf_update_frequency();
+    pcmbuf_init(arena + ARENA_SIZE);
+
+    pthread_create(&cons, NULL, consumer, NULL);
+    pthread_create(&prod, NULL, producer, NULL);
+    pthread_join(prod, NULL);
+    pthread_join(cons, NULL);
+
+    printf("%u frames, %d chunks, %lu/%d track changes, %lu errors\n",
+           track_start[NUM_TRACKS], pcmbuf_descs(), tracks_seen,
+           NUM_TRACKS, errors);
+
+    return (errors || tracks_seen != NUM_TRACKS) ? 1 : 0;
+}
@@ -74,12 +74,12 @@
 #define CODEC_ENC_MAGIC 0x52454E43 /* RENC */
 
 /* increase this every time the api struct changes */
-#define CODEC_API_VERSION 48
+#define CODEC_API_VERSION 50
 
 /* update this to latest version if a change to the api struct breaks
    backwards compatibility (and please take the opportunity to sort in any
    new function which are "waiting" at the end of the function table) */
-#define CODEC_MIN_API_VERSION 48
+#define CODEC_MIN_API_VERSION 49
 
 /* reasons for calling codec main entrypoint */
 enum codec_entry_call_reason {
@@ -222,6 +222,12 @@ struct codec_api {
 
     /* new stuff at the end, sort into place next time
        the API gets incompatible */
+
+    /* Find the closest seek index point at or before decoded sample
+       <sample> of the current track. Returns false if the track has no
+       index or it isn't ready yet. */
+    bool (*seek_index_lookup)(unsigned long sample,
+                              unsigned long *point_sample, size_t *point_pos);
 };
 
 /* codec header */
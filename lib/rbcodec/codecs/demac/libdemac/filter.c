@@ -48,8 +48,12 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110, USA
 #elif defined(CPU_ARM) && (ARM_ARCH >= 5)
 /* Assume all our ARMv5 targets are ARMv5te(j) */
 #include "vector_math16_armv5te.h"
-#elif (defined(__i386__) || defined(__i486__))  && defined(__MMX__) \
-    || defined(__x86_64__)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include "vector_math16_neon.h"
+#elif defined(__SSE2__)
+/* AVX2 is picked up inside when the compiler targets it */
+#include "vector_math16_sse2.h"
+#elif (defined(__i386__) || defined(__i486__))  && defined(__MMX__)
 #include "vector_math16_mmx.h"
 #else
 #include "vector_math_generic.h"
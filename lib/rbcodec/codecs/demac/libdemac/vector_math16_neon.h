@@ -0,0 +1,108 @@
+/*
+
+libdemac - A Monkey's Audio decoder
+
+$Id$
+
+Copyright (C) Dave Chapman 2007
+
+NEON intrinsics vector math copyright (C) 2026 by the authors
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110, USA
+
+*/
+
+/* Intrinsics counterpart of vector_math16_armv7.h for hosted ARM builds
+ * (AArch64 and hard-float ARMv7 Linux), where the inline asm can't be used
+ * because it's written for the ARM instruction set and fixed registers. */
+
+#include <arm_neon.h>
+
+#define FUSED_VECTOR_MATH
+
+#if ORDER % 16
+#error unsupported order
+#endif
+
+static inline int32_t vector_hsum_s32(int32x4_t acc)
+{
+#ifdef __aarch64__
+    return vaddvq_s32(acc);
+#else
+    int32x2_t t = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    return vget_lane_s32(vpadd_s32(t, t), 0);
+#endif
+}
+
+/* Multiply-accumulate 8 taps into two accumulators (low and high half). */
+#define VMAC8(acc0, acc1, c, f)                                           \
+    do {                                                                  \
+        acc0 = vmlal_s16(acc0, vget_low_s16(c),  vget_low_s16(f));        \
+        acc1 = vmlal_s16(acc1, vget_high_s16(c), vget_high_s16(f));       \
+    } while (0)
+
+/* Calculate scalarproduct, then add a 2nd vector (fused for performance) */
+static inline int32_t vector_sp_add(int16_t* v1, int16_t* f2, int16_t* s2)
+{
+    int32x4_t acc0 = vdupq_n_s32(0);
+    int32x4_t acc1 = vdupq_n_s32(0);
+    int i;
+
+    for (i = 0; i < ORDER; i += 16)
+    {
+        int16x8_t c0 = vld1q_s16(v1 + i);
+        int16x8_t c1 = vld1q_s16(v1 + i + 8);
+        VMAC8(acc0, acc1, c0, vld1q_s16(f2 + i));
+        VMAC8(acc0, acc1, c1, vld1q_s16(f2 + i + 8));
+        vst1q_s16(v1 + i,     vaddq_s16(c0, vld1q_s16(s2 + i)));
+        vst1q_s16(v1 + i + 8, vaddq_s16(c1, vld1q_s16(s2 + i + 8)));
+    }
+    return vector_hsum_s32(vaddq_s32(acc0, acc1));
+}
+
+/* Calculate scalarproduct, then subtract a 2nd vector (fused for performance) */
+static inline int32_t vector_sp_sub(int16_t* v1, int16_t* f2, int16_t* s2)
+{
+    int32x4_t acc0 = vdupq_n_s32(0);
+    int32x4_t acc1 = vdupq_n_s32(0);
+    int i;
+
+    for (i = 0; i < ORDER; i += 16)
+    {
+        int16x8_t c0 = vld1q_s16(v1 + i);
+        int16x8_t c1 = vld1q_s16(v1 + i + 8);
+        VMAC8(acc0, acc1, c0, vld1q_s16(f2 + i));
+        VMAC8(acc0, acc1, c1, vld1q_s16(f2 + i + 8));
+        vst1q_s16(v1 + i,     vsubq_s16(c0, vld1q_s16(s2 + i)));
+        vst1q_s16(v1 + i + 8, vsubq_s16(c1, vld1q_s16(s2 + i + 8)));
+    }
+    return vector_hsum_s32(vaddq_s32(acc0, acc1));
+}
+
+static inline int32_t scalarproduct(int16_t* v1, int16_t* v2)
+{
+    int32x4_t acc0 = vdupq_n_s32(0);
+    int32x4_t acc1 = vdupq_n_s32(0);
+    int i;
+
+    for (i = 0; i < ORDER; i += 16)
+    {
+        VMAC8(acc0, acc1, vld1q_s16(v1 + i),     vld1q_s16(v2 + i));
+        VMAC8(acc0, acc1, vld1q_s16(v1 + i + 8), vld1q_s16(v2 + i + 8));
+    }
+    return vector_hsum_s32(vaddq_s32(acc0, acc1));
+}
+
+#undef VMAC8
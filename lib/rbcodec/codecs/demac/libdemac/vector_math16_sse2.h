@@ -0,0 +1,168 @@
+/*
+
+libdemac - A Monkey's Audio decoder
+
+$Id$
+
+Copyright (C) Dave Chapman 2007
+
+SSE2/AVX2 vector math copyright (C) 2026 by the authors
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110, USA
+
+*/
+
+/* Same operations as the MMX version, written with intrinsics so the
+ * compiler can schedule them. The delay line and adapt coefficients advance
+ * by one sample per call, so only the coefficients could ever be aligned;
+ * all accesses use unaligned loads/stores which cost nothing extra on
+ * aligned data. pmaddwd sums pairs of 16x16 products into 32 bits, which
+ * wraps exactly like the generic C code. */
+
+#include <emmintrin.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#define FUSED_VECTOR_MATH
+
+#if ORDER % 16
+#error unsupported order
+#endif
+
+static inline int32_t vector_hsum_epi32(__m128i acc)
+{
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+}
+
+#ifdef __AVX2__
+
+static inline int32_t vector_hsum256_epi32(__m256i acc)
+{
+    return vector_hsum_epi32(_mm_add_epi32(_mm256_castsi256_si128(acc),
+                                           _mm256_extracti128_si256(acc, 1)));
+}
+
+#define VLOAD(p)     _mm256_loadu_si256((const __m256i *)(p))
+#define VSTORE(p, x) _mm256_storeu_si256((__m256i *)(p), (x))
+
+/* Calculate scalarproduct, then add a 2nd vector (fused for performance) */
+static inline int32_t vector_sp_add(int16_t* v1, int16_t* f2, int16_t* s2)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i;
+
+    for (i = 0; i < ORDER; i += 16)
+    {
+        __m256i c = VLOAD(v1 + i);
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(c, VLOAD(f2 + i)));
+        VSTORE(v1 + i, _mm256_add_epi16(c, VLOAD(s2 + i)));
+    }
+    return vector_hsum256_epi32(acc);
+}
+
+/* Calculate scalarproduct, then subtract a 2nd vector (fused for performance) */
+static inline int32_t vector_sp_sub(int16_t* v1, int16_t* f2, int16_t* s2)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i;
+
+    for (i = 0; i < ORDER; i += 16)
+    {
+        __m256i c = VLOAD(v1 + i);
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(c, VLOAD(f2 + i)));
+        VSTORE(v1 + i, _mm256_sub_epi16(c, VLOAD(s2 + i)));
+    }
+    return vector_hsum256_epi32(acc);
+}
+
+static inline int32_t scalarproduct(int16_t* v1, int16_t* v2)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i;
+
+    for (i = 0; i < ORDER; i += 16)
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(VLOAD(v1 + i),
+                                                      VLOAD(v2 + i)));
+    return vector_hsum256_epi32(acc);
+}
+
+#else /* SSE2 */
+
+#define VLOAD(p)     _mm_loadu_si128((const __m128i *)(p))
+#define VSTORE(p, x) _mm_storeu_si128((__m128i *)(p), (x))
+
+/* Two independent accumulators per 16 taps hide the pmaddwd latency. */
+
+/* Calculate scalarproduct, then add a 2nd vector (fused for performance) */
+static inline int32_t vector_sp_add(int16_t* v1, int16_t* f2, int16_t* s2)
+{
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    int i;
+
+    for (i = 0; i < ORDER; i += 16)
+    {
+        __m128i c0 = VLOAD(v1 + i);
+        __m128i c1 = VLOAD(v1 + i + 8);
+        acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(c0, VLOAD(f2 + i)));
+        acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(c1, VLOAD(f2 + i + 8)));
+        VSTORE(v1 + i,     _mm_add_epi16(c0, VLOAD(s2 + i)));
+        VSTORE(v1 + i + 8, _mm_add_epi16(c1, VLOAD(s2 + i + 8)));
+    }
+    return vector_hsum_epi32(_mm_add_epi32(acc0, acc1));
+}
+
+/* Calculate scalarproduct, then subtract a 2nd vector (fused for performance) */
+static inline int32_t vector_sp_sub(int16_t* v1, int16_t* f2, int16_t* s2)
+{
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    int i;
+
+    for (i = 0; i < ORDER; i += 16)
+    {
+        __m128i c0 = VLOAD(v1 + i);
+        __m128i c1 = VLOAD(v1 + i + 8);
+        acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(c0, VLOAD(f2 + i)));
+        acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(c1, VLOAD(f2 + i + 8)));
+        VSTORE(v1 + i,     _mm_sub_epi16(c0, VLOAD(s2 + i)));
+        VSTORE(v1 + i + 8, _mm_sub_epi16(c1, VLOAD(s2 + i + 8)));
+    }
+    return vector_hsum_epi32(_mm_add_epi32(acc0, acc1));
+}
+
+static inline int32_t scalarproduct(int16_t* v1, int16_t* v2)
+{
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    int i;
+
+    for (i = 0; i < ORDER; i += 16)
+    {
+        acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(VLOAD(v1 + i),
+                                                  VLOAD(v2 + i)));
+        acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(VLOAD(v1 + i + 8),
+                                                  VLOAD(v2 + i + 8)));
+    }
+    return vector_hsum_epi32(_mm_add_epi32(acc0, acc1));
+}
+
+#endif /* __AVX2__ */
+
+#undef VLOAD
+#undef VSTORE
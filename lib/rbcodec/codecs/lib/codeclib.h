@@ -87,8 +87,13 @@ extern const uint8_t bs_clz_tab[256] ICONST_ATTR;
    scan-and-lookup code, and to provide control over output for 0 inputs. */
 static inline unsigned int bs_generic(unsigned int v, int mode)
 {
+#if (defined(CPU_ARM) && ARM_ARCH >= 5) || (CONFIG_PLATFORM & PLATFORM_HOSTED)
 #if defined(CPU_ARM) && ARM_ARCH >= 5
     unsigned int r = __builtin_clz(v);
+#else
+    /* Match the ARM CLZ result for 0, which __builtin_clz leaves undefined */
+    unsigned int r = v ? __builtin_clz(v) : 32;
+#endif
     if (mode & BS_CLZ)
     {
         if (mode & BS_0_0)
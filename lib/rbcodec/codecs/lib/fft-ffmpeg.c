@@ -55,6 +55,7 @@
 /* asm-optimised functions and/or macros */
 #include "fft-ffmpeg_arm.h"
 #include "fft-ffmpeg_cf.h"
+#include "fft-ffmpeg_simd.h"
 
 #ifndef ICODE_ATTR_TREMOR_MDCT
 #define ICODE_ATTR_TREMOR_MDCT ICODE_ATTR
@@ -293,20 +294,30 @@ static void pass(FFTComplex *z_arg, unsigned int STEP_arg, unsigned int n_arg)
     w += STEP;
     /* first pass forwards through sincos_lookup0*/
     do {
+#ifdef FFT_FFMPEG_INCL_OPTIMISED_TRANSFORM2
+        z = TRANSFORM2_W10(z,n,w,STEP);
+        w += 2*STEP;
+#else
         z = TRANSFORM_W10(z,n,w);
         w += STEP;
         z = TRANSFORM_W10(z,n,w);
         w += STEP;
+#endif
     } while(LIKELY(w < w_end));
     /* second half: pass backwards through sincos_lookup0*/
     /* wim and wre are now in opposite places so ordering now [0],[1] */
     w_end=sincos_lookup0;
     while(LIKELY(w>w_end))
     {
+#ifdef FFT_FFMPEG_INCL_OPTIMISED_TRANSFORM2
+        z = TRANSFORM2_W01(z,n,w,STEP);
+        w -= 2*STEP;
+#else
         z = TRANSFORM_W01(z,n,w);
         w -= STEP;
         z = TRANSFORM_W01(z,n,w);
         w -= STEP;
+#endif
     }
 }
 
@@ -0,0 +1,185 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * SSE2/SSE4.1 and NEON optimisations for ffmpeg's fft (used in fft-ffmpeg.c)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/* Hosted builds only. The radix pass does two neighbouring butterflies at
+   once, one complex pair per 64 bit half of a vector:
+
+     A    = { z[k].re,  z[k].im,  z[k+1].re,  z[k+1].im }
+     WRE  = { wre(k),   wre(k),   wre(k+1),   wre(k+1)  }
+     WIM  = { wim(k),   wim(k),   wim(k+1),   wim(k+1)  }
+
+   XPROD31_R/XNPROD31_R then become two lane-wise MULT31s, one of them on
+   A with re/im swapped, followed by an add/sub with the sign of either the
+   re or the im lanes flipped. MULT31 keeps the generic rounding (high word
+   of the 64 bit product, shifted up by one), so the output is bit-exact.
+
+   Only pass() is vectorised. fft4/fft8/fft16, the permutation and the IMDCT
+   pre/post rotations stay scalar, and there's no plan setup at run time:
+   the twiddles and bit-reverse table remain the static ones every size
+   shares. Codecs that don't use this FFT (Opus CELT's mixed radix kiss_fft,
+   wmavoice's float transforms) are unaffected. */
+
+#if !defined(CPU_ARM) && !defined(CPU_COLDFIRE) && \
+    (defined(__SSE2__) || defined(__ARM_NEON) || defined(__ARM_NEON__))
+
+#define FFT_FFMPEG_INCL_OPTIMISED_TRANSFORM2
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+
+typedef __m128i fft_vec_t;
+
+#define fft_vload(p)      _mm_loadu_si128((const __m128i *)(p))
+#define fft_vstore(p, x)  _mm_storeu_si128((__m128i *)(p), (x))
+#define fft_vadd(x, y)    _mm_add_epi32((x), (y))
+#define fft_vsub(x, y)    _mm_sub_epi32((x), (y))
+#define fft_vswap(x)      _mm_shuffle_epi32((x), _MM_SHUFFLE(2, 3, 0, 1))
+#define FFT_VSIGN_RE      _mm_set_epi32(0, -1, 0, -1)
+#define FFT_VSIGN_IM      _mm_set_epi32(-1, 0, -1, 0)
+
+/* x with the lanes selected by the all-ones mask s negated */
+static inline fft_vec_t fft_vneg(fft_vec_t x, fft_vec_t s)
+{
+    return _mm_sub_epi32(_mm_xor_si128(x, s), s);
+}
+
+/* { p[0], p[0], q[0], q[0] } and { p[1], p[1], q[1], q[1] } */
+static inline void fft_vtwiddle(const FFTSample *p, const FFTSample *q,
+                                fft_vec_t *w0, fft_vec_t *w1)
+{
+    fft_vec_t t = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)p),
+                                     _mm_loadl_epi64((const __m128i *)q));
+    *w0 = _mm_shuffle_epi32(t, _MM_SHUFFLE(2, 2, 0, 0));
+    *w1 = _mm_shuffle_epi32(t, _MM_SHUFFLE(3, 3, 1, 1));
+}
+
+static inline fft_vec_t fft_vmul31(fft_vec_t x, fft_vec_t y)
+{
+    fft_vec_t xo = _mm_srli_epi64(x, 32);
+    fft_vec_t yo = _mm_srli_epi64(y, 32);
+#ifdef __SSE4_1__
+    fft_vec_t ev = _mm_mul_epi32(x, y);
+    fft_vec_t od = _mm_mul_epi32(xo, yo);
+#else
+    fft_vec_t ev = _mm_mul_epu32(x, y);
+    fft_vec_t od = _mm_mul_epu32(xo, yo);
+#endif
+    fft_vec_t hi = _mm_or_si128(_mm_srli_epi64(ev, 32),
+                                _mm_and_si128(od, _mm_set_epi32(-1, 0, -1, 0)));
+#ifndef __SSE4_1__
+    /* unsigned to signed high word: subtract y where x < 0 and vice versa */
+    hi = _mm_sub_epi32(hi, _mm_and_si128(_mm_srai_epi32(x, 31), y));
+    hi = _mm_sub_epi32(hi, _mm_and_si128(_mm_srai_epi32(y, 31), x));
+#endif
+    return _mm_slli_epi32(hi, 1);
+}
+
+#else /* NEON */
+#include <arm_neon.h>
+
+typedef int32x4_t fft_vec_t;
+
+#define fft_vload(p)      vld1q_s32((const int32_t *)(p))
+#define fft_vstore(p, x)  vst1q_s32((int32_t *)(p), (x))
+#define fft_vadd(x, y)    vaddq_s32((x), (y))
+#define fft_vsub(x, y)    vsubq_s32((x), (y))
+#define fft_vswap(x)      vrev64q_s32(x)
+#define FFT_VSIGN_RE      vcombine_s32(vcreate_s32(0x00000000ffffffffull), \
+                                       vcreate_s32(0x00000000ffffffffull))
+#define FFT_VSIGN_IM      vcombine_s32(vcreate_s32(0xffffffff00000000ull), \
+                                       vcreate_s32(0xffffffff00000000ull))
+
+static inline fft_vec_t fft_vneg(fft_vec_t x, fft_vec_t s)
+{
+    return vsubq_s32(veorq_s32(x, s), s);
+}
+
+static inline void fft_vtwiddle(const FFTSample *p, const FFTSample *q,
+                                fft_vec_t *w0, fft_vec_t *w1)
+{
+    int32x4x2_t t = vtrnq_s32(vcombine_s32(vld1_s32(p), vld1_s32(q)),
+                              vcombine_s32(vld1_s32(p), vld1_s32(q)));
+    *w0 = t.val[0];
+    *w1 = t.val[1];
+}
+
+/* vqdmulh gives floor(x*y / 2^31); clearing bit 0 makes it the high word
+   shifted up by one like MULT31. It only saturates for INT_MIN * INT_MIN,
+   which the twiddles never are. */
+static inline fft_vec_t fft_vmul31(fft_vec_t x, fft_vec_t y)
+{
+    return vbicq_s32(vqdmulhq_s32(x, y), vdupq_n_s32(1));
+}
+
+#endif /* __SSE2__ */
+
+/* Two TRANSFORMs on z[0..1] with the twiddles {wre,wim} at indexes 0 and 1 */
+static inline FFTComplex* fft_transform2(FFTComplex *z, unsigned int n,
+                                         fft_vec_t wre, fft_vec_t wim)
+{
+    fft_vec_t a2 = fft_vload(z + n*2);
+    fft_vec_t a3 = fft_vload(z + n*3);
+    fft_vec_t a0 = fft_vload(z);
+    fft_vec_t a1 = fft_vload(z + n);
+
+    /* { t1, t2 } = XPROD31_R(a2), { t5, t6 } = XNPROD31_R(a3) */
+    fft_vec_t t12 = fft_vadd(fft_vmul31(a2, wre),
+                             fft_vneg(fft_vmul31(fft_vswap(a2), wim),
+                                      FFT_VSIGN_IM));
+    fft_vec_t t56 = fft_vadd(fft_vmul31(a3, wre),
+                             fft_vneg(fft_vmul31(fft_vswap(a3), wim),
+                                      FFT_VSIGN_RE));
+
+    /* s = { t1 + t5, t2 + t6 }, d = { t2 - t6, t5 - t1 } */
+    fft_vec_t s = fft_vadd(t12, t56);
+    fft_vec_t d = fft_vneg(fft_vswap(fft_vsub(t12, t56)), FFT_VSIGN_IM);
+
+    fft_vstore(z,       fft_vadd(a0, s));
+    fft_vstore(z + n*2, fft_vsub(a0, s));
+    fft_vstore(z + n,   fft_vadd(a1, d));
+    fft_vstore(z + n*3, fft_vsub(a1, d));
+    return z + 2;
+}
+
+/* first half of the pass: w ascends through sincos_lookup0, {sin,cos} */
+static inline FFTComplex* TRANSFORM2_W10(FFTComplex *z, unsigned int n,
+                                         const FFTSample *w, unsigned int step)
+{
+    fft_vec_t wre, wim;
+    fft_vtwiddle(w, w + step, &wim, &wre);
+    return fft_transform2(z, n, wre, wim);
+}
+
+/* second half: w descends, and the order within each entry is {cos,sin} */
+static inline FFTComplex* TRANSFORM2_W01(FFTComplex *z, unsigned int n,
+                                         const FFTSample *w, unsigned int step)
+{
+    fft_vec_t wre, wim;
+    fft_vtwiddle(w, w - step, &wre, &wim);
+    return fft_transform2(z, n, wre, wim);
+}
+
+#endif /* hosted SIMD */
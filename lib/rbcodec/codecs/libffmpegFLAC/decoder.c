@@ -44,8 +44,12 @@
 
 #if defined(CPU_COLDFIRE)
 #include "coldfire.h"
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include "neon.h"
 #elif defined(CPU_ARM)
 #include "arm.h"
+#elif defined(__SSE2__)
+#include "sse2.h"
 #endif
 
 static const int sample_rate_table[] ICONST_ATTR =
@@ -134,6 +138,81 @@ static int get_crc8(const uint8_t *buf, int count)
     return crc;
 }
 
+/* Returns the 32 bits starting at bit 'index' of the stream. One more byte
+   than UPDATE_CACHE reads, so all 32 bits are valid for any alignment. */
+static inline uint32_t rice_peek32(const uint8_t *buf, unsigned int index)
+{
+    const uint8_t *p = buf + (index >> 3);
+    unsigned int shift = index & 7;
+    return (AV_RB32(p) << shift) | (p[4] >> (8 - shift));
+}
+
+/* Decodes 'count' Rice codes with parameter k. Works on a local bit index
+   and a 32-bit window of the stream instead of going through the
+   GetBitContext for every code: the quotient is a leading zero count and
+   short codes are taken from the window one after another, so the stream
+   is only read again once the window runs dry. */
+static int decode_rice_partition(GetBitContext *gb, int32_t* decoded,
+                                 int count, int k) ICODE_ATTR_FLAC;
+static int decode_rice_partition(GetBitContext *gb, int32_t* decoded,
+                                 int count, int k)
+{
+    const uint8_t *buf = gb->buffer;
+    const unsigned int end = gb->size_in_bits;
+    unsigned int index = gb->index;
+    uint32_t win = rice_peek32(buf, index);
+    unsigned int avail = 32; /* Bits of win still holding stream data */
+
+    while (count-- > 0)
+    {
+        uint32_t q = 0, v;
+        unsigned int zeros = win ? bs_generic(win, BS_CLZ) : 32;
+        unsigned int len = zeros + 1 + k;
+
+        if (len > avail)
+        {
+            /* Code runs past the data left in the window */
+            win = rice_peek32(buf, index);
+            avail = 32;
+
+            while (win == 0)
+            {
+                /* Long unary run; only seen in damaged streams */
+                q += 32;
+                index += 32;
+                if (index >= end)
+                    return -1;
+                win = rice_peek32(buf, index);
+            }
+
+            zeros = bs_generic(win, BS_CLZ);
+            len = zeros + 1 + k;
+        }
+
+        if (len <= avail)
+        {
+            /* The double shifts keep k == 0 and len == 32 defined */
+            v = (win << zeros << 1) >> 1 >> (31 - k);
+            win = win << (len - 1) << 1;
+            avail -= len;
+        }
+        else
+        {
+            /* Remainder spills out of the window; refill on the next code */
+            v = rice_peek32(buf, index + zeros + 1) >> 1 >> (31 - k);
+            win = 0;
+            avail = 0;
+        }
+
+        index += len;
+        v |= (q + zeros) << k;
+        *decoded++ = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+    }
+
+    gb->index = index;
+    return 0;
+}
+
 static int decode_residuals(FLACContext *s, int32_t* decoded, int pred_order) ICODE_ATTR_FLAC;
 static int decode_residuals(FLACContext *s, int32_t* decoded, int pred_order)
 {
@@ -162,11 +241,12 @@ static int decode_residuals(FLACContext *s, int32_t* decoded, int pred_order)
             for (; i < samples; i++, sample++)
                 decoded[sample] = get_sbits(&s->gb, tmp);
         }
-        else
+        else if (i < samples)
         {
-            for (; i < samples; i++, sample++){
-                decoded[sample] = get_sr_golomb_flac(&s->gb, tmp, INT_MAX, 0);
-            }
+            if (decode_rice_partition(&s->gb, decoded + sample, samples - i,
+                                      tmp) < 0)
+                return -3;
+            sample += samples - i;
         }
         i= 0;
     }
@@ -261,10 +341,18 @@ static int decode_subframe_lpc(FLACContext *s, int32_t* decoded, int pred_order)
         (void)sum;
         lpc_decode_emac(s->blocksize - pred_order, qlevel, pred_order,
                         decoded + pred_order, coeffs);
+        #elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        (void)sum;
+        lpc_decode_neon(s->blocksize - pred_order, qlevel, pred_order,
+                        decoded + pred_order, coeffs);
         #elif defined(CPU_ARM)
         (void)sum;
         lpc_decode_arm(s->blocksize - pred_order, qlevel, pred_order,
                        decoded + pred_order, coeffs);
+        #elif defined(__SSE2__)
+        (void)sum;
+        lpc_decode_sse2(s->blocksize - pred_order, qlevel, pred_order,
+                        decoded + pred_order, coeffs);
         #else
         for (i = pred_order; i < s->blocksize; i++)
         {
@@ -280,6 +368,16 @@ static int decode_subframe_lpc(FLACContext *s, int32_t* decoded, int pred_order)
         (void)j;
         lpc_decode_emac_wide(s->blocksize - pred_order, qlevel, pred_order,
                              decoded + pred_order, coeffs);
+        #elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+        (void)wsum;
+        (void)j;
+        lpc_decode_neon_wide(s->blocksize - pred_order, qlevel, pred_order,
+                             decoded + pred_order, coeffs);
+        #elif defined(__SSE4_1__)
+        (void)wsum;
+        (void)j;
+        lpc_decode_sse41_wide(s->blocksize - pred_order, qlevel, pred_order,
+                              decoded + pred_order, coeffs);
         #else
         for (i = pred_order; i < s->blocksize; i++)
         {
@@ -0,0 +1,105 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/* NEON versions of the LPC filtering routines, for hosted ARM targets.
+   Four samples are predicted at a time. Every tap from the fourth on only
+   reaches samples from before the group, so those are vector multiply-adds
+   across the four outputs. The first three taps reach into the group
+   itself and are added in C as each sample is completed. Sums wrap the
+   same way as the C version so the output is bit-exact. */
+
+#include <arm_neon.h>
+#include "neon.h"
+
+void lpc_decode_neon(int blocksize, int qlevel, int pred_order, int32_t* data,
+                     int* coeffs)
+{
+    const int c0 = coeffs[0];
+    const int c1 = pred_order > 1 ? coeffs[1] : 0;
+    const int c2 = pred_order > 2 ? coeffs[2] : 0;
+    int32_t *d = data;
+    int32_t *end = data + (blocksize & ~3);
+    int j, sum;
+
+    for (; d < end; d += 4)
+    {
+        int32_t part[4];
+        int32x4_t acc = vdupq_n_s32(0);
+
+        for (j = 3; j < pred_order; j++)
+            acc = vmlaq_n_s32(acc, vld1q_s32(d - j - 1), coeffs[j]);
+
+        vst1q_s32(part, acc);
+        d[0] += (part[0] + c0*d[-1] + c1*d[-2] + c2*d[-3]) >> qlevel;
+        d[1] += (part[1] + c0*d[0]  + c1*d[-1] + c2*d[-2]) >> qlevel;
+        d[2] += (part[2] + c0*d[1]  + c1*d[0]  + c2*d[-1]) >> qlevel;
+        d[3] += (part[3] + c0*d[2]  + c1*d[1]  + c2*d[0])  >> qlevel;
+    }
+
+    for (end = data + blocksize; d < end; d++)
+    {
+        sum = 0;
+        for (j = 0; j < pred_order; j++)
+            sum += coeffs[j] * d[-j-1];
+        *d += sum >> qlevel;
+    }
+}
+
+void lpc_decode_neon_wide(int blocksize, int qlevel, int pred_order,
+                          int32_t* data, int* coeffs)
+{
+    const int64_t c0 = coeffs[0];
+    const int64_t c1 = pred_order > 1 ? coeffs[1] : 0;
+    const int64_t c2 = pred_order > 2 ? coeffs[2] : 0;
+    int32_t *d = data;
+    int32_t *end = data + (blocksize & ~3);
+    int64_t wsum;
+    int j;
+
+    for (; d < end; d += 4)
+    {
+        int64_t part[4];
+        int64x2_t lo = vdupq_n_s64(0);
+        int64x2_t hi = vdupq_n_s64(0);
+
+        for (j = 3; j < pred_order; j++)
+        {
+            int32x4_t h = vld1q_s32(d - j - 1);
+            lo = vmlal_n_s32(lo, vget_low_s32(h), coeffs[j]);
+            hi = vmlal_n_s32(hi, vget_high_s32(h), coeffs[j]);
+        }
+
+        vst1q_s64(&part[0], lo);
+        vst1q_s64(&part[2], hi);
+        d[0] += (part[0] + c0*d[-1] + c1*d[-2] + c2*d[-3]) >> qlevel;
+        d[1] += (part[1] + c0*d[0]  + c1*d[-1] + c2*d[-2]) >> qlevel;
+        d[2] += (part[2] + c0*d[1]  + c1*d[0]  + c2*d[-1]) >> qlevel;
+        d[3] += (part[3] + c0*d[2]  + c1*d[1]  + c2*d[0])  >> qlevel;
+    }
+
+    for (end = data + blocksize; d < end; d++)
+    {
+        wsum = 0;
+        for (j = 0; j < pred_order; j++)
+            wsum += (int64_t)coeffs[j] * (int64_t)d[-j-1];
+        *d += wsum >> qlevel;
+    }
+}
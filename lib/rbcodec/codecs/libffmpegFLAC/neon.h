@@ -0,0 +1,11 @@
+#ifndef _FLAC_NEON_H
+#define _FLAC_NEON_H
+
+#include "bitstream.h"
+
+void lpc_decode_neon(int blocksize, int qlevel, int pred_order, int32_t* data,
+                     int* coeffs);
+void lpc_decode_neon_wide(int blocksize, int qlevel, int pred_order,
+                          int32_t* data, int* coeffs);
+
+#endif
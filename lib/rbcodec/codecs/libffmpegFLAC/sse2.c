@@ -0,0 +1,130 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/* SSE2 versions of the LPC filtering routines, for hosted x86 targets.
+   Four samples are predicted at a time. Every tap from the fourth on only
+   reaches samples from before the group, so those are vector multiply-adds
+   across the four outputs. The first three taps reach into the group
+   itself and are added in C as each sample is completed.
+   SSE2 has no 32-bit low multiply, so it's built from two _mm_mul_epu32
+   (the low half of the product doesn't depend on signedness). The wide
+   case needs a signed 32x32->64 multiply, which first appears in SSE4.1;
+   without it decoder.c keeps using C. Sums wrap the same way as the C
+   version so the output is bit-exact. */
+
+#include <emmintrin.h>
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+#include "sse2.h"
+
+static inline __m128i mullo_epi32(__m128i a, __m128i b)
+{
+#ifdef __SSE4_1__
+    return _mm_mullo_epi32(a, b);
+#else
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd  = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd,  _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+
+void lpc_decode_sse2(int blocksize, int qlevel, int pred_order, int32_t* data,
+                     int* coeffs)
+{
+    const int c0 = coeffs[0];
+    const int c1 = pred_order > 1 ? coeffs[1] : 0;
+    const int c2 = pred_order > 2 ? coeffs[2] : 0;
+    int32_t *d = data;
+    int32_t *end = data + (blocksize & ~3);
+    int j, sum;
+
+    for (; d < end; d += 4)
+    {
+        int32_t part[4] __attribute__((aligned(16)));
+        __m128i acc = _mm_setzero_si128();
+
+        for (j = 3; j < pred_order; j++)
+            acc = _mm_add_epi32(acc,
+                    mullo_epi32(_mm_loadu_si128((const __m128i *)(d - j - 1)),
+                                _mm_set1_epi32(coeffs[j])));
+
+        _mm_store_si128((__m128i *)part, acc);
+        d[0] += (part[0] + c0*d[-1] + c1*d[-2] + c2*d[-3]) >> qlevel;
+        d[1] += (part[1] + c0*d[0]  + c1*d[-1] + c2*d[-2]) >> qlevel;
+        d[2] += (part[2] + c0*d[1]  + c1*d[0]  + c2*d[-1]) >> qlevel;
+        d[3] += (part[3] + c0*d[2]  + c1*d[1]  + c2*d[0])  >> qlevel;
+    }
+
+    for (end = data + blocksize; d < end; d++)
+    {
+        sum = 0;
+        for (j = 0; j < pred_order; j++)
+            sum += coeffs[j] * d[-j-1];
+        *d += sum >> qlevel;
+    }
+}
+
+#ifdef __SSE4_1__
+void lpc_decode_sse41_wide(int blocksize, int qlevel, int pred_order,
+                           int32_t* data, int* coeffs)
+{
+    const int64_t c0 = coeffs[0];
+    const int64_t c1 = pred_order > 1 ? coeffs[1] : 0;
+    const int64_t c2 = pred_order > 2 ? coeffs[2] : 0;
+    int32_t *d = data;
+    int32_t *end = data + (blocksize & ~3);
+    int64_t wsum;
+    int j;
+
+    for (; d < end; d += 4)
+    {
+        int64_t part[4] __attribute__((aligned(16)));
+        __m128i lo = _mm_setzero_si128();
+        __m128i hi = _mm_setzero_si128();
+
+        for (j = 3; j < pred_order; j++)
+        {
+            __m128i h = _mm_loadu_si128((const __m128i *)(d - j - 1));
+            __m128i c = _mm_set1_epi32(coeffs[j]);
+            lo = _mm_add_epi64(lo, _mm_mul_epi32(_mm_cvtepi32_epi64(h), c));
+            hi = _mm_add_epi64(hi, _mm_mul_epi32(
+                    _mm_cvtepi32_epi64(_mm_srli_si128(h, 8)), c));
+        }
+
+        _mm_store_si128((__m128i *)&part[0], lo);
+        _mm_store_si128((__m128i *)&part[2], hi);
+        d[0] += (part[0] + c0*d[-1] + c1*d[-2] + c2*d[-3]) >> qlevel;
+        d[1] += (part[1] + c0*d[0]  + c1*d[-1] + c2*d[-2]) >> qlevel;
+        d[2] += (part[2] + c0*d[1]  + c1*d[0]  + c2*d[-1]) >> qlevel;
+        d[3] += (part[3] + c0*d[2]  + c1*d[1]  + c2*d[0])  >> qlevel;
+    }
+
+    for (end = data + blocksize; d < end; d++)
+    {
+        wsum = 0;
+        for (j = 0; j < pred_order; j++)
+            wsum += (int64_t)coeffs[j] * (int64_t)d[-j-1];
+        *d += wsum >> qlevel;
+    }
+}
+#endif /* __SSE4_1__ */
@@ -0,0 +1,13 @@
+#ifndef _FLAC_SSE2_H
+#define _FLAC_SSE2_H
+
+#include "bitstream.h"
+
+void lpc_decode_sse2(int blocksize, int qlevel, int pred_order, int32_t* data,
+                     int* coeffs);
+#ifdef __SSE4_1__
+void lpc_decode_sse41_wide(int blocksize, int qlevel, int pred_order,
+                           int32_t* data, int* coeffs);
+#endif
+
+#endif
@@ -26,6 +26,51 @@
 
 typedef   int32_t mad_fixed_t;
 
+# if defined(MAD_SIMD)
+typedef mad_fixed_t mad_vec_t __attribute__((vector_size(16)));
+/* same, for loads and stores that need not be 16 byte aligned */
+typedef mad_fixed_t mad_vec_u_t __attribute__((vector_size(16), aligned(4)));
+
+/* ((x) + (1L << 11)) >> 12 in a way that can't overflow a 32-bit lane */
+#  define mad_f_vround12(x)     (((x) >> 12) + (((x) >> 11) & 1))
+
+/* lanes i0..i3 of the concatenation of a and b */
+#  if defined(__clang__)
+#   define mad_vec_shuffle(a, b, i0, i1, i2, i3)  \
+    __builtin_shufflevector((a), (b), i0, i1, i2, i3)
+#  else
+#   define mad_vec_shuffle(a, b, i0, i1, i2, i3)  \
+    __builtin_shuffle((a), (b), (mad_vec_t) { i0, i1, i2, i3 })
+#  endif
+
+/*
+ * mad_f_mul() of a vector and a scalar, with the same result as the scalar
+ * macro where long is 64 bits wide
+ */
+static inline
+mad_vec_t mad_f_mul_vec(mad_vec_t x, mad_fixed_t y)
+{
+  return mad_f_vround12(x) * (mad_fixed_t) ((y + (1L << 15)) >> 16);
+}
+
+/* v[i][k] = v[k][i] */
+static inline
+void mad_vec_transpose4(mad_vec_t v[4])
+{
+  mad_vec_t t0, t1, t2, t3;
+
+  t0 = mad_vec_shuffle(v[0], v[1], 0, 4, 1, 5);
+  t1 = mad_vec_shuffle(v[0], v[1], 2, 6, 3, 7);
+  t2 = mad_vec_shuffle(v[2], v[3], 0, 4, 1, 5);
+  t3 = mad_vec_shuffle(v[2], v[3], 2, 6, 3, 7);
+
+  v[0] = mad_vec_shuffle(t0, t2, 0, 1, 4, 5);
+  v[1] = mad_vec_shuffle(t0, t2, 2, 3, 6, 7);
+  v[2] = mad_vec_shuffle(t1, t3, 0, 1, 4, 5);
+  v[3] = mad_vec_shuffle(t1, t3, 2, 3, 6, 7);
+}
+# endif
+
 typedef   int32_t mad_fixed64hi_t;
 typedef  uint32_t mad_fixed64lo_t;
 
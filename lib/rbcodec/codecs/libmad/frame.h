@@ -74,7 +74,9 @@ struct mad_frame {
                                                from previous frame only needed
                                                when synthesis is on cop */
                                                
-  mad_fixed_t (*overlap)[2][32][18] MEM_ALIGN_ATTR;    /* Layer III block overlap data */
+  mad_fixed_t (*overlap)[2][32][18] MEM_ALIGN_ATTR;    /* Layer III block overlap data
+                                               ([ch][i][sb] inside layer3.c
+                                               with MAD_SIMD) */
 };
 
 # define MAD_NCHANNELS(header)          ((header)->mode ? 2 : 1)
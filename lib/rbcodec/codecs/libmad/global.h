@@ -36,6 +36,14 @@
 #define FPM_DEFAULT
 #endif
 
+/* With SSE4.1 the generic fixed point synthesis and IMDCT code runs on four
+   vector lanes at once. Plain SSE2 has no 32-bit lane multiply and isn't
+   faster than the scalar code; NEON would suit it too but hasn't been built
+   yet, so it's left off there. */
+#if defined(FPM_DEFAULT) && defined(__SSE4_1__)
+#define MAD_SIMD
+#endif
+
 /* conditional debugging */
 
 # if defined(DEBUG) && defined(NDEBUG)
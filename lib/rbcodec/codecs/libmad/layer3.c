@@ -1610,6 +1610,28 @@ void III_aliasreduce(mad_fixed_t xr[576], int lines)
 }
 #endif
 
+/*
+ * With MAD_SIMD the generic IMDCT code below transforms four subbands at
+ * once, one in each vector lane (see III_imdct_group())
+ */
+# if defined(MAD_SIMD)
+typedef mad_vec_t       imdct_fixed_t;
+typedef mad_vec_t       imdct_hi_t;
+typedef mad_vec_t       imdct_lo_t;
+#  define IMDCT_MUL(x, y)          mad_f_mul_vec((x), (y))
+#  define IMDCT_ML0(hi, lo, x, y)  ((lo)  = IMDCT_MUL((x), (y)))
+#  define IMDCT_MLA(hi, lo, x, y)  ((lo) += IMDCT_MUL((x), (y)))
+#  define IMDCT_MLZ(hi, lo)        ((void) (hi), (lo))
+# else
+typedef mad_fixed_t     imdct_fixed_t;
+typedef mad_fixed64hi_t imdct_hi_t;
+typedef mad_fixed64lo_t imdct_lo_t;
+#  define IMDCT_MUL(x, y)          mad_f_mul((x), (y))
+#  define IMDCT_ML0(hi, lo, x, y)  MAD_F_ML0(hi, lo, (x), (y))
+#  define IMDCT_MLA(hi, lo, x, y)  MAD_F_MLA(hi, lo, (x), (y))
+#  define IMDCT_MLZ(hi, lo)        MAD_F_MLZ(hi, lo)
+# endif
+
 # if defined(FPM_ARM)
 void III_imdct_l(mad_fixed_t const [18], mad_fixed_t [36], unsigned int);
 # else
@@ -2285,258 +2307,258 @@ void imdct36(mad_fixed_t const X[18], mad_fixed_t x[36])
 #  else /* if defined(CPU_COLDFIRE) */
 
 static inline
-void imdct36(mad_fixed_t const X[18], mad_fixed_t x[36])
+void imdct36(imdct_fixed_t const X[18], imdct_fixed_t x[36])
 {
-  mad_fixed_t t0, t1, t2,  t3,  t4,  t5,  t6,  t7;
-  mad_fixed_t t8, t9, t10, t11, t12, t13, t14, t15;
-  register mad_fixed64hi_t hi;
-  register mad_fixed64lo_t lo;
-
-  MAD_F_ML0(hi, lo, (t14 = X[1] - X[10]), -MAD_F(0x0ec835e8));
-  MAD_F_MLA(hi, lo, (t15 = X[7] + X[16]),  MAD_F(0x061f78aa));
-  t4 = MAD_F_MLZ(hi, lo);
-
-  MAD_F_ML0(hi, lo, X[4],  MAD_F(0x0ec835e8));
-  MAD_F_MLA(hi, lo, X[13], MAD_F(0x061f78aa));
-  t6 = MAD_F_MLZ(hi, lo);
-
-  MAD_F_MLA(hi, lo, t14, -MAD_F(0x061f78aa));
-  MAD_F_MLA(hi, lo, t15, -MAD_F(0x0ec835e8));
-  t0 = MAD_F_MLZ(hi, lo);
-
-  MAD_F_MLA(hi, lo, (t8 =X[0]-X[11]-X[12]),  MAD_F(0x0216a2a2));
-  MAD_F_MLA(hi, lo, (t9 =X[2]-X[ 9]-X[14]),  MAD_F(0x09bd7ca0));
-  MAD_F_MLA(hi, lo, (t10=X[3]-X[ 8]-X[15]), -MAD_F(0x0cb19346));
-  MAD_F_MLA(hi, lo, (t11=X[5]-X[ 6]-X[17]), -MAD_F(0x0fdcf549));
-  x[10] = -(x[7] = MAD_F_MLZ(hi, lo));
-
-  MAD_F_ML0(hi, lo, t8,  -MAD_F(0x0cb19346));
-  MAD_F_MLA(hi, lo, t9,   MAD_F(0x0fdcf549));
-  MAD_F_MLA(hi, lo, t10,  MAD_F(0x0216a2a2));
-  MAD_F_MLA(hi, lo, t11, -MAD_F(0x09bd7ca0));
-  x[19] = x[34] = MAD_F_MLZ(hi, lo) - t0;
-
-  MAD_F_ML0(hi, lo, t8,   MAD_F(0x09bd7ca0));
-  MAD_F_MLA(hi, lo, t9,  -MAD_F(0x0216a2a2));
-  MAD_F_MLA(hi, lo, t10,  MAD_F(0x0fdcf549));
-  MAD_F_MLA(hi, lo, t11, -MAD_F(0x0cb19346));
-  x[ 1] = MAD_F_MLZ(hi, lo);
-
-  MAD_F_ML0(hi, lo, t8,  -MAD_F(0x0fdcf549));
-  MAD_F_MLA(hi, lo, t9,  -MAD_F(0x0cb19346));
-  MAD_F_MLA(hi, lo, t10, -MAD_F(0x09bd7ca0));
-  MAD_F_MLA(hi, lo, t11, -MAD_F(0x0216a2a2));
-  x[25] = MAD_F_MLZ(hi, lo);
+  imdct_fixed_t t0, t1, t2,  t3,  t4,  t5,  t6,  t7;
+  imdct_fixed_t t8, t9, t10, t11, t12, t13, t14, t15;
+  register imdct_hi_t hi;
+  register imdct_lo_t lo;
+
+  IMDCT_ML0(hi, lo, (t14 = X[1] - X[10]), -MAD_F(0x0ec835e8));
+  IMDCT_MLA(hi, lo, (t15 = X[7] + X[16]),  MAD_F(0x061f78aa));
+  t4 = IMDCT_MLZ(hi, lo);
+
+  IMDCT_ML0(hi, lo, X[4],  MAD_F(0x0ec835e8));
+  IMDCT_MLA(hi, lo, X[13], MAD_F(0x061f78aa));
+  t6 = IMDCT_MLZ(hi, lo);
+
+  IMDCT_MLA(hi, lo, t14, -MAD_F(0x061f78aa));
+  IMDCT_MLA(hi, lo, t15, -MAD_F(0x0ec835e8));
+  t0 = IMDCT_MLZ(hi, lo);
+
+  IMDCT_MLA(hi, lo, (t8 =X[0]-X[11]-X[12]),  MAD_F(0x0216a2a2));
+  IMDCT_MLA(hi, lo, (t9 =X[2]-X[ 9]-X[14]),  MAD_F(0x09bd7ca0));
+  IMDCT_MLA(hi, lo, (t10=X[3]-X[ 8]-X[15]), -MAD_F(0x0cb19346));
+  IMDCT_MLA(hi, lo, (t11=X[5]-X[ 6]-X[17]), -MAD_F(0x0fdcf549));
+  x[10] = -(x[7] = IMDCT_MLZ(hi, lo));
+
+  IMDCT_ML0(hi, lo, t8,  -MAD_F(0x0cb19346));
+  IMDCT_MLA(hi, lo, t9,   MAD_F(0x0fdcf549));
+  IMDCT_MLA(hi, lo, t10,  MAD_F(0x0216a2a2));
+  IMDCT_MLA(hi, lo, t11, -MAD_F(0x09bd7ca0));
+  x[19] = x[34] = IMDCT_MLZ(hi, lo) - t0;
+
+  IMDCT_ML0(hi, lo, t8,   MAD_F(0x09bd7ca0));
+  IMDCT_MLA(hi, lo, t9,  -MAD_F(0x0216a2a2));
+  IMDCT_MLA(hi, lo, t10,  MAD_F(0x0fdcf549));
+  IMDCT_MLA(hi, lo, t11, -MAD_F(0x0cb19346));
+  x[ 1] = IMDCT_MLZ(hi, lo);
+
+  IMDCT_ML0(hi, lo, t8,  -MAD_F(0x0fdcf549));
+  IMDCT_MLA(hi, lo, t9,  -MAD_F(0x0cb19346));
+  IMDCT_MLA(hi, lo, t10, -MAD_F(0x09bd7ca0));
+  IMDCT_MLA(hi, lo, t11, -MAD_F(0x0216a2a2));
+  x[25] = IMDCT_MLZ(hi, lo);
 
   t12 = t8 - t10;
   t13 = t9 + t11;
 
-  MAD_F_ML0(hi, lo, X[1],  -MAD_F(0x09bd7ca0));
-  MAD_F_MLA(hi, lo, X[7],   MAD_F(0x0216a2a2));
-  MAD_F_MLA(hi, lo, X[10], -MAD_F(0x0fdcf549));
-  MAD_F_MLA(hi, lo, X[16],  MAD_F(0x0cb19346));
-  t1 = MAD_F_MLZ(hi, lo) + t6;
-
-  MAD_F_ML0(hi, lo, X[1],  -MAD_F(0x0216a2a2));
-  MAD_F_MLA(hi, lo, X[7],  -MAD_F(0x09bd7ca0));
-  MAD_F_MLA(hi, lo, X[10],  MAD_F(0x0cb19346));
-  MAD_F_MLA(hi, lo, X[16],  MAD_F(0x0fdcf549));
-  t3 = MAD_F_MLZ(hi, lo);
-
-  MAD_F_ML0(hi, lo, X[1],  -MAD_F(0x0fdcf549));
-  MAD_F_MLA(hi, lo, X[7],  -MAD_F(0x0cb19346));
-  MAD_F_MLA(hi, lo, X[10], -MAD_F(0x09bd7ca0));
-  MAD_F_MLA(hi, lo, X[16], -MAD_F(0x0216a2a2));
-  t5 = MAD_F_MLZ(hi, lo) - t6;
-
-  MAD_F_ML0(hi, lo, X[0],   MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[2],   MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[3],  -MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[5],  -MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[6],   MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[8],  -MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[9],   MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[11],  MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[12], -MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[14],  MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[15], -MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[17], -MAD_F(0x0f9ee890));
-  x[11] = -(x[6] = MAD_F_MLZ(hi, lo) + t1);
-
-  MAD_F_ML0(hi, lo, X[0],  -MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[2],  -MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[3],   MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[5],   MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[6],   MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[8],  -MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[9],  -MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[11], -MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[12], -MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[14],  MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[15],  MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[17],  MAD_F(0x04cfb0e2));
-  x[23] = x[30] = MAD_F_MLZ(hi, lo) + t1;
-
-  MAD_F_ML0(hi, lo, X[0],  -MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[2],   MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[3],  -MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[5],   MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[6],   MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[8],  -MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[9],  -MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[11],  MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[12], -MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[14],  MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[15],  MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[17], -MAD_F(0x0acf37ad));
-  x[18] = x[35] = MAD_F_MLZ(hi, lo) - t1;
-
-  MAD_F_ML0(hi, lo, X[4],   MAD_F(0x061f78aa));
-  MAD_F_MLA(hi, lo, X[13], -MAD_F(0x0ec835e8));
-  t3+= (t7 = MAD_F_MLZ(hi, lo));
+  IMDCT_ML0(hi, lo, X[1],  -MAD_F(0x09bd7ca0));
+  IMDCT_MLA(hi, lo, X[7],   MAD_F(0x0216a2a2));
+  IMDCT_MLA(hi, lo, X[10], -MAD_F(0x0fdcf549));
+  IMDCT_MLA(hi, lo, X[16],  MAD_F(0x0cb19346));
+  t1 = IMDCT_MLZ(hi, lo) + t6;
+
+  IMDCT_ML0(hi, lo, X[1],  -MAD_F(0x0216a2a2));
+  IMDCT_MLA(hi, lo, X[7],  -MAD_F(0x09bd7ca0));
+  IMDCT_MLA(hi, lo, X[10],  MAD_F(0x0cb19346));
+  IMDCT_MLA(hi, lo, X[16],  MAD_F(0x0fdcf549));
+  t3 = IMDCT_MLZ(hi, lo);
+
+  IMDCT_ML0(hi, lo, X[1],  -MAD_F(0x0fdcf549));
+  IMDCT_MLA(hi, lo, X[7],  -MAD_F(0x0cb19346));
+  IMDCT_MLA(hi, lo, X[10], -MAD_F(0x09bd7ca0));
+  IMDCT_MLA(hi, lo, X[16], -MAD_F(0x0216a2a2));
+  t5 = IMDCT_MLZ(hi, lo) - t6;
+
+  IMDCT_ML0(hi, lo, X[0],   MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[2],   MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[3],  -MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[5],  -MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[6],   MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[8],  -MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[9],   MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[11],  MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[12], -MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[14],  MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[15], -MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[17], -MAD_F(0x0f9ee890));
+  x[11] = -(x[6] = IMDCT_MLZ(hi, lo) + t1);
+
+  IMDCT_ML0(hi, lo, X[0],  -MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[2],  -MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[3],   MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[5],   MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[6],   MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[8],  -MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[9],  -MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[11], -MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[12], -MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[14],  MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[15],  MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[17],  MAD_F(0x04cfb0e2));
+  x[23] = x[30] = IMDCT_MLZ(hi, lo) + t1;
+
+  IMDCT_ML0(hi, lo, X[0],  -MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[2],   MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[3],  -MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[5],   MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[6],   MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[8],  -MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[9],  -MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[11],  MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[12], -MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[14],  MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[15],  MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[17], -MAD_F(0x0acf37ad));
+  x[18] = x[35] = IMDCT_MLZ(hi, lo) - t1;
+
+  IMDCT_ML0(hi, lo, X[4],   MAD_F(0x061f78aa));
+  IMDCT_MLA(hi, lo, X[13], -MAD_F(0x0ec835e8));
+  t3+= (t7 = IMDCT_MLZ(hi, lo));
   t4-= t7;
 
-  MAD_F_MLA(hi, lo, X[1],  -MAD_F(0x0cb19346));
-  MAD_F_MLA(hi, lo, X[7],   MAD_F(0x0fdcf549));
-  MAD_F_MLA(hi, lo, X[10],  MAD_F(0x0216a2a2));
-  MAD_F_MLA(hi, lo, X[16], -MAD_F(0x09bd7ca0));
-  t2 = MAD_F_MLZ(hi, lo);
-
-  MAD_F_MLA(hi, lo, X[0],   MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[2],   MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[3],  -MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[5],   MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[6],  -MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[8],  -MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[9],   MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[11], -MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[12],  MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[14],  MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[15],  MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[17],  MAD_F(0x0f426cb5));
-  x[12] = -(x[5] = MAD_F_MLZ(hi, lo));
-
-  MAD_F_ML0(hi, lo, X[0],   MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[2],  -MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[3],   MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[5],  -MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[6],  -MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[8],   MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[9],  -MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[11],  MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[12], -MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[14],  MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[15],  MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[17], -MAD_F(0x0bcbe352));
-  x[17] = -(x[0] = MAD_F_MLZ(hi, lo) + t2);
-
-  MAD_F_ML0(hi, lo, X[0],  -MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[2],  -MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[3],  -MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[5],   MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[6],   MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[8],   MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[9],   MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[11], -MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[12], -MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[14], -MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[15], -MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[17], -MAD_F(0x03768962));
-  x[24] = x[29] = MAD_F_MLZ(hi, lo) + t2;
-
-  MAD_F_ML0(hi, lo, X[0],   MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[2],   MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[3],  -MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[5],  -MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[6],   MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[8],   MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[9],  -MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[11], -MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[12],  MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[14],  MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[15], -MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[17], -MAD_F(0x0ffc19fd));
-  x[9] = -(x[8] = MAD_F_MLZ(hi, lo) + t3);
-
-  MAD_F_ML0(hi, lo, X[0],  -MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[2],   MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[3],   MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[5],  -MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[6],  -MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[8],   MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[9],   MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[11], -MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[12], -MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[14], -MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[15],  MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[17],  MAD_F(0x07635284));
-  x[21] = x[32] = MAD_F_MLZ(hi, lo) + t3;
-
-  MAD_F_ML0(hi, lo, X[0],  -MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[2],   MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[3],   MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[5],  -MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[6],  -MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[8],   MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[9],   MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[11], -MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[12],  MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[14],  MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[15], -MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[17], -MAD_F(0x0898c779));
-  x[20] = x[33] = MAD_F_MLZ(hi, lo) - t3;
-
-  MAD_F_ML0(hi, lo, t12, -MAD_F(0x0ec835e8));
-  MAD_F_MLA(hi, lo, t13,  MAD_F(0x061f78aa));
-  x[22] = x[31] = MAD_F_MLZ(hi, lo) + t0;
-
-  MAD_F_ML0(hi, lo, t12, MAD_F(0x061f78aa));
-  MAD_F_MLA(hi, lo, t13, MAD_F(0x0ec835e8));
-  x[13] = -(x[4] = MAD_F_MLZ(hi, lo) + t4);
+  IMDCT_MLA(hi, lo, X[1],  -MAD_F(0x0cb19346));
+  IMDCT_MLA(hi, lo, X[7],   MAD_F(0x0fdcf549));
+  IMDCT_MLA(hi, lo, X[10],  MAD_F(0x0216a2a2));
+  IMDCT_MLA(hi, lo, X[16], -MAD_F(0x09bd7ca0));
+  t2 = IMDCT_MLZ(hi, lo);
+
+  IMDCT_MLA(hi, lo, X[0],   MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[2],   MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[3],  -MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[5],   MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[6],  -MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[8],  -MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[9],   MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[11], -MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[12],  MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[14],  MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[15],  MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[17],  MAD_F(0x0f426cb5));
+  x[12] = -(x[5] = IMDCT_MLZ(hi, lo));
+
+  IMDCT_ML0(hi, lo, X[0],   MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[2],  -MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[3],   MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[5],  -MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[6],  -MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[8],   MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[9],  -MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[11],  MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[12], -MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[14],  MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[15],  MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[17], -MAD_F(0x0bcbe352));
+  x[17] = -(x[0] = IMDCT_MLZ(hi, lo) + t2);
+
+  IMDCT_ML0(hi, lo, X[0],  -MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[2],  -MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[3],  -MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[5],   MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[6],   MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[8],   MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[9],   MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[11], -MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[12], -MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[14], -MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[15], -MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[17], -MAD_F(0x03768962));
+  x[24] = x[29] = IMDCT_MLZ(hi, lo) + t2;
+
+  IMDCT_ML0(hi, lo, X[0],   MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[2],   MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[3],  -MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[5],  -MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[6],   MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[8],   MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[9],  -MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[11], -MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[12],  MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[14],  MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[15], -MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[17], -MAD_F(0x0ffc19fd));
+  x[9] = -(x[8] = IMDCT_MLZ(hi, lo) + t3);
+
+  IMDCT_ML0(hi, lo, X[0],  -MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[2],   MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[3],   MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[5],  -MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[6],  -MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[8],   MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[9],   MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[11], -MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[12], -MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[14], -MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[15],  MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[17],  MAD_F(0x07635284));
+  x[21] = x[32] = IMDCT_MLZ(hi, lo) + t3;
+
+  IMDCT_ML0(hi, lo, X[0],  -MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[2],   MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[3],   MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[5],  -MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[6],  -MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[8],   MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[9],   MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[11], -MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[12],  MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[14],  MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[15], -MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[17], -MAD_F(0x0898c779));
+  x[20] = x[33] = IMDCT_MLZ(hi, lo) - t3;
+
+  IMDCT_ML0(hi, lo, t12, -MAD_F(0x0ec835e8));
+  IMDCT_MLA(hi, lo, t13,  MAD_F(0x061f78aa));
+  x[22] = x[31] = IMDCT_MLZ(hi, lo) + t0;
+
+  IMDCT_ML0(hi, lo, t12, MAD_F(0x061f78aa));
+  IMDCT_MLA(hi, lo, t13, MAD_F(0x0ec835e8));
+  x[13] = -(x[4] = IMDCT_MLZ(hi, lo) + t4);
   x[16] = -(x[1] = x[1]              + t4);
   x[25] =  x[28] = x[25]             + t4;
 
-  MAD_F_ML0(hi, lo, X[0],   MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[2],   MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[3],   MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[5],   MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[6],   MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[8],  -MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[9],   MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[11], -MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[12],  MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[14], -MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[15],  MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[17], -MAD_F(0x0d7e8807));
-  x[15] = -(x[2] = MAD_F_MLZ(hi, lo) + t5);
-
-  MAD_F_ML0(hi, lo, X[0],   MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[2],   MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[3],   MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[5],   MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[6],  -MAD_F(0x00b2aa3e));
-  MAD_F_MLA(hi, lo, X[8],   MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[9],  -MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[11],  MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[12], -MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[14],  MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[15], -MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[17],  MAD_F(0x0e313245));
-  x[14] = -(x[3] = MAD_F_MLZ(hi, lo) + t5);
-
-  MAD_F_ML0(hi, lo, X[0],  -MAD_F(0x0ffc19fd));
-  MAD_F_MLA(hi, lo, X[2],  -MAD_F(0x0f9ee890));
-  MAD_F_MLA(hi, lo, X[3],  -MAD_F(0x0f426cb5));
-  MAD_F_MLA(hi, lo, X[5],  -MAD_F(0x0e313245));
-  MAD_F_MLA(hi, lo, X[6],  -MAD_F(0x0d7e8807));
-  MAD_F_MLA(hi, lo, X[8],  -MAD_F(0x0bcbe352));
-  MAD_F_MLA(hi, lo, X[9],  -MAD_F(0x0acf37ad));
-  MAD_F_MLA(hi, lo, X[11], -MAD_F(0x0898c779));
-  MAD_F_MLA(hi, lo, X[12], -MAD_F(0x07635284));
-  MAD_F_MLA(hi, lo, X[14], -MAD_F(0x04cfb0e2));
-  MAD_F_MLA(hi, lo, X[15], -MAD_F(0x03768962));
-  MAD_F_MLA(hi, lo, X[17], -MAD_F(0x00b2aa3e));
-  x[26] = x[27] = MAD_F_MLZ(hi, lo) + t5;
+  IMDCT_ML0(hi, lo, X[0],   MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[2],   MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[3],   MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[5],   MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[6],   MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[8],  -MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[9],   MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[11], -MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[12],  MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[14], -MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[15],  MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[17], -MAD_F(0x0d7e8807));
+  x[15] = -(x[2] = IMDCT_MLZ(hi, lo) + t5);
+
+  IMDCT_ML0(hi, lo, X[0],   MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[2],   MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[3],   MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[5],   MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[6],  -MAD_F(0x00b2aa3e));
+  IMDCT_MLA(hi, lo, X[8],   MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[9],  -MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[11],  MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[12], -MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[14],  MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[15], -MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[17],  MAD_F(0x0e313245));
+  x[14] = -(x[3] = IMDCT_MLZ(hi, lo) + t5);
+
+  IMDCT_ML0(hi, lo, X[0],  -MAD_F(0x0ffc19fd));
+  IMDCT_MLA(hi, lo, X[2],  -MAD_F(0x0f9ee890));
+  IMDCT_MLA(hi, lo, X[3],  -MAD_F(0x0f426cb5));
+  IMDCT_MLA(hi, lo, X[5],  -MAD_F(0x0e313245));
+  IMDCT_MLA(hi, lo, X[6],  -MAD_F(0x0d7e8807));
+  IMDCT_MLA(hi, lo, X[8],  -MAD_F(0x0bcbe352));
+  IMDCT_MLA(hi, lo, X[9],  -MAD_F(0x0acf37ad));
+  IMDCT_MLA(hi, lo, X[11], -MAD_F(0x0898c779));
+  IMDCT_MLA(hi, lo, X[12], -MAD_F(0x07635284));
+  IMDCT_MLA(hi, lo, X[14], -MAD_F(0x04cfb0e2));
+  IMDCT_MLA(hi, lo, X[15], -MAD_F(0x03768962));
+  IMDCT_MLA(hi, lo, X[17], -MAD_F(0x00b2aa3e));
+  x[26] = x[27] = IMDCT_MLZ(hi, lo) + t5;
 }
 #  endif /* CPU_COLDFIRE */
 
@@ -2545,9 +2567,10 @@ void imdct36(mad_fixed_t const X[18], mad_fixed_t x[36])
  * DESCRIPTION: perform IMDCT and windowing for long blocks
  */
 static
-void III_imdct_l(mad_fixed_t const X[18], mad_fixed_t z[36],
+void III_imdct_l(imdct_fixed_t const X[18], imdct_fixed_t z[36],
                  unsigned int block_type)
 {
+  imdct_fixed_t const zero = { 0 };
   unsigned int i;
 
   /* IMDCT */
@@ -2561,36 +2584,36 @@ void III_imdct_l(mad_fixed_t const X[18], mad_fixed_t z[36],
 # if 1
     /* loop unrolled implementation */
     for (i = 0; i < 36; i += 4) {
-      z[i + 0] = mad_f_mul(z[i + 0], window_l[i + 0]);
-      z[i + 1] = mad_f_mul(z[i + 1], window_l[i + 1]);
-      z[i + 2] = mad_f_mul(z[i + 2], window_l[i + 2]);
-      z[i + 3] = mad_f_mul(z[i + 3], window_l[i + 3]);
+      z[i + 0] = IMDCT_MUL(z[i + 0], window_l[i + 0]);
+      z[i + 1] = IMDCT_MUL(z[i + 1], window_l[i + 1]);
+      z[i + 2] = IMDCT_MUL(z[i + 2], window_l[i + 2]);
+      z[i + 3] = IMDCT_MUL(z[i + 3], window_l[i + 3]);
     }
 # else
     /* reference implementation */
-    for (i =  0; i < 36; ++i) z[i] = mad_f_mul(z[i], window_l[i]);
+    for (i =  0; i < 36; ++i) z[i] = IMDCT_MUL(z[i], window_l[i]);
 # endif
     break;
 
   case 1:  /* start block */
     for (i =  0; i < 18; i += 3) {
-      z[i + 0] = mad_f_mul(z[i + 0], window_l[i + 0]);
-      z[i + 1] = mad_f_mul(z[i + 1], window_l[i + 1]);
-      z[i + 2] = mad_f_mul(z[i + 2], window_l[i + 2]);
+      z[i + 0] = IMDCT_MUL(z[i + 0], window_l[i + 0]);
+      z[i + 1] = IMDCT_MUL(z[i + 1], window_l[i + 1]);
+      z[i + 2] = IMDCT_MUL(z[i + 2], window_l[i + 2]);
     }
     /*  (i = 18; i < 24; ++i) z[i] unchanged */
-    for (i = 24; i < 30; ++i) z[i] = mad_f_mul(z[i], window_s[i - 18]);
-    for (i = 30; i < 36; ++i) z[i] = 0;
+    for (i = 24; i < 30; ++i) z[i] = IMDCT_MUL(z[i], window_s[i - 18]);
+    for (i = 30; i < 36; ++i) z[i] = zero;
     break;
 
   case 3:  /* stop block */
-    for (i =  0; i <  6; ++i) z[i] = 0;
-    for (i =  6; i < 12; ++i) z[i] = mad_f_mul(z[i], window_s[i - 6]);
+    for (i =  0; i <  6; ++i) z[i] = zero;
+    for (i =  6; i < 12; ++i) z[i] = IMDCT_MUL(z[i], window_s[i - 6]);
     /*  (i = 12; i < 18; ++i) z[i] unchanged */
     for (i = 18; i < 36; i += 3) {
-      z[i + 0] = mad_f_mul(z[i + 0], window_l[i + 0]);
-      z[i + 1] = mad_f_mul(z[i + 1], window_l[i + 1]);
-      z[i + 2] = mad_f_mul(z[i + 2], window_l[i + 2]);
+      z[i + 0] = IMDCT_MUL(z[i + 0], window_l[i + 0]);
+      z[i + 1] = IMDCT_MUL(z[i + 1], window_l[i + 1]);
+      z[i + 2] = IMDCT_MUL(z[i + 2], window_l[i + 2]);
     }
     break;
   }
@@ -2607,13 +2630,14 @@ void III_imdct_s(mad_fixed_t const X[18], mad_fixed_t z[36]);
 #else
 
 static
-void III_imdct_s(mad_fixed_t const X[18], mad_fixed_t z[36])
+void III_imdct_s(imdct_fixed_t const X[18], imdct_fixed_t z[36])
 {
-  mad_fixed_t y[36], *yptr;
+  imdct_fixed_t const zero = { 0 };
+  imdct_fixed_t y[36], *yptr;
   mad_fixed_t const *wptr;
   int w, i;
-  register mad_fixed64hi_t hi;
-  register mad_fixed64lo_t lo;
+  register imdct_hi_t hi;
+  register imdct_lo_t lo;
 
   /* IMDCT */
 
@@ -2625,26 +2649,26 @@ void III_imdct_s(mad_fixed_t const X[18], mad_fixed_t z[36])
     s = imdct_s;
 
     for (i = 0; i < 3; ++i) {
-      MAD_F_ML0(hi, lo, X[0], (*s)[0]);
-      MAD_F_MLA(hi, lo, X[1], (*s)[1]);
-      MAD_F_MLA(hi, lo, X[2], (*s)[2]);
-      MAD_F_MLA(hi, lo, X[3], (*s)[3]);
-      MAD_F_MLA(hi, lo, X[4], (*s)[4]);
-      MAD_F_MLA(hi, lo, X[5], (*s)[5]);
-
-      yptr[i + 0] = MAD_F_MLZ(hi, lo);
+      IMDCT_ML0(hi, lo, X[0], (*s)[0]);
+      IMDCT_MLA(hi, lo, X[1], (*s)[1]);
+      IMDCT_MLA(hi, lo, X[2], (*s)[2]);
+      IMDCT_MLA(hi, lo, X[3], (*s)[3]);
+      IMDCT_MLA(hi, lo, X[4], (*s)[4]);
+      IMDCT_MLA(hi, lo, X[5], (*s)[5]);
+
+      yptr[i + 0] = IMDCT_MLZ(hi, lo);
       yptr[5 - i] = -yptr[i + 0];
 
       ++s;
 
-      MAD_F_ML0(hi, lo, X[0], (*s)[0]);
-      MAD_F_MLA(hi, lo, X[1], (*s)[1]);
-      MAD_F_MLA(hi, lo, X[2], (*s)[2]);
-      MAD_F_MLA(hi, lo, X[3], (*s)[3]);
-      MAD_F_MLA(hi, lo, X[4], (*s)[4]);
-      MAD_F_MLA(hi, lo, X[5], (*s)[5]);
+      IMDCT_ML0(hi, lo, X[0], (*s)[0]);
+      IMDCT_MLA(hi, lo, X[1], (*s)[1]);
+      IMDCT_MLA(hi, lo, X[2], (*s)[2]);
+      IMDCT_MLA(hi, lo, X[3], (*s)[3]);
+      IMDCT_MLA(hi, lo, X[4], (*s)[4]);
+      IMDCT_MLA(hi, lo, X[5], (*s)[5]);
 
-      yptr[ i + 6] = MAD_F_MLZ(hi, lo);
+      yptr[ i + 6] = IMDCT_MLZ(hi, lo);
       yptr[11 - i] = yptr[i + 6];
 
       ++s;
@@ -2660,21 +2684,21 @@ void III_imdct_s(mad_fixed_t const X[18], mad_fixed_t z[36])
   wptr = &window_s[0];
 
   for (i = 0; i < 6; ++i) {
-    z[i +  0] = 0;
-    z[i +  6] = mad_f_mul(yptr[ 0 + 0], wptr[0]);
+    z[i +  0] = zero;
+    z[i +  6] = IMDCT_MUL(yptr[ 0 + 0], wptr[0]);
 
-    MAD_F_ML0(hi, lo, yptr[ 0 + 6], wptr[6]);
-    MAD_F_MLA(hi, lo, yptr[12 + 0], wptr[0]);
+    IMDCT_ML0(hi, lo, yptr[ 0 + 6], wptr[6]);
+    IMDCT_MLA(hi, lo, yptr[12 + 0], wptr[0]);
 
-    z[i + 12] = MAD_F_MLZ(hi, lo);
+    z[i + 12] = IMDCT_MLZ(hi, lo);
 
-    MAD_F_ML0(hi, lo, yptr[12 + 6], wptr[6]);
-    MAD_F_MLA(hi, lo, yptr[24 + 0], wptr[0]);
+    IMDCT_ML0(hi, lo, yptr[12 + 6], wptr[6]);
+    IMDCT_MLA(hi, lo, yptr[24 + 0], wptr[0]);
 
-    z[i + 18] = MAD_F_MLZ(hi, lo);
+    z[i + 18] = IMDCT_MLZ(hi, lo);
 
-    z[i + 24] = mad_f_mul(yptr[24 + 6], wptr[6]);
-    z[i + 30] = 0;
+    z[i + 24] = IMDCT_MUL(yptr[24 + 6], wptr[6]);
+    z[i + 30] = zero;
 
     ++yptr;
     ++wptr;
@@ -2683,6 +2707,88 @@ void III_imdct_s(mad_fixed_t const X[18], mad_fixed_t z[36])
 
 #endif
 
+# if defined(MAD_SIMD)
+/* negates the odd subbands of a group, see III_freqinver() */
+static mad_vec_t const freqinver_odd = { 0, -1, 0, -1 };
+
+/*
+ * NAME:        III_imdct_group()
+ * DESCRIPTION: perform IMDCT, windowing, overlap-add and frequency inversion
+ *              of subbands sb..sb+3, with bt01 the block type of subbands 0-1
+ */
+static
+void III_imdct_group(mad_fixed_t const xr[576], unsigned int sb,
+                     unsigned int bt01, unsigned int block_type,
+                     mad_fixed_t overlap[18][32], mad_fixed_t sample[18][32])
+{
+  mad_fixed_t const *row[4];
+  mad_vec_t X[18], z[36], z01[36], v;
+  unsigned int i, k;
+
+  for (k = 0; k < 4; ++k)
+    row[k] = &xr[18 * (sb + k)];
+
+  for (i = 0; i < 16; i += 4) {
+    for (k = 0; k < 4; ++k)
+      X[i + k] = *(mad_vec_u_t const *) &row[k][i];
+    mad_vec_transpose4(&X[i]);
+  }
+  for (i = 16; i < 18; ++i)
+    X[i] = (mad_vec_t) { row[0][i], row[1][i], row[2][i], row[3][i] };
+
+  if (block_type == 2)
+    III_imdct_s(X, z);
+  else
+    III_imdct_l(X, z, block_type);
+
+  /* mixed blocks */
+  if (bt01 != block_type) {
+    if (bt01 == 2)
+      III_imdct_s(X, z01);
+    else
+      III_imdct_l(X, z01, bt01);
+
+    for (i = 0; i < 36; ++i)
+      z[i] = mad_vec_shuffle(z01[i], z[i], 0, 1, 6, 7);
+  }
+
+  for (i = 0; i < 18; ++i) {
+    v = z[i] + *(mad_vec_u_t const *) &overlap[i][sb];
+    *(mad_vec_u_t *) &overlap[i][sb] = z[i + 18];
+
+    if (i & 1)
+      v = (v ^ freqinver_odd) - freqinver_odd;
+
+    *(mad_vec_u_t *) &sample[i][sb] = v;
+  }
+}
+
+/*
+ * NAME:        III_overlap_z_group()
+ * DESCRIPTION: perform "overlap-add" and frequency inversion of zero IMDCT
+ *              outputs for subbands sb..sb+3
+ */
+static
+void III_overlap_z_group(unsigned int sb,
+                         mad_fixed_t overlap[18][32], mad_fixed_t sample[18][32])
+{
+  mad_vec_t const zero = { 0 };
+  mad_vec_t v;
+  unsigned int i;
+
+  for (i = 0; i < 18; ++i) {
+    v = *(mad_vec_u_t const *) &overlap[i][sb];
+    *(mad_vec_u_t *) &overlap[i][sb] = zero;
+
+    if (i & 1)
+      v = (v ^ freqinver_odd) - freqinver_odd;
+
+    *(mad_vec_u_t *) &sample[i][sb] = v;
+  }
+}
+
+# else
+
 #ifdef CPU_ARM
 void III_overlap(mad_fixed_t const output[36], mad_fixed_t overlap[18],
                  mad_fixed_t sample[18][32], unsigned int sb);
@@ -2731,6 +2837,8 @@ void III_freqinver(mad_fixed_t sample[18][32], unsigned int sb)
      sample[i][sb] = -sample[i][sb];
 }
 
+# endif  /* MAD_SIMD */
+
 /*
  * NAME:        III_decode()
  * DESCRIPTION: decode frame main_data
@@ -2807,8 +2915,16 @@ enum mad_error III_decode(struct mad_bitptr *ptr, struct mad_frame *frame,
     for (ch = 0; ch < nch; ++ch) {
       struct channel const *channel = &granule->ch[ch];
       mad_fixed_t (*sample)[32] = &((*frame->sbsample)[ch][18 * gr]);
-      unsigned int sb, l, i, sblimit;
+      unsigned int sb, i, sblimit;
+# if defined(MAD_SIMD)
+      /* the overlap of a channel is kept as [18][32] here, so that subbands
+         next to each other are next to each other in memory */
+      mad_fixed_t (*overlap)[32] = (mad_fixed_t (*)[32]) (*frame->overlap)[ch];
+      unsigned int bt01;
+# else
+      unsigned int l;
       mad_fixed_t output[36];
+# endif
 
       if (channel->block_type == 2) {
         III_reorder(xr[ch], channel, sfbwidth[ch]);
@@ -2828,6 +2944,41 @@ enum mad_error III_decode(struct mad_bitptr *ptr, struct mad_frame *frame,
       else
         III_aliasreduce(xr[ch], 576);
 
+      /* last nonzero subband */
+
+/*
+      i = 576;
+      while (i > 36 && xr[ch][i - 1] == 0)
+        --i;
+*/
+
+      {
+          /* saves ~600k cycles */
+          mad_fixed_t *p = &xr[ch][576];
+          mad_fixed_t tmp = xr[ch][35];
+          xr[ch][35] = 1;
+          while (!*--p);
+          xr[ch][35] = tmp;
+          i = p - &xr[ch][0] + 1;
+      }
+      sblimit = 32 - (576 - i) / 18;
+
+# if defined(MAD_SIMD)
+      /* subbands 0-31, four at a time */
+
+      bt01 = channel->block_type;
+      if (channel->flags & mixed_block_flag)
+        bt01 = 0;
+
+      for (sb = 0; sb < sblimit; sb += 4)
+        III_imdct_group(xr[ch], sb, sb ? channel->block_type : bt01,
+                        channel->block_type, overlap, sample);
+
+      /* remaining (zero) subbands */
+
+      for (; sb < 32; sb += 4)
+        III_overlap_z_group(sb, overlap, sample);
+# else
       l = 0;
 
       /* subbands 0-1 */
@@ -2857,23 +3008,6 @@ enum mad_error III_decode(struct mad_bitptr *ptr, struct mad_frame *frame,
 
       /* (nonzero) subbands 2-31 */
 
-/*
-      i = 576;
-      while (i > 36 && xr[ch][i - 1] == 0)
-        --i;
-*/
-
-      {
-          /* saves ~600k cycles */
-          mad_fixed_t *p = &xr[ch][576];
-          mad_fixed_t tmp = xr[ch][35];
-          xr[ch][35] = 1;
-          while (!*--p);
-          xr[ch][35] = tmp;
-          i = p - &xr[ch][0] + 1;
-      }
-      sblimit = 32 - (576 - i) / 18;
-
       if (channel->block_type != 2) {
         /* long blocks */
         for (sb = 2; sb < sblimit; ++sb, l += 18) {
@@ -2903,6 +3037,7 @@ enum mad_error III_decode(struct mad_bitptr *ptr, struct mad_frame *frame,
         if (sb & 1)
           III_freqinver(sample, sb);
       }
+# endif
     }
   }
 
@@ -29,6 +29,10 @@
 # include "frame.h"
 # include "synth.h"
 
+#if defined(MAD_SIMD)
+static void synth_init_simd(void);
+#endif
+
 /*
  * NAME:        synth->init()
  * DESCRIPTION: initialize synth struct
@@ -46,6 +50,8 @@ void mad_synth_init(struct mad_synth *synth)
   /* init the emac unit here, since this function should always be called
      before using libmad */
   coldfire_set_macsr(EMAC_FRACTIONAL | EMAC_SATURATE | EMAC_ROUND);
+  #elif defined(MAD_SIMD)
+  synth_init_simd();
   #endif
 }
 
@@ -96,7 +102,9 @@ void dct32(mad_fixed_t const in[32], unsigned int slot,
 # endif
 
 /* second SSO shift, with rounding */
-# if defined(OPT_SSO)
+# if defined(MAD_SIMD)
+#  define SHIFT(x)  mad_f_vround12(x)
+# elif defined(OPT_SSO)
 #  define SHIFT(x)  (((x) + (1L << 11)) >> 12)
 # else
 #  define SHIFT(x)  (x)
@@ -136,41 +144,91 @@ void dct32(mad_fixed_t const in[32], unsigned int slot,
        MAD_F_MLX(hi, lo, (x), (y));  \
        hi << (32 - MAD_F_SCALEBITS - 3);  \
     })
+# elif defined(MAD_SIMD)
+#  define MUL(x, y)  mad_f_mul_vec((x), (y>>3))
 # else
 #  define MUL(x, y)  mad_f_mul((x), (y>>3))
 # endif
 
+# if defined(MAD_SIMD)
+/* synth_full() runs the DCT for four slots at once, one in each lane */
+typedef mad_vec_t dct_fixed_t;
+#  define DCT32_SLOTS 1
+
+/*
+ * The scalar code evaluates ((m * 2 - t[0]) * 2 - t[1]) ... in long, so the
+ * four outputs below can exceed 32 bits before the final SHIFT(). Carry the
+ * value as q * 4096 + r in the lanes to get the same result.
+ */
+static inline
+mad_vec_t dct_chain(mad_vec_t m, mad_vec_t const t[], int n)
+{
+  mad_vec_t q = m >> 12, r = m & 0xfff;
+  int i;
+
+  for (i = 0; i < n; ++i) {
+    q = q * 2 - (t[i] >> 12);
+    r = r * 2 - (t[i] & 0xfff);
+    q += r >> 12;
+    r &= 0xfff;
+  }
+
+  return q + ((r + (1 << 11)) >> 12);
+}
+
+#  define SHIFT_CHAIN1(m, a)  \
+     dct_chain((m), (mad_vec_t const []) { a }, 1)
+#  define SHIFT_CHAIN2(m, a, b)  \
+     dct_chain((m), (mad_vec_t const []) { a, b }, 2)
+#  define SHIFT_CHAIN3(m, a, b, c)  \
+     dct_chain((m), (mad_vec_t const []) { a, b, c }, 3)
+#  define SHIFT_CHAIN4(m, a, b, c, d)  \
+     dct_chain((m), (mad_vec_t const []) { a, b, c, d }, 4)
+# else
+typedef mad_fixed_t dct_fixed_t;
+#  define DCT32_SLOTS 8
+
+#  define SHIFT_CHAIN1(m, a)  \
+     SHIFT(((m) * 2) - (a))
+#  define SHIFT_CHAIN2(m, a, b)  \
+     SHIFT(((((m) * 2) - (a)) * 2) - (b))
+#  define SHIFT_CHAIN3(m, a, b, c)  \
+     SHIFT(((((((m) * 2) - (a)) * 2) - (b)) * 2) - (c))
+#  define SHIFT_CHAIN4(m, a, b, c, d)  \
+     SHIFT(((((((((m) * 2) - (a)) * 2) - (b)) * 2) - (c)) * 2) - (d))
+# endif
+
 /*
  * NAME:        dct32()
  * DESCRIPTION: perform fast in[32]->out[32] DCT
  */
 static
-void dct32(mad_fixed_t const in[32], unsigned int slot,
-           mad_fixed_t lo[16][8], mad_fixed_t hi[16][8])
+void dct32(dct_fixed_t const in[32], unsigned int slot,
+           dct_fixed_t lo[16][DCT32_SLOTS], dct_fixed_t hi[16][DCT32_SLOTS])
 {
-  mad_fixed_t t0,   t1,   t2,   t3,   t4,   t5,   t6,   t7;
-  mad_fixed_t t8,   t9,   t10,  t11,  t12,  t13,  t14,  t15;
-  mad_fixed_t t16,  t17,  t18,  t19,  t20,  t21,  t22,  t23;
-  mad_fixed_t t24,  t25,  t26,  t27,  t28,  t29,  t30,  t31;
-  mad_fixed_t t32,  t33,  t34,  t35,  t36,  t37,  t38,  t39;
-  mad_fixed_t t40,  t41,  t42,  t43,  t44,  t45,  t46,  t47;
-  mad_fixed_t t48,  t49,  t50,  t51,  t52,  t53,  t54,  t55;
-  mad_fixed_t t56,  t57,  t58,  t59,  t60,  t61,  t62,  t63;
-  mad_fixed_t t64,  t65,  t66,  t67,  t68,  t69,  t70,  t71;
-  mad_fixed_t t72,  t73,  t74,  t75,  t76,  t77,  t78,  t79;
-  mad_fixed_t t80,  t81,  t82,  t83,  t84,  t85,  t86,  t87;
-  mad_fixed_t t88,  t89,  t90,  t91,  t92,  t93,  t94,  t95;
-  mad_fixed_t t96,  t97,  t98,  t99,  t100, t101, t102, t103;
-  mad_fixed_t t104, t105, t106, t107, t108, t109, t110, t111;
-  mad_fixed_t t112, t113, t114, t115, t116, t117, t118, t119;
-  mad_fixed_t t120, t121, t122, t123, t124, t125, t126, t127;
-  mad_fixed_t t128, t129, t130, t131, t132, t133, t134, t135;
-  mad_fixed_t t136, t137, t138, t139, t140, t141, t142, t143;
-  mad_fixed_t t144, t145, t146, t147, t148, t149, t150, t151;
-  mad_fixed_t t152, t153, t154, t155, t156, t157, t158, t159;
-  mad_fixed_t t160, t161, t162, t163, t164, t165, t166, t167;
-  mad_fixed_t t168, t169, t170, t171, t172, t173, t174, t175;
-  mad_fixed_t t176;
+  dct_fixed_t t0,   t1,   t2,   t3,   t4,   t5,   t6,   t7;
+  dct_fixed_t t8,   t9,   t10,  t11,  t12,  t13,  t14,  t15;
+  dct_fixed_t t16,  t17,  t18,  t19,  t20,  t21,  t22,  t23;
+  dct_fixed_t t24,  t25,  t26,  t27,  t28,  t29,  t30,  t31;
+  dct_fixed_t t32,  t33,  t34,  t35,  t36,  t37,  t38,  t39;
+  dct_fixed_t t40,  t41,  t42,  t43,  t44,  t45,  t46,  t47;
+  dct_fixed_t t48,  t49,  t50,  t51,  t52,  t53,  t54,  t55;
+  dct_fixed_t t56,  t57,  t58,  t59,  t60,  t61,  t62,  t63;
+  dct_fixed_t t64,  t65,  t66,  t67,  t68,  t69,  t70,  t71;
+  dct_fixed_t t72,  t73,  t74,  t75,  t76,  t77,  t78,  t79;
+  dct_fixed_t t80,  t81,  t82,  t83,  t84,  t85,  t86,  t87;
+  dct_fixed_t t88,  t89,  t90,  t91,  t92,  t93,  t94,  t95;
+  dct_fixed_t t96,  t97,  t98,  t99,  t100, t101, t102, t103;
+  dct_fixed_t t104, t105, t106, t107, t108, t109, t110, t111;
+  dct_fixed_t t112, t113, t114, t115, t116, t117, t118, t119;
+  dct_fixed_t t120, t121, t122, t123, t124, t125, t126, t127;
+  dct_fixed_t t128, t129, t130, t131, t132, t133, t134, t135;
+  dct_fixed_t t136, t137, t138, t139, t140, t141, t142, t143;
+  dct_fixed_t t144, t145, t146, t147, t148, t149, t150, t151;
+  dct_fixed_t t152, t153, t154, t155, t156, t157, t158, t159;
+  dct_fixed_t t160, t161, t162, t163, t164, t165, t166, t167;
+  dct_fixed_t t168, t169, t170, t171, t172, t173, t174, t175;
+  dct_fixed_t t176;
 
   /* costab[i] = cos(PI / (2 * 32) * i) */
 #define costab1   MAD_F(0x7fd8878e) /* 0.998795456 */
@@ -359,7 +417,7 @@ void dct32(mad_fixed_t const in[32], unsigned int slot,
 
   /*  8 */ hi[ 7][slot] = SHIFT(t143);
   /* 24 */ lo[ 8][slot] =
-             SHIFT((MUL(t141 - t142, costab16) * 2) - t143);
+             SHIFT_CHAIN1(MUL(t141 - t142, costab16), t143);
 
   t144 = MUL(t73 - t74, costab8);
   t145 = MUL(t75 - t76, costab24);
@@ -399,7 +457,7 @@ void dct32(mad_fixed_t const in[32], unsigned int slot,
 
   /* 20 */ lo[ 4][slot] = SHIFT(t160);
   /* 28 */ lo[12][slot] =
-             SHIFT((((MUL(t157 - t158, costab16) * 2) - t159) * 2) - t160);
+             SHIFT_CHAIN2(MUL(t157 - t158, costab16), t159, t160);
 
   t161 = MUL(t94 - t95, costab8);
   t162 = MUL(t96 - t97, costab24);
@@ -437,8 +495,7 @@ void dct32(mad_fixed_t const in[32], unsigned int slot,
 
   /* 26 */ lo[10][slot] = SHIFT(t170);
   /* 30 */ lo[14][slot] =
-             SHIFT((((((MUL(t166 - t167, costab16) * 2) -
-                       t168) * 2) - t169) * 2) - t170);
+             SHIFT_CHAIN3(MUL(t166 - t167, costab16), t168, t169, t170);
 
   t171 = MUL(t106 - t107, costab8);
   t172 = MUL(t108 - t109, costab24);
@@ -489,8 +546,8 @@ void dct32(mad_fixed_t const in[32], unsigned int slot,
 
   /* 29 */ lo[13][slot] = SHIFT(t176);
   /* 31 */ lo[15][slot] =
-             SHIFT((((((((MUL(t171 - t172, costab16) * 2) -
-                         t173) * 2) - t174) * 2) - t175) * 2) - t176);
+             SHIFT_CHAIN4(MUL(t171 - t172, costab16),
+                          t173, t174, t175, t176);
 
   /*
    * Totals:
@@ -910,6 +967,160 @@ void synth_full(struct mad_synth *synth, struct mad_frame const *frame,
   }
 }
 
+# elif defined(MAD_SIMD)
+
+/*
+ * Dt[i][sb] = D[sb][i], so that the window coefficients of four consecutive
+ * output samples come from one vector. Columns 17-19 are padding.
+ */
+static mad_fixed_t Dt[32][20] MEM_ALIGN_ATTR;
+
+static void synth_init_simd(void)
+{
+  int i, sb;
+
+  for (i = 0; i < 32; ++i)
+    for (sb = 0; sb < 20; ++sb)
+      Dt[i][sb] = sb < 17 ? D[sb][i] : 0;
+}
+
+/*
+ * Window terms of output samples sb..sb+3: lane k is the sum over j of
+ * f[j][k] * D[sb + k][i[j]], where w[j] = Dt[i[j]]
+ */
+#  define WTERM(j)  (f[j] * *(mad_vec_u_t const *) &w[j][sb])
+
+static inline
+mad_vec_t window4(mad_vec_t const f[8], mad_fixed_t const *const w[8], int sb)
+{
+  return WTERM(0) + WTERM(1) + WTERM(2) + WTERM(3) +
+         WTERM(4) + WTERM(5) + WTERM(6) + WTERM(7);
+}
+#  undef WTERM
+
+/*
+ * Same sums as the generic synth_full() below, computed for four output
+ * samples at a time. The filterbank is stored transposed (see synth.h) so
+ * that the outputs of four consecutive subbands load as one vector. Only the
+ * order of the wrapping 32-bit additions is different, so the result is
+ * identical.
+ */
+static
+void synth_full(struct mad_synth *synth, struct mad_frame const *frame,
+                unsigned int nch, unsigned int ns)
+{
+  static int const order[8] = { 0, 14, 12, 10, 8, 6, 4, 2 };
+  int          p, sb, i, j, k, off;
+  int          io[8], ia[8], iso[8], ise[8];
+  mad_fixed_t const *wo[8], *wa[8], *wso[8], *wse[8];
+  unsigned int phase, ch, s;
+  mad_fixed_t *pcm, (*filter)[2][2][8][16];
+  mad_fixed_t (*sbsample)[36][32];
+  mad_fixed_t (*fe)[16], (*fx)[16], (*fo)[16];
+  mad_vec_t in[32], lo[16][1], hi[16][1], out[4][2][4];
+  mad_vec_t ev[8], ov[8], a, b;
+  mad_vec_t const zero = { 0, 0, 0, 0 };
+  mad_fixed64lo_t sum;
+
+  for (ch = 0; ch < nch; ++ch) {
+    sbsample = &(*frame->sbsample_prev)[ch];
+    filter   = &synth->filter[ch];
+    phase    = synth->phase;
+    pcm      = synth->pcm.samples[ch];
+
+    for (s = 0; s < ns; ++s) {
+      k = s & 3;
+
+      if (k == 0) {
+        /* DCT of slots s..s+3, one in each lane. sbsample has room for all
+           four even when ns isn't a multiple of four; surplus lanes are not
+           used. */
+        for (i = 0; i < 32; i += 4) {
+          for (j = 0; j < 4; ++j)
+            in[i + j] = *(mad_vec_u_t const *) &(*sbsample)[s + j][i];
+          mad_vec_transpose4(&in[i]);
+        }
+
+        dct32(in, 0, lo, hi);
+
+        /* back to one row of subbands per slot */
+        for (i = 0; i < 16; i += 4) {
+          mad_vec_t vl[4], vh[4];
+
+          for (j = 0; j < 4; ++j) {
+            vl[j] = lo[i + j][0];
+            vh[j] = hi[i + j][0];
+          }
+          mad_vec_transpose4(vl);
+          mad_vec_transpose4(vh);
+          for (j = 0; j < 4; ++j) {
+            out[j][0][i >> 2] = vl[j];
+            out[j][1][i >> 2] = vh[j];
+          }
+        }
+      }
+
+      for (i = 0; i < 4; ++i) {
+        ((mad_vec_u_t *) (*filter)[0][phase & 1][phase >> 1])[i] = out[k][0][i];
+        ((mad_vec_u_t *) (*filter)[1][phase & 1][phase >> 1])[i] = out[k][1][i];
+      }
+
+      p   = (phase - 1) & 0xf;
+      off = s & 1;
+
+      fe = (*filter)[0][ phase & 1];
+      fx = (*filter)[0][~phase & 1];
+      fo = (*filter)[1][~phase & 1];
+
+      /* coefficient columns, see PROD_O, PROD_A and PROD_SB */
+      for (j = 0; j < 8; ++j) {
+        io[j]  = p + off + order[j];
+        ia[j]  = p + 1 - off + order[j];
+        ise[j] = 14 + 2 * j + off - p;
+        iso[j] = 15 + 2 * j - off - p;
+      }
+      ise[0] = (off ? 15 : 30) - p;
+      iso[0] = (off ? 30 : 15) - p;
+
+      for (j = 0; j < 8; ++j) {
+        wo[j]  = Dt[io[j]];
+        wa[j]  = Dt[ia[j]];
+        wse[j] = Dt[ise[j]];
+        wso[j] = Dt[iso[j]];
+      }
+
+      sum = 0;
+      for (j = 0; j < 8; ++j)
+        sum += fe[j][0] * D[0][ia[j]] - fx[j][0] * D[0][io[j]];
+      pcm[0] = SHIFT((mad_fixed_t) sum);
+
+      /* samples sb and 32 - sb. There is no fe row 16, which leaves only
+         the fo terms for sample 16; the other sum lands on sample 16 as
+         well but is stored first and overwritten. */
+      for (sb = 1; sb < 17; sb += 4) {
+        for (j = 0; j < 8; ++j) {
+          if (sb < 13)
+            ev[j] = *(mad_vec_u_t const *) &fe[j][sb];
+          else
+            ev[j] = mad_vec_shuffle(*(mad_vec_u_t const *) &fe[j][12], zero,
+                                    1, 2, 3, 4);
+          ov[j] = *(mad_vec_u_t const *) &fo[j][sb - 1];
+        }
+
+        b = window4(ev, wse, sb) + window4(ov, wso, sb);
+        b = mad_vec_shuffle(b, b, 3, 2, 1, 0);
+        *(mad_vec_u_t *) &pcm[29 - sb] = SHIFT(b);
+
+        a = window4(ev, wa, sb) - window4(ov, wo, sb);
+        *(mad_vec_u_t *) &pcm[sb] = SHIFT(a);
+      }
+
+      pcm  += 32;
+      phase = (phase + 1) % 16;
+    }
+  }
+}
+
 # else /* not FPM_COLDFIRE_EMAC and not FPM_ARM */
 
 #define PROD_O(hi, lo, f, ptr, offset) \
@@ -1052,7 +1263,7 @@ void synth_full(struct mad_synth *synth, struct mad_frame const *frame,
     }
   }
 }
-# endif /* FPM_COLDFIRE_EMAC, FPM_ARM */
+# endif /* FPM_COLDFIRE_EMAC, FPM_ARM, MAD_SIMD */
 
 #if 0 /* rockbox: unused */
 /*
@@ -33,8 +33,13 @@ struct mad_pcm {
 };
 
 struct mad_synth {
+# if defined(MAD_SIMD)
+  mad_fixed_t filter[2][2][2][8][16] MEM_ALIGN_ATTR;   /* polyphase filterbank outputs */
+                                        /* [ch][eo][peo][v][s] */
+# else
   mad_fixed_t filter[2][2][2][16][8] MEM_ALIGN_ATTR;   /* polyphase filterbank outputs */
                                         /* [ch][eo][peo][s][v] */
+# endif
 
   unsigned int phase;                   /* current processing phase */
 
@@ -133,6 +133,12 @@ static OPUS_INLINE opus_int16 SAT16(opus_int32 x) {
 #include "cf/fixed_cf.h"
 #endif
 
+#if defined(OPUS_X86_PRESUME_SSE2)
+#include "x86/fixed_sse2.h"
+#elif defined(OPUS_ARM_PRESUME_NEON_INTR)
+#include "arm/fixed_neon.h"
+#endif
+
 #endif
 
 #else /* FIXED_POINT */
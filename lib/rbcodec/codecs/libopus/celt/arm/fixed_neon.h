@@ -0,0 +1,64 @@
+/* Copyright (C) 2026 the Rockbox authors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef FIXED_NEON_H
+#define FIXED_NEON_H
+
+#include <arm_neon.h>
+
+/* Four lane versions of the fixed-point helpers, used by the NEON kernels */
+
+/** MULT16_32_Q15 on four lanes; a holds 16-bit values widened to 32 bits.
+    vqdmulh gives floor(2*b*(a<<16) / 2^32), which is exactly the C macro;
+    it only saturates for -32768 * -2^31, and no window, twiddle or gain
+    is -32768. */
+static OPUS_INLINE int32x4_t MULT16_32_Q15_neon(int32x4_t a, int32x4_t b)
+{
+   return vqdmulhq_s32(b, vshlq_n_s32(a, 16));
+}
+
+/** Loads p[0..3] widened to 32 bits */
+#define opus_load4_s16(p) vmovl_s16(vld1_s16(p))
+
+/** Lanes in reverse order */
+static OPUS_INLINE int32x4_t opus_reverse_s32(int32x4_t x)
+{
+   x = vrev64q_s32(x);
+   return vcombine_s32(vget_high_s32(x), vget_low_s32(x));
+}
+
+/** Sum of all four lanes */
+static OPUS_INLINE opus_val32 opus_hsum_s32(int32x4_t x)
+{
+#ifdef __aarch64__
+   return vaddvq_s32(x);
+#else
+   int32x2_t s = vadd_s32(vget_low_s32(x), vget_high_s32(x));
+   return vget_lane_s32(vpadd_s32(s, s), 0);
+#endif
+}
+
+#endif /* FIXED_NEON_H */
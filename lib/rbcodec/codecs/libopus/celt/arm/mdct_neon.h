@@ -0,0 +1,72 @@
+/* Copyright (C) 2026 the Rockbox authors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef MDCT_NEON_H
+#define MDCT_NEON_H
+
+#define MDCT_BACKWARD_VECTOR
+
+/* Two iterations i and i+1 of the post-rotation in clt_mdct_backward(). The
+   four half iterations (two from each end) go in one vector each for re, im
+   and the twiddles. */
+static OPUS_INLINE void mdct_backward_post_rotate2(kiss_fft_scalar *yp0,
+      kiss_fft_scalar *yp1, const kiss_twiddle_scalar *t, int i, int N2, int N4)
+{
+   /* yp0[0], yp0[2], yp1[-2], yp1[0] and yp0[1], yp0[3], yp1[-1], yp1[1] */
+   int32x4x2_t y = vuzpq_s32(vld1q_s32(yp0), vld1q_s32(yp1-2));
+   int32x4_t im = vcombine_s32(vget_low_s32(y.val[0]), vrev64_s32(vget_high_s32(y.val[0])));
+   int32x4_t re = vcombine_s32(vget_low_s32(y.val[1]), vrev64_s32(vget_high_s32(y.val[1])));
+   const opus_int16 t0s[4] = { t[i], t[i+1], t[N4-i-1], t[N4-i-2] };
+   const opus_int16 t1s[4] = { t[N4+i], t[N4+i+1], t[N2-i-1], t[N2-i-2] };
+   int32x4_t t0 = opus_load4_s16(t0s);
+   int32x4_t t1 = opus_load4_s16(t1s);
+   int32x4_t yr, yi;
+   int32x4x2_t out;
+
+   yr = vaddq_s32(MULT16_32_Q15_neon(t0, re), MULT16_32_Q15_neon(t1, im));
+   yi = vsubq_s32(MULT16_32_Q15_neon(t1, re), MULT16_32_Q15_neon(t0, im));
+
+   /* yp0[0..3] = yr0, yi2, yr1, yi3 and yp1[-2..1] = yr3, yi1, yr2, yi0 */
+   out = vzipq_s32(vcombine_s32(vget_low_s32(yr), vrev64_s32(vget_high_s32(yr))),
+                   vcombine_s32(vget_high_s32(yi), vrev64_s32(vget_low_s32(yi))));
+   vst1q_s32(yp0, out.val[0]);
+   vst1q_s32(yp1-2, out.val[1]);
+}
+
+/* Four iterations of the TDAC mirror; xp1 and wp2 run backwards */
+static OPUS_INLINE void mdct_backward_mirror4(kiss_fft_scalar *xp1,
+      kiss_fft_scalar *yp1, const opus_val16 *wp1, const opus_val16 *wp2)
+{
+   int32x4_t x1 = opus_reverse_s32(vld1q_s32(xp1-3));
+   int32x4_t x2 = vld1q_s32(yp1);
+   int32x4_t w1 = opus_load4_s16(wp1);
+   int32x4_t w2 = opus_reverse_s32(opus_load4_s16(wp2-3));
+   vst1q_s32(yp1, vsubq_s32(MULT16_32_Q15_neon(w2, x2), MULT16_32_Q15_neon(w1, x1)));
+   vst1q_s32(xp1-3, opus_reverse_s32(
+             vaddq_s32(MULT16_32_Q15_neon(w1, x2), MULT16_32_Q15_neon(w2, x1))));
+}
+
+#endif /* MDCT_NEON_H */
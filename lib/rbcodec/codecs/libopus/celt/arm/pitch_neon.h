@@ -0,0 +1,144 @@
+/* Copyright (C) 2026 the Rockbox authors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef PITCH_NEON_H
+#define PITCH_NEON_H
+
+#include "arch.h"
+
+/* MAC16_16 sums are exact in 32 bits, so vmlal can add the products up in
+   any order and still match the C versions. */
+
+#define OVERRIDE_XCORR_KERNEL
+static OPUS_INLINE void xcorr_kernel(const opus_val16 * x, const opus_val16 * y, opus_val32 sum[4], int len)
+{
+   int j;
+   int32x4_t s0, s1, s2, s3;
+   int32x2_t a, b;
+   celt_assert(len>=3);
+   s0 = s1 = s2 = s3 = vdupq_n_s32(0);
+   for (j=0;j<len-3;j+=4)
+   {
+      int16x4_t xj = vld1_s16(x+j);
+      s0 = vmlal_s16(s0, xj, vld1_s16(y+j));
+      s1 = vmlal_s16(s1, xj, vld1_s16(y+j+1));
+      s2 = vmlal_s16(s2, xj, vld1_s16(y+j+2));
+      s3 = vmlal_s16(s3, xj, vld1_s16(y+j+3));
+   }
+   /* { sum(s0), sum(s1), sum(s2), sum(s3) } */
+   a = vpadd_s32(vadd_s32(vget_low_s32(s0), vget_high_s32(s0)),
+                 vadd_s32(vget_low_s32(s1), vget_high_s32(s1)));
+   b = vpadd_s32(vadd_s32(vget_low_s32(s2), vget_high_s32(s2)),
+                 vadd_s32(vget_low_s32(s3), vget_high_s32(s3)));
+   vst1q_s32(sum, vaddq_s32(vld1q_s32(sum), vcombine_s32(a, b)));
+   for (;j<len;j++)
+   {
+      sum[0] = MAC16_16(sum[0],x[j],y[j]);
+      sum[1] = MAC16_16(sum[1],x[j],y[j+1]);
+      sum[2] = MAC16_16(sum[2],x[j],y[j+2]);
+      sum[3] = MAC16_16(sum[3],x[j],y[j+3]);
+   }
+}
+
+#define OVERRIDE_DUAL_INNER_PROD
+static OPUS_INLINE void dual_inner_prod(const opus_val16 *x, const opus_val16 *y01, const opus_val16 *y02,
+      int N, opus_val32 *xy1, opus_val32 *xy2)
+{
+   int i;
+   opus_val32 xy01, xy02;
+   int32x4_t s1 = vdupq_n_s32(0);
+   int32x4_t s2 = vdupq_n_s32(0);
+   for (i=0;i<N-7;i+=8)
+   {
+      int16x8_t xi = vld1q_s16(x+i);
+      int16x8_t a = vld1q_s16(y01+i);
+      int16x8_t b = vld1q_s16(y02+i);
+      s1 = vmlal_s16(s1, vget_low_s16(xi), vget_low_s16(a));
+      s1 = vmlal_s16(s1, vget_high_s16(xi), vget_high_s16(a));
+      s2 = vmlal_s16(s2, vget_low_s16(xi), vget_low_s16(b));
+      s2 = vmlal_s16(s2, vget_high_s16(xi), vget_high_s16(b));
+   }
+   xy01 = opus_hsum_s32(s1);
+   xy02 = opus_hsum_s32(s2);
+   for (;i<N;i++)
+   {
+      xy01 = MAC16_16(xy01, x[i], y01[i]);
+      xy02 = MAC16_16(xy02, x[i], y02[i]);
+   }
+   *xy1 = xy01;
+   *xy2 = xy02;
+}
+
+#define OVERRIDE_CELT_INNER_PROD
+static OPUS_INLINE opus_val32 celt_inner_prod(const opus_val16 *x, const opus_val16 *y,
+      int N)
+{
+   int i;
+   opus_val32 xy;
+   int32x4_t s = vdupq_n_s32(0);
+   for (i=0;i<N-7;i+=8)
+   {
+      int16x8_t a = vld1q_s16(x+i);
+      int16x8_t b = vld1q_s16(y+i);
+      s = vmlal_s16(s, vget_low_s16(a), vget_low_s16(b));
+      s = vmlal_s16(s, vget_high_s16(a), vget_high_s16(b));
+   }
+   xy = opus_hsum_s32(s);
+   for (;i<N;i++)
+      xy = MAC16_16(xy, x[i], y[i]);
+   return xy;
+}
+
+/* Four outputs at a time. The filter runs in place in the decoder, but the
+   newest input a block reads is x[i+5-T], and T >= COMBFILTER_MINPERIOD, so
+   that has already been written by an earlier block like in the C loop. */
+#define OVERRIDE_COMB_FILTER_CONST
+static OPUS_INLINE void comb_filter_const(opus_val32 *y, opus_val32 *x, int T, int N,
+      opus_val16 g10, opus_val16 g11, opus_val16 g12)
+{
+   int i;
+   int32x4_t vg10 = vdupq_n_s32(g10);
+   int32x4_t vg11 = vdupq_n_s32(g11);
+   int32x4_t vg12 = vdupq_n_s32(g12);
+   for (i=0;i<N-3;i+=4)
+   {
+      const opus_val32 *xp = x+i-T;
+      int32x4_t t = vld1q_s32(x+i);
+      t = vaddq_s32(t, MULT16_32_Q15_neon(vg10, vld1q_s32(xp)));
+      t = vaddq_s32(t, MULT16_32_Q15_neon(vg11, vaddq_s32(vld1q_s32(xp+1), vld1q_s32(xp-1))));
+      t = vaddq_s32(t, MULT16_32_Q15_neon(vg12, vaddq_s32(vld1q_s32(xp+2), vld1q_s32(xp-2))));
+      vst1q_s32(y+i, t);
+   }
+   for (;i<N;i++)
+   {
+      y[i] = x[i]
+               + MULT16_32_Q15(g10,x[i-T])
+               + MULT16_32_Q15(g11,ADD32(x[i-T+1],x[i-T-1]))
+               + MULT16_32_Q15(g12,ADD32(x[i-T+2],x[i-T-2]));
+   }
+}
+
+#endif /* PITCH_NEON_H */
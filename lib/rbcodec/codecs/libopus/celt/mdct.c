@@ -57,6 +57,12 @@
 #include "mips/mdct_mipsr1.h"
 #endif
 
+#if defined(OPUS_X86_PRESUME_SSE2) && defined(FIXED_POINT)
+#include "x86/mdct_sse2.h"
+#elif defined(OPUS_ARM_PRESUME_NEON_INTR) && defined(FIXED_POINT)
+#include "arm/mdct_neon.h"
+#endif
+
 
 #ifdef CUSTOM_MODES
 
@@ -289,9 +295,19 @@ void clt_mdct_backward(const mdct_lookup *l, kiss_fft_scalar *in, kiss_fft_scala
       kiss_fft_scalar * yp0 = out+(overlap>>1);
       kiss_fft_scalar * yp1 = out+(overlap>>1)+N2-2;
       const kiss_twiddle_scalar *t = &trig[0];
+      i = 0;
+#ifdef MDCT_BACKWARD_VECTOR
+      /* Both iterations of a step have to stay clear of the middle */
+      for(;i<(N4>>1)-1;i+=2)
+      {
+         mdct_backward_post_rotate2(yp0, yp1, t, i, N2, N4);
+         yp0 += 4;
+         yp1 -= 4;
+      }
+#endif
       /* Loop to (N4+1)>>1 to handle odd N4. When N4 is odd, the
          middle pair will be computed twice. */
-      for(i=0;i<(N4+1)>>1;i++)
+      for(;i<(N4+1)>>1;i++)
       {
          kiss_fft_scalar re, im, yr, yi;
          kiss_twiddle_scalar t0, t1;
@@ -328,7 +344,18 @@ void clt_mdct_backward(const mdct_lookup *l, kiss_fft_scalar *in, kiss_fft_scala
       const opus_val16 * OPUS_RESTRICT wp1 = window;
       const opus_val16 * OPUS_RESTRICT wp2 = window+overlap-1;
 
-      for(i = 0; i < overlap/2; i++)
+      i = 0;
+#ifdef MDCT_BACKWARD_VECTOR
+      for(; i < overlap/2-3; i+=4)
+      {
+         mdct_backward_mirror4(xp1, yp1, wp1, wp2);
+         xp1 -= 4;
+         yp1 += 4;
+         wp1 += 4;
+         wp2 -= 4;
+      }
+#endif
+      for(; i < overlap/2; i++)
       {
          kiss_fft_scalar x1, x2;
          x1 = *xp1;
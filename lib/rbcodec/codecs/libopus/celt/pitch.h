@@ -49,6 +49,12 @@
 //# include "arm/pitch_arm.h"
 #endif
 
+#if defined(OPUS_X86_PRESUME_SSE2) && defined(FIXED_POINT)
+#include "x86/pitch_sse2.h"
+#elif defined(OPUS_ARM_PRESUME_NEON_INTR) && defined(FIXED_POINT)
+#include "arm/pitch_neon.h"
+#endif
+
 void pitch_downsample(celt_sig * OPUS_RESTRICT x[], opus_val16 * OPUS_RESTRICT x_lp,
       int len, int C, int arch);
 
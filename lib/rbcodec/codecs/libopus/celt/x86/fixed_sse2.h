@@ -0,0 +1,93 @@
+/* Copyright (C) 2026 the Rockbox authors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef FIXED_SSE2_H
+#define FIXED_SSE2_H
+
+#include <string.h>
+#include <emmintrin.h>
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+
+/* Four lane versions of the fixed-point helpers, used by the SSE2 kernels.
+   Every lane gives exactly what the scalar macro gives, including the
+   wrap-around on overflow. */
+
+/** MULT16_32_Q15 on four lanes; a holds 16-bit values widened to 32 bits */
+static OPUS_INLINE __m128i MULT16_32_Q15_sse2(__m128i a, __m128i b)
+{
+   __m128i ev, od, res;
+#ifdef __SSE4_1__
+   ev = _mm_mul_epi32(a, b);
+   od = _mm_mul_epi32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+#else
+   ev = _mm_mul_epu32(a, b);
+   od = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+#endif
+   /* bits 15..46 of each product go to the lane it came from */
+   ev = _mm_srli_epi64(ev, 15);
+   od = _mm_slli_epi64(od, 17);
+#ifdef __SSE4_1__
+   res = _mm_blend_epi16(ev, od, 0xcc);
+#else
+   res = _mm_or_si128(_mm_and_si128(ev, _mm_set_epi32(0, -1, 0, -1)),
+                      _mm_and_si128(od, _mm_set_epi32(-1, 0, -1, 0)));
+   /* unsigned products are 2^32*b too big where a < 0, and 2^32*a where b < 0 */
+   res = _mm_sub_epi32(res, _mm_slli_epi32(_mm_add_epi32(
+            _mm_and_si128(_mm_srai_epi32(a, 31), b),
+            _mm_and_si128(_mm_srai_epi32(b, 31), a)), 17));
+#endif
+   return res;
+}
+
+/** Loads p[0..3] widened to 32 bits */
+static OPUS_INLINE __m128i opus_load4_epi16(const opus_int16 *p)
+{
+   __m128i x = _mm_loadl_epi64((const __m128i *)p);
+   return _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+}
+
+/** Loads p[0..1] into the low 32 bits */
+static OPUS_INLINE __m128i opus_load2_epi16(const opus_int16 *p)
+{
+   opus_int32 x;
+   memcpy(&x, p, sizeof(x));
+   return _mm_cvtsi32_si128(x);
+}
+
+/** Lanes in reverse order */
+#define opus_reverse_epi32(x) _mm_shuffle_epi32((x), _MM_SHUFFLE(0, 1, 2, 3))
+
+/** Sum of all four lanes */
+static OPUS_INLINE opus_val32 opus_hsum_epi32(__m128i x)
+{
+   x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+   x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+   return _mm_cvtsi128_si32(x);
+}
+
+#endif /* FIXED_SSE2_H */
@@ -0,0 +1,76 @@
+/* Copyright (C) 2026 the Rockbox authors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef MDCT_SSE2_H
+#define MDCT_SSE2_H
+
+#define MDCT_BACKWARD_VECTOR
+
+/* Two iterations i and i+1 of the post-rotation in clt_mdct_backward(). The
+   four half iterations (two from each end) go in one vector each for re, im
+   and the twiddles. */
+static OPUS_INLINE void mdct_backward_post_rotate2(kiss_fft_scalar *yp0,
+      kiss_fft_scalar *yp1, const kiss_twiddle_scalar *t, int i, int N2, int N4)
+{
+   __m128 f0 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)yp0));
+   __m128 f1 = _mm_castsi128_ps(_mm_loadu_si128((const __m128i *)(yp1-2)));
+   /* yp0[1], yp0[3], yp1[1], yp1[-1] and yp0[0], yp0[2], yp1[0], yp1[-2] */
+   __m128i re = _mm_castps_si128(_mm_shuffle_ps(f0, f1, _MM_SHUFFLE(1, 3, 3, 1)));
+   __m128i im = _mm_castps_si128(_mm_shuffle_ps(f0, f1, _MM_SHUFFLE(0, 2, 2, 0)));
+   /* t[i], t[i+1], t[N4-i-1], t[N4-i-2] and t[N4+i], t[N4+i+1], t[N2-i-1], t[N2-i-2] */
+   __m128i t0 = _mm_unpacklo_epi32(opus_load2_epi16(t+i), opus_load2_epi16(t+N4-i-2));
+   __m128i t1 = _mm_unpacklo_epi32(opus_load2_epi16(t+N4+i), opus_load2_epi16(t+N2-i-2));
+   __m128i yr, yi;
+   t0 = _mm_shufflelo_epi16(t0, _MM_SHUFFLE(2, 3, 1, 0));
+   t1 = _mm_shufflelo_epi16(t1, _MM_SHUFFLE(2, 3, 1, 0));
+   t0 = _mm_srai_epi32(_mm_unpacklo_epi16(t0, t0), 16);
+   t1 = _mm_srai_epi32(_mm_unpacklo_epi16(t1, t1), 16);
+
+   yr = _mm_add_epi32(MULT16_32_Q15_sse2(t0, re), MULT16_32_Q15_sse2(t1, im));
+   yi = _mm_sub_epi32(MULT16_32_Q15_sse2(t1, re), MULT16_32_Q15_sse2(t0, im));
+
+   /* yp0[0..3] = yr0, yi2, yr1, yi3 and yp1[-2..1] = yr3, yi1, yr2, yi0 */
+   yr = _mm_shuffle_epi32(yr, _MM_SHUFFLE(2, 3, 1, 0));
+   yi = _mm_shuffle_epi32(yi, _MM_SHUFFLE(0, 1, 3, 2));
+   _mm_storeu_si128((__m128i *)yp0, _mm_unpacklo_epi32(yr, yi));
+   _mm_storeu_si128((__m128i *)(yp1-2), _mm_unpackhi_epi32(yr, yi));
+}
+
+/* Four iterations of the TDAC mirror; xp1 and wp2 run backwards */
+static OPUS_INLINE void mdct_backward_mirror4(kiss_fft_scalar *xp1,
+      kiss_fft_scalar *yp1, const opus_val16 *wp1, const opus_val16 *wp2)
+{
+   __m128i x1 = opus_reverse_epi32(_mm_loadu_si128((const __m128i *)(xp1-3)));
+   __m128i x2 = _mm_loadu_si128((const __m128i *)yp1);
+   __m128i w1 = opus_load4_epi16(wp1);
+   __m128i w2 = opus_reverse_epi32(opus_load4_epi16(wp2-3));
+   _mm_storeu_si128((__m128i *)yp1,
+                    _mm_sub_epi32(MULT16_32_Q15_sse2(w2, x2), MULT16_32_Q15_sse2(w1, x1)));
+   _mm_storeu_si128((__m128i *)(xp1-3), opus_reverse_epi32(
+                    _mm_add_epi32(MULT16_32_Q15_sse2(w1, x2), MULT16_32_Q15_sse2(w2, x1))));
+}
+
+#endif /* MDCT_SSE2_H */
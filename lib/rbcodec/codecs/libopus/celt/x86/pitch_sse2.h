@@ -0,0 +1,140 @@
+/* Copyright (C) 2026 the Rockbox authors */
+/*
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+
+   - Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+
+   - Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+
+   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+   ``AS IS'' AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER
+   OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+   EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+   PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+   PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+   LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+   NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+   SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifndef PITCH_SSE2_H
+#define PITCH_SSE2_H
+
+#include "arch.h"
+
+/* MAC16_16 sums are exact in 32 bits, so pmaddwd can add the products up in
+   any order and still match the C versions. */
+
+#define OVERRIDE_XCORR_KERNEL
+static OPUS_INLINE void xcorr_kernel(const opus_val16 * x, const opus_val16 * y, opus_val32 sum[4], int len)
+{
+   int j;
+   __m128i s0, s1, s2, s3, a, b;
+   celt_assert(len>=3);
+   s0 = s1 = s2 = s3 = _mm_setzero_si128();
+   for (j=0;j<len-7;j+=8)
+   {
+      __m128i xj = _mm_loadu_si128((const __m128i *)(x+j));
+      s0 = _mm_add_epi32(s0, _mm_madd_epi16(xj, _mm_loadu_si128((const __m128i *)(y+j))));
+      s1 = _mm_add_epi32(s1, _mm_madd_epi16(xj, _mm_loadu_si128((const __m128i *)(y+j+1))));
+      s2 = _mm_add_epi32(s2, _mm_madd_epi16(xj, _mm_loadu_si128((const __m128i *)(y+j+2))));
+      s3 = _mm_add_epi32(s3, _mm_madd_epi16(xj, _mm_loadu_si128((const __m128i *)(y+j+3))));
+   }
+   /* { sum(s0), sum(s1), sum(s2), sum(s3) } */
+   a = _mm_add_epi32(_mm_unpacklo_epi32(s0, s1), _mm_unpackhi_epi32(s0, s1));
+   b = _mm_add_epi32(_mm_unpacklo_epi32(s2, s3), _mm_unpackhi_epi32(s2, s3));
+   a = _mm_add_epi32(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b));
+   _mm_storeu_si128((__m128i *)sum,
+                    _mm_add_epi32(a, _mm_loadu_si128((const __m128i *)sum)));
+   for (;j<len;j++)
+   {
+      sum[0] = MAC16_16(sum[0],x[j],y[j]);
+      sum[1] = MAC16_16(sum[1],x[j],y[j+1]);
+      sum[2] = MAC16_16(sum[2],x[j],y[j+2]);
+      sum[3] = MAC16_16(sum[3],x[j],y[j+3]);
+   }
+}
+
+#define OVERRIDE_DUAL_INNER_PROD
+static OPUS_INLINE void dual_inner_prod(const opus_val16 *x, const opus_val16 *y01, const opus_val16 *y02,
+      int N, opus_val32 *xy1, opus_val32 *xy2)
+{
+   int i;
+   opus_val32 xy01, xy02;
+   __m128i s1 = _mm_setzero_si128();
+   __m128i s2 = _mm_setzero_si128();
+   for (i=0;i<N-7;i+=8)
+   {
+      __m128i xi = _mm_loadu_si128((const __m128i *)(x+i));
+      s1 = _mm_add_epi32(s1, _mm_madd_epi16(xi, _mm_loadu_si128((const __m128i *)(y01+i))));
+      s2 = _mm_add_epi32(s2, _mm_madd_epi16(xi, _mm_loadu_si128((const __m128i *)(y02+i))));
+   }
+   xy01 = opus_hsum_epi32(s1);
+   xy02 = opus_hsum_epi32(s2);
+   for (;i<N;i++)
+   {
+      xy01 = MAC16_16(xy01, x[i], y01[i]);
+      xy02 = MAC16_16(xy02, x[i], y02[i]);
+   }
+   *xy1 = xy01;
+   *xy2 = xy02;
+}
+
+#define OVERRIDE_CELT_INNER_PROD
+static OPUS_INLINE opus_val32 celt_inner_prod(const opus_val16 *x, const opus_val16 *y,
+      int N)
+{
+   int i;
+   opus_val32 xy;
+   __m128i s = _mm_setzero_si128();
+   for (i=0;i<N-7;i+=8)
+      s = _mm_add_epi32(s, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(x+i)),
+                                          _mm_loadu_si128((const __m128i *)(y+i))));
+   xy = opus_hsum_epi32(s);
+   for (;i<N;i++)
+      xy = MAC16_16(xy, x[i], y[i]);
+   return xy;
+}
+
+/* Four outputs at a time. The filter runs in place in the decoder, but the
+   newest input a block reads is x[i+5-T], and T >= COMBFILTER_MINPERIOD, so
+   that has already been written by an earlier block like in the C loop. */
+#define OVERRIDE_COMB_FILTER_CONST
+static OPUS_INLINE void comb_filter_const(opus_val32 *y, opus_val32 *x, int T, int N,
+      opus_val16 g10, opus_val16 g11, opus_val16 g12)
+{
+   int i;
+   __m128i vg10 = _mm_set1_epi32(g10);
+   __m128i vg11 = _mm_set1_epi32(g11);
+   __m128i vg12 = _mm_set1_epi32(g12);
+   for (i=0;i<N-3;i+=4)
+   {
+      const opus_val32 *xp = x+i-T;
+      __m128i x0 = _mm_loadu_si128((const __m128i *)(xp+2));
+      __m128i x1 = _mm_loadu_si128((const __m128i *)(xp+1));
+      __m128i x2 = _mm_loadu_si128((const __m128i *)xp);
+      __m128i x3 = _mm_loadu_si128((const __m128i *)(xp-1));
+      __m128i x4 = _mm_loadu_si128((const __m128i *)(xp-2));
+      __m128i t = _mm_loadu_si128((const __m128i *)(x+i));
+      t = _mm_add_epi32(t, MULT16_32_Q15_sse2(vg10, x2));
+      t = _mm_add_epi32(t, MULT16_32_Q15_sse2(vg11, _mm_add_epi32(x1, x3)));
+      t = _mm_add_epi32(t, MULT16_32_Q15_sse2(vg12, _mm_add_epi32(x0, x4)));
+      _mm_storeu_si128((__m128i *)(y+i), t);
+   }
+   for (;i<N;i++)
+   {
+      y[i] = x[i]
+               + MULT16_32_Q15(g10,x[i-T])
+               + MULT16_32_Q15(g11,ADD32(x[i-T+1],x[i-T-1]))
+               + MULT16_32_Q15(g12,ADD32(x[i-T+2],x[i-T-2]));
+   }
+}
+
+#endif /* PITCH_SSE2_H */
@@ -53,5 +53,14 @@
 #define OPUS_CF_INLINE_ASM
 #endif
 
+/* hosted builds: vector kernels for whatever the compiler targets */
+#if !defined(CPU_ARM) && !defined(CPU_COLDFIRE)
+#if defined(__SSE2__)
+#define OPUS_X86_PRESUME_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define OPUS_ARM_PRESUME_NEON_INTR
+#endif
+#endif
+
 #endif /* CONFIG_H */
 
@@ -0,0 +1,106 @@
+/***********************************************************************
+Copyright (C) 2026 the Rockbox authors.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+- Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+- Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+- Neither the name of Internet Society, IETF or IETF Trust, nor the
+names of specific contributors, may be used to endorse or promote
+products derived from this software without specific prior written
+permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************/
+
+
+#ifndef SILK_DECODE_CORE_NEON_H
+#define SILK_DECODE_CORE_NEON_H
+
+#include <arm_neon.h>
+
+/* Short-term prediction, gain scaling and state update for one subframe of
+   silk_decode_core(), four taps per vector.
+
+   With the coefficient shifted up by 15, vqdmulh gives floor(b*c / 2^16)
+   per lane, which is exactly silk_SMULWB(), and can't saturate as c << 15
+   is never -2^31. The sum doesn't depend on the order of the taps, so this
+   is bit-exact.
+
+   Only the first tap needs the sample from the previous iteration; it's
+   done in scalar code so the vector taps can run ahead. */
+#define OVERRIDE_silk_decode_core_LPC
+static OPUS_INLINE void silk_decode_core_LPC(
+    opus_int32                  *sLPC_Q14,                      /* I/O  LPC state, MAX_LPC_ORDER + length       */
+    const opus_int32            *pres_Q14,                      /* I    LPC excitation                          */
+    opus_int16                  *pxq,                           /* O    Decoded speech                          */
+    const opus_int16            *A_Q12,                         /* I    LPC coefficients                        */
+    const opus_int              order,                          /* I    LPC order, 10 or 16                     */
+    const opus_int              length,                         /* I    Subframe length                         */
+    const opus_int32            Gain_Q10                        /* I    Subframe gain                           */
+)
+{
+    opus_int   i, j, g, groups;
+    opus_int32 LPC_pred_Q10, prev;
+    opus_int32 c[ 4 ][ 4 ];
+    int32x4_t  C[ 4 ], window;
+
+    /* Lane j of group g has A_Q12[ 4 * g + 4 - j ]; past the order it's zero.
+       The last group of order 16 is moved down a tap so that it doesn't
+       read before sLPC_Q14, which puts tap 12 in its lowest lane, zeroed
+       as the previous group has it */
+    groups = order == 16 ? 4 : 3;
+    for( g = 0; g < groups; g++ ) {
+        for( j = 0; j < 4; j++ ) {
+            opus_int k = 4 * g + 4 - j - ( g == 3 );
+            c[ g ][ j ] = k < order && k > 4 * g ? silk_LSHIFT( (opus_int32)A_Q12[ k ], 15 ) : 0;
+        }
+        C[ g ] = vld1q_s32( c[ g ] );
+    }
+
+    /* The samples for A_Q12[ 1..4 ] stay in a register rather than being
+       read back right after they were stored */
+    window = vld1q_s32( &sLPC_Q14[ MAX_LPC_ORDER - 5 ] );
+    prev   = sLPC_Q14[ MAX_LPC_ORDER - 1 ];
+    for( i = 0; i < length; i++ ) {
+        int32x4_t acc = vqdmulhq_s32( window, C[ 0 ] );
+        for( g = 1; g < groups; g++ ) {
+            acc = vaddq_s32( acc, vqdmulhq_s32(
+                vld1q_s32( &sLPC_Q14[ MAX_LPC_ORDER + i - 4 * g - 5 + ( g == 3 ) ] ), C[ g ] ) );
+        }
+
+        /* Avoids introducing a bias because silk_SMLAWB() always rounds to -inf */
+#ifdef __aarch64__
+        LPC_pred_Q10 = silk_RSHIFT( order, 1 ) + vaddvq_s32( acc );
+#else
+        {
+            int32x2_t s = vadd_s32( vget_low_s32( acc ), vget_high_s32( acc ) );
+            LPC_pred_Q10 = silk_RSHIFT( order, 1 ) + vget_lane_s32( vpadd_s32( s, s ), 0 );
+        }
+#endif
+        LPC_pred_Q10 = silk_SMLAWB( LPC_pred_Q10, prev, A_Q12[ 0 ] );
+
+        window = vextq_s32( window, vdupq_n_s32( prev ), 1 );
+
+        /* Add prediction to LPC excitation */
+        prev = silk_ADD_LSHIFT32( pres_Q14[ i ], LPC_pred_Q10, 4 );
+        sLPC_Q14[ MAX_LPC_ORDER + i ] = prev;
+
+        /* Scale with gain */
+        pxq[ i ] = (opus_int16)silk_SAT16( silk_RSHIFT_ROUND( silk_SMULWW( prev, Gain_Q10 ), 8 ) );
+    }
+}
+
+#endif /* SILK_DECODE_CORE_NEON_H */
@@ -32,6 +32,12 @@ POSSIBILITY OF SUCH DAMAGE.
 #include "main.h"
 #include "stack_alloc.h"
 
+#if defined(OPUS_X86_PRESUME_SSE2)
+#include "x86/decode_core_sse2.h"
+#elif defined(OPUS_ARM_PRESUME_NEON_INTR)
+#include "arm/decode_core_neon.h"
+#endif
+
 /**********************************************************/
 /* Core decoder. Performs inverse NSQ operation LTP + LPC */
 /**********************************************************/
@@ -46,7 +52,10 @@ void silk_decode_core(
     opus_int16 *A_Q12, *B_Q14, *pxq, A_Q12_tmp[ MAX_LPC_ORDER ];
     VARDECL( opus_int16, sLTP );
     VARDECL( opus_int32, sLTP_Q15 );
-    opus_int32 LTP_pred_Q13, LPC_pred_Q10, Gain_Q10, inv_gain_Q31, gain_adj_Q16, rand_seed, offset_Q10;
+    opus_int32 LTP_pred_Q13, Gain_Q10, inv_gain_Q31, gain_adj_Q16, rand_seed, offset_Q10;
+#ifndef OVERRIDE_silk_decode_core_LPC
+    opus_int32 LPC_pred_Q10;
+#endif
     opus_int32 *pred_lag_ptr, *pexc_Q14, *pres_Q14;
     VARDECL( opus_int32, res_Q14 );
     VARDECL( opus_int32, sLPC_Q14 );
@@ -193,6 +202,9 @@ void silk_decode_core(
             pres_Q14 = pexc_Q14;
         }
 
+#ifdef OVERRIDE_silk_decode_core_LPC
+        silk_decode_core_LPC( sLPC_Q14, pres_Q14, pxq, A_Q12_tmp, psDec->LPC_order, psDec->subfr_length, Gain_Q10 );
+#else
         for( i = 0; i < psDec->subfr_length; i++ ) {
             /* Short-term prediction */
             silk_assert( psDec->LPC_order == 10 || psDec->LPC_order == 16 );
@@ -223,6 +235,7 @@ void silk_decode_core(
             /* Scale with gain */
             pxq[ i ] = (opus_int16)silk_SAT16( silk_RSHIFT_ROUND( silk_SMULWW( sLPC_Q14[ MAX_LPC_ORDER + i ], Gain_Q10 ), 8 ) );
         }
+#endif
 
         /* DEBUG_STORE_DATA( dec.pcm, pxq, psDec->subfr_length * sizeof( opus_int16 ) ) */
 
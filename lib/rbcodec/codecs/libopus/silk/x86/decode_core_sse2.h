@@ -0,0 +1,116 @@
+/***********************************************************************
+Copyright (C) 2026 the Rockbox authors.
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions
+are met:
+- Redistributions of source code must retain the above copyright notice,
+this list of conditions and the following disclaimer.
+- Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+- Neither the name of Internet Society, IETF or IETF Trust, nor the
+names of specific contributors, may be used to endorse or promote
+products derived from this software without specific prior written
+permission.
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.
+***********************************************************************/
+
+
+#ifndef SILK_DECODE_CORE_SSE2_H
+#define SILK_DECODE_CORE_SSE2_H
+
+#include <emmintrin.h>
+
+/* Short-term prediction, gain scaling and state update for one subframe of
+   silk_decode_core(), four taps per vector.
+
+   silk_SMLAWB() floors every product on its own, so the taps can't just be
+   multiplied out in 32 bits and summed. Each 32 bit sample is instead taken
+   as its 16 bit halves { lo, hi }, with pmulhuw giving floor(lo*c / 2^16)
+   (corrected for c < 0) in place of lo, and pmaddwd then adding c*hi to it.
+   The sum doesn't depend on the order of the taps, so this is bit-exact.
+
+   Only the first tap needs the sample from the previous iteration; it's
+   done in scalar code so the vector taps can run ahead. */
+#define OVERRIDE_silk_decode_core_LPC
+static OPUS_INLINE void silk_decode_core_LPC(
+    opus_int32                  *sLPC_Q14,                      /* I/O  LPC state, MAX_LPC_ORDER + length       */
+    const opus_int32            *pres_Q14,                      /* I    LPC excitation                          */
+    opus_int16                  *pxq,                           /* O    Decoded speech                          */
+    const opus_int16            *A_Q12,                         /* I    LPC coefficients                        */
+    const opus_int              order,                          /* I    LPC order, 10 or 16                     */
+    const opus_int              length,                         /* I    Subframe length                         */
+    const opus_int32            Gain_Q10                        /* I    Subframe gain                           */
+)
+{
+    opus_int   i, j, g, groups;
+    opus_int32 LPC_pred_Q10, prev;
+    opus_int16 c2[ 4 ][ 8 ], cneg[ 4 ][ 8 ], c1[ 4 ][ 8 ];
+    __m128i    C2[ 4 ], CNEG[ 4 ], C1[ 4 ], lo_mask, window;
+
+    /* Lane j of group g has A_Q12[ 4 * g + 4 - j ]; past the order it's zero.
+       The last group of order 16 is moved down a tap so that it doesn't
+       read before sLPC_Q14, which puts tap 12 in its lowest lane, zeroed
+       as the previous group has it */
+    groups = order == 16 ? 4 : 3;
+    for( g = 0; g < groups; g++ ) {
+        for( j = 0; j < 4; j++ ) {
+            opus_int   k = 4 * g + 4 - j - ( g == 3 );
+            opus_int16 c = k < order && k > 4 * g ? A_Q12[ k ] : 0;
+            c2[ g ][ 2 * j ]       = c;
+            c2[ g ][ 2 * j + 1 ]   = c;
+            cneg[ g ][ 2 * j ]     = c < 0 ? -1 : 0;
+            cneg[ g ][ 2 * j + 1 ] = 0;
+            c1[ g ][ 2 * j ]       = 1;
+            c1[ g ][ 2 * j + 1 ]   = c;
+        }
+        C2[ g ]   = _mm_loadu_si128( (const __m128i *)c2[ g ] );
+        CNEG[ g ] = _mm_loadu_si128( (const __m128i *)cneg[ g ] );
+        C1[ g ]   = _mm_loadu_si128( (const __m128i *)c1[ g ] );
+    }
+    lo_mask = _mm_set1_epi32( 0xFFFF );
+
+    /* The samples for A_Q12[ 1..4 ] stay in a register rather than being
+       read back right after they were stored */
+    window = _mm_loadu_si128( (const __m128i *)&sLPC_Q14[ MAX_LPC_ORDER - 5 ] );
+    prev   = sLPC_Q14[ MAX_LPC_ORDER - 1 ];
+    for( i = 0; i < length; i++ ) {
+        __m128i acc = _mm_setzero_si128();
+        for( g = 0; g < groups; g++ ) {
+            __m128i b = g == 0 ? window :
+                _mm_loadu_si128( (const __m128i *)&sLPC_Q14[ MAX_LPC_ORDER + i - 4 * g - 5 + ( g == 3 ) ] );
+            __m128i f = _mm_mulhi_epu16( b, C2[ g ] );
+            f   = _mm_sub_epi16( f, _mm_and_si128( b, CNEG[ g ] ) );
+            f   = _mm_or_si128( _mm_and_si128( f, lo_mask ), _mm_andnot_si128( lo_mask, b ) );
+            acc = _mm_add_epi32( acc, _mm_madd_epi16( f, C1[ g ] ) );
+        }
+        acc = _mm_add_epi32( acc, _mm_shuffle_epi32( acc, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+        acc = _mm_add_epi32( acc, _mm_shuffle_epi32( acc, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+
+        /* Avoids introducing a bias because silk_SMLAWB() always rounds to -inf */
+        LPC_pred_Q10 = silk_RSHIFT( order, 1 ) + _mm_cvtsi128_si32( acc );
+        LPC_pred_Q10 = silk_SMLAWB( LPC_pred_Q10, prev, A_Q12[ 0 ] );
+
+        window = _mm_or_si128( _mm_srli_si128( window, 4 ),
+                               _mm_slli_si128( _mm_cvtsi32_si128( prev ), 12 ) );
+
+        /* Add prediction to LPC excitation */
+        prev = silk_ADD_LSHIFT32( pres_Q14[ i ], LPC_pred_Q10, 4 );
+        sLPC_Q14[ MAX_LPC_ORDER + i ] = prev;
+
+        /* Scale with gain */
+        pxq[ i ] = (opus_int16)silk_SAT16( silk_RSHIFT_ROUND( silk_SMULWW( prev, Gain_Q10 ), 8 ) );
+    }
+}
+
+#endif /* SILK_DECODE_CORE_SSE2_H */
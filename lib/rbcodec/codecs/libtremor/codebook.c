@@ -252,8 +252,8 @@ STIN long decode_packed_entry_number(codebook *book,
       lo=(entry>>15)&0x7fff;
       hi=book->used_entries-(entry&0x7fff);
     }else{
-      oggpack_adv(b, book->dec_codelengths[entry-1]);
-      return(entry-1);
+      oggpack_adv(b, DEC_FIRSTTABLE_LEN(book->dec_codelengths, entry));
+      return(DEC_FIRSTTABLE_ENTRY(entry));
     }
   }else{
     lo=0;
@@ -284,6 +284,13 @@ STIN long decode_packed_entry_number(codebook *book,
   return(-1);
 }
 
+#ifdef TREMOR_WIDE_CODEBOOK
+typedef ogg_uint64_t codebook_cache_t;
+#else
+typedef ogg_uint32_t codebook_cache_t;
+#endif
+#define CODEBOOK_CACHE_BITS (sizeof(codebook_cache_t)*8)
+
 static long decode_packed_block(codebook *book, oggpack_buffer *b,
                                 long *buf, int n){
   long *bufptr = buf;
@@ -294,7 +301,7 @@ static long decode_packed_block(codebook *book, oggpack_buffer *b,
       ogg_uint32_t *ptr;
       unsigned long bit, bitend;
       intptr_t adr;
-      ogg_uint32_t cache = 0;
+      codebook_cache_t cache = 0;
       int cachesize = 0;
       const unsigned int cachemask = (1<<book->dec_firsttablen)-1;
       const int          book_dec_maxlength = book->dec_maxlength;
@@ -309,27 +316,40 @@ static long decode_packed_block(codebook *book, oggpack_buffer *b,
       bitend = ((adr&3)+(b->storage-b->endbyte))*8;
       while (bufptr<bufend){
         if (UNLIKELY(cachesize<book_dec_maxlength)) {
-          if (bit-cachesize+32>=bitend)
+          if (bit-cachesize+CODEBOOK_CACHE_BITS>=bitend)
             break;
           bit-=cachesize;
+#ifdef TREMOR_WIDE_CODEBOOK
+          cache = letoh32(ptr[bit>>5]) |
+                  (codebook_cache_t)letoh32(ptr[(bit>>5)+1]) << 32;
+          if (bit&31) {
+            cache >>= (bit&31);
+            cache |= (codebook_cache_t)letoh32(ptr[(bit>>5)+2])
+                        << (64-(bit&31));
+          }
+#else
           cache = letoh32(ptr[bit>>5]);
           if (bit&31) {
             cache >>= (bit&31);
             cache |= letoh32(ptr[(bit>>5)+1]) << (32-(bit&31));
           }
-          cachesize=32;
-          bit+=32;
+#endif
+          cachesize=CODEBOOK_CACHE_BITS;
+          bit+=CODEBOOK_CACHE_BITS;
         }
 
         ogg_int32_t entry = book_dec_firsttable[cache&cachemask];
+        int l;
         if(UNLIKELY(entry < 0)){
           const long lo = (entry>>15)&0x7fff, hi = book_used_entries-(entry&0x7fff);
           entry = bisect_codelist(lo, hi, cache, book_codelist);
-        }else
-          entry--;
+          l = book_dec_codelengths[entry];
+        }else{
+          l = DEC_FIRSTTABLE_LEN(book_dec_codelengths, entry);
+          entry = DEC_FIRSTTABLE_ENTRY(entry);
+        }
 
         *bufptr++ = entry;
-        int l = book_dec_codelengths[entry];
         cachesize -= l;
         cache >>= l;
       }
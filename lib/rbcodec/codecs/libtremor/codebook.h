@@ -76,6 +76,19 @@ typedef struct codebook{
 
 } codebook;
 
+/* dec_firsttable entries: bit 31 set is a lo/hi search hint, otherwise the
+   low 24 bits hold packed entry + 1. With TREMOR_WIDE_CODEBOOK bits 24-30
+   also hold the codeword length, so a direct hit needs a single lookup. */
+#ifdef TREMOR_WIDE_CODEBOOK
+#define DEC_FIRSTTABLE_HIT(entry, len) (((entry)+1) | (ogg_uint32_t)(len)<<24)
+#define DEC_FIRSTTABLE_ENTRY(hit)      (((hit)&0xffffff)-1)
+#define DEC_FIRSTTABLE_LEN(lengths, hit) ((hit)>>24)
+#else
+#define DEC_FIRSTTABLE_HIT(entry, len) ((entry)+1)
+#define DEC_FIRSTTABLE_ENTRY(hit)      ((hit)-1)
+#define DEC_FIRSTTABLE_LEN(lengths, hit) ((lengths)[(hit)-1])
+#endif
+
 extern void vorbis_staticbook_destroy(static_codebook *b);
 extern int vorbis_book_init_decode(codebook *dest,const static_codebook *source);
 
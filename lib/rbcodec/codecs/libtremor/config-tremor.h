@@ -47,6 +47,13 @@
 #endif
 #endif
 
+/* Hosted builds have memory and wide registers to spare: larger first
+   level codebook tables that also carry the codeword length, and a 64 bit
+   bit cache when decoding blocks of codewords. */
+#if (CONFIG_PLATFORM & PLATFORM_HOSTED)
+#define TREMOR_WIDE_CODEBOOK
+#endif
+
 /* max 2 channels  */
 #define CHANNELS 2
 
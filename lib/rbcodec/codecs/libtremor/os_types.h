@@ -54,5 +54,6 @@ void *iram_malloc(size_t size);
    typedef int32_t ogg_int32_t;
    typedef uint32_t ogg_uint32_t;
    typedef int64_t ogg_int64_t;
+   typedef uint64_t ogg_uint64_t;
 
 #endif  /* _OS_TYPES_H */
@@ -407,7 +407,11 @@ int vorbis_book_init_decode(codebook *c,const static_codebook *s){
     c->dec_firsttablen=_ilog(c->used_entries)+1; /* this is magic */
 #endif
     if(c->dec_firsttablen<5)c->dec_firsttablen=5;
+#ifdef TREMOR_WIDE_CODEBOOK
+    if(c->dec_firsttablen>10)c->dec_firsttablen=10;
+#else
     if(c->dec_firsttablen>8)c->dec_firsttablen=8;
+#endif
     
     tabn=1<<c->dec_firsttablen;
     c->dec_firsttable=(ogg_uint32_t *)_ogg_calloc(tabn,sizeof(*c->dec_firsttable));
@@ -419,7 +423,8 @@ int vorbis_book_init_decode(codebook *c,const static_codebook *s){
       if(c->dec_codelengths[i]<=c->dec_firsttablen){
         ogg_uint32_t orig=bitreverse(c->codelist[i]);
         for(j=0;j<(1<<(c->dec_firsttablen-c->dec_codelengths[i]));j++)
-          c->dec_firsttable[orig|(j<<c->dec_codelengths[i])]=i+1;
+          c->dec_firsttable[orig|(j<<c->dec_codelengths[i])]=
+            DEC_FIRSTTABLE_HIT(i,c->dec_codelengths[i]);
       }
     }
     
@@ -430,7 +435,7 @@ int vorbis_book_init_decode(codebook *c,const static_codebook *s){
       long lo=0,hi=0;
       
       for(i=0;i<tabn;i++){
-        ogg_uint32_t word=i<<(32-c->dec_firsttablen);
+        ogg_uint32_t word=(ogg_uint32_t)i<<(32-c->dec_firsttablen);
         if(c->dec_firsttable[bitreverse(word)]==0){
           while((lo+1)<n && c->codelist[lo+1]<=word)lo++;
           while(    hi<n && word>=(c->codelist[hi]&mask))hi++;
@@ -56,6 +56,10 @@ static unsigned char mad_main_data[MAD_BUFFER_MDLEN] IBSS_ATTR;
 static int mpeg_latency[3] = { 0, 481, 529 };
 static int mpeg_framesize[3] = {384, 1152, 1152};
 
+/* Frames decoded ahead of an indexed seek target so that the bit reservoir
+   and the synthesis overlap are filled again when the target is reached */
+#define SEEK_INDEX_PREROLL 10
+
 static void init_mad(void)
 {
     ci->memset(&stream, 0, sizeof(struct mad_stream));
@@ -140,6 +144,25 @@ static int get_file_pos(int newtime)
     return pos;
 }
 
+/* Find the exact file position to start decoding from for decoded sample
+   <target> using the seek index. Sets <skip> to the number of samples to
+   drop from there. Returns -1 if the track has no index. */
+static int get_indexed_pos(unsigned long target, int *skip)
+{
+    unsigned long preroll = SEEK_INDEX_PREROLL *
+                            mpeg_framesize[ci->id3->layer];
+    unsigned long point_sample;
+    size_t point_pos;
+
+    if (!ci->seek_index_lookup ||
+        !ci->seek_index_lookup(target > preroll ? target - preroll : 0,
+                               &point_sample, &point_pos))
+        return -1;
+
+    *skip = target - point_sample;
+    return point_pos;
+}
+
 static void set_elapsed(struct mp3entry* id3)
 {
     unsigned long offset = id3->offset > id3->first_frame_offset ?
@@ -336,6 +359,8 @@ enum codec_status codec_run(void)
     int framelength;
     int padding = MAD_BUFFER_GUARD; /* to help mad decode the last frame */
     intptr_t param;
+    bool exact_seek = false; /* seeked via the index, skip is sample exact */
+    int newpos;
 
     /* Reinitializing seems to be necessary to avoid playback quircks when seeking. */
     init_mad();
@@ -346,26 +371,45 @@ enum codec_status codec_run(void)
     current_frequency = ci->id3->frequency;
     codec_set_replaygain(ci->id3);
     
+    if (ci->id3->lead_trim >= 0 && ci->id3->tail_trim >= 0) {
+        stop_skip = ci->id3->tail_trim - mpeg_latency[ci->id3->layer];
+        if (stop_skip < 0) stop_skip = 0;
+        start_skip = ci->id3->lead_trim + mpeg_latency[ci->id3->layer];
+    } else {
+        stop_skip = 0;
+        /* We want to skip this amount anyway */
+        start_skip = mpeg_latency[ci->id3->layer];
+    }
+
+    samplesdone = ((int64_t)ci->id3->elapsed) * current_frequency / 1000;
+
     if (!ci->id3->offset && ci->id3->elapsed) {
         /* Have elapsed time but not offset */
-        ci->id3->offset = get_file_pos(ci->id3->elapsed);
+        newpos = get_indexed_pos(samplesdone + start_skip, &samples_to_skip);
+        if (newpos >= 0) {
+            ci->id3->offset = newpos;
+            exact_seek = true;
+        } else {
+            ci->id3->offset = get_file_pos(ci->id3->elapsed);
+        }
     }
 
     if (ci->id3->offset) {
         ci->seek_buffer(ci->id3->offset);
-        set_elapsed(ci->id3);
+        if (!exact_seek)
+            set_elapsed(ci->id3);
     }
     else
         ci->seek_buffer(ci->id3->first_frame_offset);
 
-    if (ci->id3->lead_trim >= 0 && ci->id3->tail_trim >= 0) {
-        stop_skip = ci->id3->tail_trim - mpeg_latency[ci->id3->layer];
-        if (stop_skip < 0) stop_skip = 0;
-        start_skip = ci->id3->lead_trim + mpeg_latency[ci->id3->layer];
-    } else {
-        stop_skip = 0;
-        /* We want to skip this amount anyway */
-        start_skip = mpeg_latency[ci->id3->layer];
+    if (!exact_seek) {
+        samplesdone = ((int64_t)ci->id3->elapsed) * current_frequency / 1000;
+
+        /* Don't skip any samples unless we start at the beginning. */
+        if (samplesdone > 0)
+            samples_to_skip = 0;
+        else
+            samples_to_skip = start_skip;
     }
 
     /* Libmad will not decode the last frame without 8 bytes of extra padding
@@ -380,14 +424,6 @@ enum codec_status codec_run(void)
         padding = MAD_BUFFER_GUARD;
     }
 
-    samplesdone = ((int64_t)ci->id3->elapsed) * current_frequency / 1000;
-
-    /* Don't skip any samples unless we start at the beginning. */
-    if (samplesdone > 0)
-        samples_to_skip = 0;
-    else
-        samples_to_skip = start_skip;
-
     framelength = 0;
 
     /* This is the decoding loop. */
@@ -398,20 +434,25 @@ enum codec_status codec_run(void)
             break;
 
         if (action == CODEC_ACTION_SEEK_TIME) {
-            int newpos;
-
             /*make sure the synth thread is idle before seeking - MT only*/
             mad_synth_thread_wait_pcm();
             mad_synth_thread_unwait_pcm();
 
             samplesdone = ((int64_t)param)*current_frequency/1000;
 
+            exact_seek = false;
             if (param == 0) {
                 newpos = ci->id3->first_frame_offset;
                 samples_to_skip = start_skip;
             } else {
-                newpos = get_file_pos(param);
-                samples_to_skip = 0;
+                newpos = get_indexed_pos(samplesdone + start_skip,
+                                         &samples_to_skip);
+                if (newpos >= 0) {
+                    exact_seek = true;
+                } else {
+                    newpos = get_file_pos(param);
+                    samples_to_skip = 0;
+                }
             }
 
             if (!ci->seek_buffer(newpos))
@@ -450,7 +491,14 @@ enum codec_status codec_run(void)
                 file_end++;
                 continue;
             } else if (MAD_RECOVERABLE(stream.error)) {
-                /* Probably syncing after a seek */
+                /* Probably syncing after a seek. Frames that lost their
+                   bit reservoir produce no output, so there is less to
+                   skip after an exact seek. */
+                if (exact_seek && stream.error == MAD_ERROR_BADDATAPTR) {
+                    samples_to_skip -= 32 * MAD_NSBSAMPLES(&frame.header);
+                    if (samples_to_skip < 0)
+                        samples_to_skip = 0;
+                }
                 continue;
             } else {
                 /* Some other unrecoverable error */
@@ -458,6 +506,8 @@ enum codec_status codec_run(void)
             }
         }
 
+        exact_seek = false;
+
         /* Do the pcmbuf insert here. Note, this is the PREVIOUS frame's pcm
            data (not the one just decoded above). When we exit the decoding
            loop we will need to process the final frame that was decoded. */
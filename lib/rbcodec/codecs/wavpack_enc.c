@@ -64,13 +64,6 @@ struct riff_header
 #define RIFF_FMT_DATA_SIZE     16 /* audio_format -> bits_per_sample */
 #define RIFF_DATA_HEADER_SIZE   8 /* data_id -> data_size */
 
-struct wvpk_chunk_data
-{
-    struct enc_chunk_data ckhdr;  /* The base data chunk header */
-    WavpackHeader         wphdr;  /* The block wavpack info */
-    uint8_t               data[]; /* Encoded audio data */
-};
-
 #define PCM_DEPTH_BITS         16
 #define PCM_DEPTH_BYTES         2
 #define PCM_SAMP_PER_CHUNK   5000
@@ -137,10 +130,11 @@ static inline void sample_to_int32(int32_t **dst, int32_t **src)
 #endif
 }
 
-static void ICODE_ATTR input_buffer_to_int32(size_t size)
+/* Expands the raw PCM in the second half of buffer over the whole buffer */
+static void ICODE_ATTR input_buffer_to_int32(int32_t *buffer, size_t size)
 {
-    int32_t *dst = input_buffer;
-    int32_t *src = input_buffer + PCM_SAMP_PER_CHUNK;
+    int32_t *dst = buffer;
+    int32_t *src = buffer + PCM_SAMP_PER_CHUNK;
 
     do
     {
@@ -158,16 +152,19 @@ static void ICODE_ATTR input_buffer_to_int32(size_t size)
     while (size -= 10 * 2 * PCM_DEPTH_BYTES);
 }
 
-static int on_stream_data(struct wvpk_chunk_data *wpdata)
+static int on_stream_data(struct enc_chunk_data *data)
 {
-    /* update timestamp (block_index) */
-    wpdata->wphdr.block_index = htole32(total_samples);
-
-    size_t size = wpdata->ckhdr.hdr.size;
-    if (ci->enc_stream_write(wpdata->ckhdr.data, size) != (ssize_t)size)
+    /* update timestamp (block_index); the block starts right at data[],
+       which is not where a struct member after the chunk header would
+       land once the header is padded out on 64 bit builds */
+    WavpackHeader *wphdr = (WavpackHeader *)data->data;
+    wphdr->block_index = htole32(total_samples);
+
+    size_t size = data->hdr.size;
+    if (ci->enc_stream_write(data->data, size) != (ssize_t)size)
         return -1;
 
-    total_samples += wpdata->ckhdr.pcm_count;
+    total_samples += data->pcm_count;
 
     return 0;
 }
@@ -245,10 +242,10 @@ static int on_stream_end(void)
     return 0;
 }
 
-static inline uint32_t encode_block_(uint8_t *outbuf)
+static inline uint32_t encode_block(int32_t *inbuf, uint8_t *outbuf)
 {
     if (WavpackStartBlock(wpc, outbuf, outbuf + out_reqsize) &&
-        WavpackPackSamples(wpc, input_buffer, PCM_SAMP_PER_CHUNK))
+        WavpackPackSamples(wpc, inbuf, PCM_SAMP_PER_CHUNK))
         return WavpackFinishBlock(wpc);
 
     return 0;
@@ -256,11 +253,23 @@ static inline uint32_t encode_block_(uint8_t *outbuf)
 
 #ifdef WAVPACK_ENC_COP
 /* This is to relieve CPU of encoder load since it has other significant tasks
-   to perform when recording. It is not written to provide parallelism within
-   the codec. */
+   to perform when recording. Blocks pass through a ring of up to one slot per
+   core so the CPU can read in the next block while the COP encodes; the COP
+   still encodes them one after the other with the one context. */
+#define ENC_NUM_SLOTS NUM_CORES
+
+struct enc_slot
+{
+    int32_t  *input;    /* PCM_SAMP_PER_CHUNK*2 samples */
+    uint8_t  *output;   /* Encoded block */
+    uint32_t out_size;  /* Size of the encoded block, 0 on error */
+};
+
 static const char enc_thread_name[] = { "Wavpack enc" };
 static bool quit IBSS_ATTR;
-static uint32_t out_size IBSS_ATTR;
+static struct enc_slot enc_slots[ENC_NUM_SLOTS] IBSS_ATTR;
+static unsigned int enc_num_slots;
+static unsigned int enc_next IBSS_ATTR; /* Next slot the COP encodes */
 static struct semaphore enc_sema IBSS_ATTR;
 static struct semaphore cod_sema IBSS_ATTR;
 static unsigned int enc_thread_id;
@@ -274,17 +283,40 @@ static void ICODE_ATTR enc_thread(void)
         if (quit)
             break;
 
-        out_size = encode_block_(output_buffer);
+        struct enc_slot *slot = &enc_slots[enc_next++ % enc_num_slots];
+
+        ci->commit_discard_dcache();
+        slot->out_size = encode_block(slot->input, slot->output);
+        ci->commit_dcache();
 
         ci->semaphore_release(&cod_sema);
     }
 }
 
+/* The first slot uses the static buffers; the rest come from the codec
+   buffer, as many as fit */
+static void enc_slots_init(void)
+{
+    enc_slots[0].input = input_buffer;
+    enc_slots[0].output = output_buffer;
+
+    for (enc_num_slots = 1; enc_num_slots < ENC_NUM_SLOTS; enc_num_slots++)
+    {
+        struct enc_slot *slot = &enc_slots[enc_num_slots];
+        slot->input = codec_malloc(sizeof (input_buffer));
+        slot->output = codec_malloc(sizeof (output_buffer));
+
+        if (!slot->input || !slot->output)
+            break;
+    }
+}
+
 static inline bool enc_thread_init(void *stack, size_t stack_size)
 {
     quit = false;
-    ci->semaphore_init(&enc_sema, 1, 0);
-    ci->semaphore_init(&cod_sema, 1, 0);
+    enc_next = 0;
+    ci->semaphore_init(&enc_sema, ENC_NUM_SLOTS, 0);
+    ci->semaphore_init(&cod_sema, ENC_NUM_SLOTS, 0);
 
     enc_thread_id = ci->create_thread(enc_thread, stack, stack_size,
                                       0, enc_thread_name
@@ -301,19 +333,84 @@ static inline void enc_thread_stop(void)
     ci->thread_wait(enc_thread_id);
 }
 
-static inline uint32_t encode_block(uint8_t *outbuf)
+/* Keeps up to enc_num_slots blocks with the COP and collects them in order.
+   A stream finish request is answered with the space still needed until the
+   last of them is out. */
+static void encode_loop(void)
 {
-    ci->semaphore_release(&enc_sema);
-    ci->semaphore_wait(&cod_sema, TIMEOUT_BLOCK);
-    ci->memcpy(outbuf, output_buffer, out_size);
-    return out_size;
+    unsigned int head = 0, tail = 0; /* Next slot to collect, to fill */
+    bool finish = false;
+
+    while (1)
+    {
+        intptr_t param;
+        long action = ci->get_command(&param);
+
+        if (action != CODEC_ACTION_NULL)
+        {
+            if (action != CODEC_ACTION_STREAM_FINISH || head == tail)
+                break;
+
+            /* Reply with required space */
+            *(size_t *)param = out_reqsize;
+            finish = true;
+        }
+
+        /* First hand the COP what PCM data there is */
+        if (!finish && tail - head < enc_num_slots)
+        {
+            struct enc_slot *slot = &enc_slots[tail % enc_num_slots];
+
+            if (ci->enc_pcmbuf_read(slot->input + PCM_SAMP_PER_CHUNK,
+                                    PCM_SAMP_PER_CHUNK))
+            {
+                input_buffer_to_int32(slot->input, frame_size);
+                ci->enc_pcmbuf_advance(PCM_SAMP_PER_CHUNK);
+                ci->commit_dcache();
+                tail++;
+                ci->semaphore_release(&enc_sema);
+                continue;
+            }
+        }
+
+        if (head == tail)
+        {
+            if (finish)
+                break;
+
+            continue;
+        }
+
+        /* Then collect the oldest block once there's room for it */
+        struct enc_chunk_data *data = ci->enc_encbuf_get_buffer(out_reqsize);
+
+        if (!data)
+            continue;
+
+        ci->semaphore_wait(&cod_sema, TIMEOUT_BLOCK);
+        ci->commit_discard_dcache();
+
+        struct enc_slot *slot = &enc_slots[head++ % enc_num_slots];
+
+        if (slot->out_size)
+        {
+            ci->memcpy(data->data, slot->output, slot->out_size);
+            data->hdr.size = slot->out_size;
+            data->pcm_count = PCM_SAMP_PER_CHUNK;
+        }
+        else
+        {
+            data->hdr.err = 1;
+        }
+
+        ci->enc_encbuf_finish_buffer();
+    }
 }
 
 #else /* !WAVPACK_ENC_COP */
 
-static inline uint32_t encode_block(uint8_t *outbuf)
+static inline void enc_slots_init(void)
 {
-    return encode_block_(outbuf);
 }
 
 static inline bool enc_thread_init(void *stack, size_t stack_size)
@@ -326,27 +423,8 @@ static inline void enc_thread_stop(void)
 {
 }
 
-#endif /* WAVPACK_ENC_COP */
-
-/* this is the codec entry point */
-enum codec_status codec_main(enum codec_entry_call_reason reason)
-{
-    if (reason == CODEC_LOAD)
-        codec_init();
-
-    return CODEC_OK;
-}
-
-/* this is called for each file to process */
-enum codec_status codec_run(void)
+static void encode_loop(void)
 {
-    /* Encoder thread stack goes on our stack - leave 4k for us
-       Will be optimized away when single-threaded */
-    uint32_t enc_stack[(DEFAULT_STACK_SIZE+0x1000) / sizeof(uint32_t)];
-
-    if (!enc_thread_init(enc_stack, sizeof (enc_stack)))
-        return CODEC_ERROR;
-
     enum { GETBUF_ENC, GETBUF_PCM } getbuf = GETBUF_ENC;
     struct enc_chunk_data *data = NULL;
 
@@ -372,9 +450,9 @@ enum codec_status codec_run(void)
             getbuf = GETBUF_ENC;
         }
 
-        input_buffer_to_int32(frame_size);
+        input_buffer_to_int32(input_buffer, frame_size);
 
-        uint32_t size = encode_block(data->data);
+        uint32_t size = encode_block(input_buffer, data->data);
 
         if (size)
         {
@@ -390,6 +468,33 @@ enum codec_status codec_run(void)
         ci->enc_pcmbuf_advance(PCM_SAMP_PER_CHUNK);
         ci->enc_encbuf_finish_buffer();
     }
+}
+
+#endif /* WAVPACK_ENC_COP */
+
+/* this is the codec entry point */
+enum codec_status codec_main(enum codec_entry_call_reason reason)
+{
+    if (reason == CODEC_LOAD)
+    {
+        codec_init();
+        enc_slots_init();
+    }
+
+    return CODEC_OK;
+}
+
+/* this is called for each file to process */
+enum codec_status codec_run(void)
+{
+    /* Encoder thread stack goes on our stack - leave 4k for us
+       Will be optimized away when single-threaded */
+    uint32_t enc_stack[(DEFAULT_STACK_SIZE+0x1000) / sizeof(uint32_t)];
+
+    if (!enc_thread_init(enc_stack, sizeof (enc_stack)))
+        return CODEC_ERROR;
+
+    encode_loop();
 
     enc_thread_stop();
     return CODEC_OK;
@@ -468,7 +468,8 @@ static int asf_parse_header(int fd, struct mp3entry* id3,
                             } else {
                                 lseek(fd, length, SEEK_CUR);
                             }
-                        } else if (!strncmp("replaygain_", utf8buf, 11)) {
+                        } else if (!strncmp("replaygain_", utf8buf, 11) ||
+                                   !strncmp("mixramp_", utf8buf, 8)) {
                             char *value = id3buf;
                             asf_utf16LEdecode(fd, length, &id3buf, &id3buf_remaining);
                             parse_replaygain(utf8buf, value, id3);
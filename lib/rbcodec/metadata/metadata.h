@@ -312,6 +312,8 @@ struct mp3entry {
     long album_gain;
     long track_peak;    /* s19.12 signed fixed point. 0 for no peak. */
     long album_peak;
+    long mixramp_start; /* MixRamp overlap at start of track in ms. 0 for none. */
+    long mixramp_end;   /* MixRamp overlap at end of track in ms. 0 for none. */
 #endif
 
 #ifdef HAVE_ALBUMART
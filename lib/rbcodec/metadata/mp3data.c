@@ -690,6 +690,65 @@ int count_mp3_frames(int fd,  int startpos,  int filesize,
     }
 }
 
+/* Records the file offset of every *frames_per_point'th frame from startpos
+   for a seek index. When 'offsets' fills up every other point is dropped
+   and *frames_per_point doubles, up to max_frames_per_point; after that
+   the index ends where 'offsets' fills up. Returns the number of points
+   stored, or -1 on error. */
+int build_mp3_seek_index(int fd, long startpos, long filesize,
+                         unsigned char *buf, size_t buflen,
+                         uint32_t *offsets, int max_points,
+                         int max_frames_per_point,
+                         int *frames_per_point, int *frame_samples)
+{
+    unsigned long header;
+    struct mp3info info;
+    unsigned long frame = 0;
+    long pos = startpos;
+    long bytes;
+    int fpp = *frames_per_point;
+    int count = 0;
+    int i;
+
+    if(lseek(fd, startpos, SEEK_SET) < 0)
+        return -1;
+
+    buf_init(buf, buflen);
+    *frame_samples = 0;
+
+    while((header = buf_find_next_frame(fd, &bytes, startpos + filesize))) {
+        mp3headerinfo(&info, header);
+        pos += bytes;
+
+        if(!*frame_samples)
+            *frame_samples = info.frame_samples;
+
+        if(frame % fpp == 0) {
+            if(count == max_points) {
+                if(fpp*2 > max_frames_per_point)
+                    break;
+
+                /* Keep the points that fall on the doubled spacing */
+                for(i = 0; i*2 < count; i++)
+                    offsets[i] = offsets[i*2];
+                count = i;
+                fpp *= 2;
+            }
+
+            if(frame % fpp == 0)
+                offsets[count++] = pos;
+        }
+
+        pos += info.frame_size;
+        frame++;
+        buf_seek(fd, info.frame_size-4);
+    }
+    VDEBUGF("Seek index: %lu frames, %d points\n", frame, count);
+
+    *frames_per_point = fpp;
+    return count;
+}
+
 static const char cooltext[] = "Rockbox - rocks your box";
 
 /* buf needs to be the audio buffer with TOC generation enabled,
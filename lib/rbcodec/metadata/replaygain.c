@@ -24,6 +24,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <inttypes.h>
 #include "platform.h"
 #include "strlcpy.h"
@@ -38,6 +39,10 @@
 #define FP_MIN          (-48 * FP_ONE)
 #define FP_MAX          ( 17 * FP_ONE)
 
+/* Level at which MixRamp curves are cut to find the overlap; the same as
+   MPD's default mixramp_db */
+#define MIXRAMP_LEVEL   (0 * FP_ONE)
+
 void replaygain_itoa(char* buffer, int length, long int_gain)
 {
     /* int_gain uses Q19.12 format. */
@@ -147,6 +152,57 @@ static long get_replaypeak(const char* str)
     return fp_atof(str, 24);
 }
 
+/* Get the MixRamp overlap time in ms.
+ *
+ * str  MixRamp curve as "dB seconds" pairs of rising level, separated by
+ *      ';'. E.g., "-90.00 0.00;-17.00 0.26;0.00 1.50". The time at which
+ *      the curve reaches MIXRAMP_LEVEL is interpolated from the points
+ *      around it. Returns 0 if it never does.
+ */
+static long get_mixramp(const char* str)
+{
+    long last_level = 0;
+    long last_secs = 0;
+    bool have_last = false;
+
+    while (str != NULL && *str != '\0')
+    {
+        const char* secs_str = strchr(str, ' ');
+
+        if (secs_str == NULL)
+        {
+            break;
+        }
+
+        long level = fp_atof(str, FP_BITS);
+        long secs = fp_atof(secs_str + 1, FP_BITS);
+
+        if (level >= MIXRAMP_LEVEL)
+        {
+            if (have_last && level != last_level)
+            {
+                secs = last_secs + (int64_t) (secs - last_secs)
+                    * (MIXRAMP_LEVEL - last_level) / (level - last_level);
+            }
+
+            return (int64_t) MAX(secs, 0) * 1000 >> FP_BITS;
+        }
+
+        last_level = level;
+        last_secs = secs;
+        have_last = true;
+
+        str = strchr(secs_str, ';');
+
+        if (str != NULL)
+        {
+            str++;
+        }
+    }
+
+    return 0;
+}
+
 /* Get a sample scale factor in Q7.24 format from a gain value.
  *
  * int_gain  Gain in dB, multiplied by 100.
@@ -156,9 +212,9 @@ long get_replaygain_int(long int_gain)
     return convert_gain(int_gain * FP_ONE / 100);
 }
 
-/* Parse a ReplayGain tag conforming to the "VorbisGain standard". If a
- * valid tag is found, update mp3entry struct accordingly. Existing values 
- * are not overwritten.
+/* Parse a ReplayGain tag conforming to the "VorbisGain standard" or a
+ * MixRamp tag. If a valid tag is found, update mp3entry struct accordingly.
+ * Existing values are not overwritten.
  *
  * key     Name of the tag.
  * value   Value of the tag.
@@ -192,6 +248,14 @@ void parse_replaygain(const char* key, const char* value,
     {
         entry->album_peak = get_replaypeak(value);
     }
+    else if ((strcasecmp(key, "mixramp_start") == 0) && !entry->mixramp_start)
+    {
+        entry->mixramp_start = get_mixramp(value);
+    }
+    else if ((strcasecmp(key, "mixramp_end") == 0) && !entry->mixramp_end)
+    {
+        entry->mixramp_end = get_mixramp(value);
+    }
 }
 
 /* Set ReplayGain values from integers. Existing values are not overwritten. 
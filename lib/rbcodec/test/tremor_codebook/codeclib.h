@@ -0,0 +1,46 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/* Just enough of codeclib.h for building Tremor's codebook code on the
+   host; CONFIG_PLATFORM comes from the Makefile */
+
+#ifndef CODECLIB_H
+#define CODECLIB_H
+
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define PLATFORM_NATIVE (1<<0)
+#define PLATFORM_HOSTED (1<<1)
+
+#define ROCKBOX_LITTLE_ENDIAN 1
+#define letoh32(x) (x)
+
+#define CODEC_SIZE 0x100000
+
+#define LIKELY(x)   __builtin_expect(!!(x), 1)
+#define UNLIKELY(x) __builtin_expect(!!(x), 0)
+
+#define ICODE_ATTR
+#define IDATA_ATTR
+#define IBSS_ATTR
+#define ICONST_ATTR
+
+#endif /* CODECLIB_H */
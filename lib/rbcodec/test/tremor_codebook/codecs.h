@@ -0,0 +1 @@
+/* Nothing from codecs.h is needed by the codebook code */
@@ -0,0 +1,379 @@
+/***************************************************************************
+ *             __________               __   ___.
+ *   Open      \______   \ ____   ____ |  | _\_ |__   _______  ___
+ *   Source     |       _//  _ \_/ ___\|  |/ /| __ \ /  _ \  \/  /
+ *   Jukebox    |    |   (  <_> )  \___|    < | \_\ (  <_> > <  <
+ *   Firmware   |____|_  /\____/ \___  >__|_ \|___  /\____/__/\_ \
+ *                     \/            \/     \/    \/            \/
+ * $Id$
+ *
+ * Copyright (C) 2026 by the authors
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This software is distributed on an "AS IS" basis, WITHOUT WARRANTY OF ANY
+ * KIND, either express or implied.
+ *
+ ****************************************************************************/
+
+/* Bit-exactness test for Tremor's codebook decoding. Random Huffman books,
+ * sparse and dense, short and up to 24 bit codewords, are built with
+ * vorbis_book_init_decode(). Random entries are then packed with codewords
+ * assigned the way the Vorbis spec does it, and read back through every
+ * codebook decode function. Each result is checked against what was packed.
+ *
+ * The Makefile builds this twice, once as a hosted build with
+ * TREMOR_WIDE_CODEBOOK (wide first table, lengths in the table, 64 bit bit
+ * cache) and once as a native build with the plain layout. Both have to
+ * pass, and both print the same checksum. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config-tremor.h"
+#include "ogg.h"
+#include "ivorbiscodec.h"
+#include "codebook.h"
+
+#define NUM_BOOKS       2000
+#define NUM_WORDS       4000    /* Codewords packed per book */
+#define MAX_ENTRIES     3000
+#define MAX_LENGTH      24
+
+static unsigned long errors;
+static uint32_t checksum = 2166136261u;
+
+/* Tremor's allocator hooks, normally backed by the codec buffer */
+void *ogg_malloc(size_t size)               { return malloc(size); }
+void *ogg_calloc(size_t nmemb, size_t size) { return calloc(nmemb, size); }
+void *ogg_realloc(void *ptr, size_t size)   { return realloc(ptr, size); }
+void ogg_free(void *ptr)                    { free(ptr); }
+
+static void mix(uint32_t v)
+{
+    checksum = (checksum ^ v) * 16777619u;
+}
+
+/* Small deterministic PRNG so both builds see the same books */
+static uint32_t rng_state = 1;
+
+static uint32_t rnd(uint32_t n)
+{
+    rng_state = rng_state * 1103515245u + 12345u;
+    return ((rng_state >> 8) & 0xffffff) % n;
+}
+
+
+/** Book construction **/
+
+/* Lengths of a complete prefix code with 'count' words, from splitting
+   random leaves of a binary tree; 'deep' biases towards long codewords */
+static void make_lengths(long *lengths, int count, int deep)
+{
+    static long leaf[MAX_ENTRIES];
+    int n = 1;
+
+    leaf[0] = 0;
+
+    while (n < count)
+    {
+        int i = deep ? n - 1 - (int)rnd(n < 4 ? n : 4) : (int)rnd(n);
+
+        if (leaf[i] >= MAX_LENGTH)
+        {
+            /* Fall back to the shallowest leaf */
+            i = 0;
+            for (int j = 1; j < n; j++)
+                if (leaf[j] < leaf[i])
+                    i = j;
+        }
+
+        leaf[i]++;
+        leaf[n++] = leaf[i];
+    }
+
+    /* Shuffle them over the entries */
+    for (int i = count - 1; i > 0; i--)
+    {
+        int j = rnd(i + 1);
+        long t = leaf[i]; leaf[i] = leaf[j]; leaf[j] = t;
+    }
+
+    memcpy(lengths, leaf, count * sizeof (*lengths));
+}
+
+/* Codeword assignment from the Vorbis I spec (section 3.2.1), written out
+   independently of sharedbook.c's _make_words() */
+static int make_codewords(const long *lengths, long entries, uint32_t *words)
+{
+    uint32_t marker[33];
+
+    memset(marker, 0, sizeof (marker));
+
+    for (long i = 0; i < entries; i++)
+    {
+        long len = lengths[i];
+
+        if (len <= 0)
+            continue;
+
+        uint32_t entry = marker[len];
+
+        if (len < 32 && (entry >> len))
+            return -1; /* Overpopulated */
+
+        words[i] = entry;
+
+        for (long j = len; j > 0; j--)
+        {
+            if (marker[j] & 1)
+            {
+                marker[j] = j == 1 ? marker[j] + 1 : marker[j-1] << 1;
+                break;
+            }
+
+            marker[j]++;
+        }
+
+        for (long j = len + 1; j < 33; j++)
+        {
+            if ((marker[j] >> 1) != entry)
+                break;
+
+            entry = marker[j];
+            marker[j] = marker[j-1] << 1;
+        }
+    }
+
+    return 0;
+}
+
+
+/** Bit packing, LSb first with codewords MSb first as Vorbis has it **/
+
+static unsigned char packet[NUM_WORDS * MAX_LENGTH / 8 + 16];
+static long packet_bits;
+static unsigned char *stream; /* Exactly sized copy, for -fsanitize=address */
+
+static void pack_word(uint32_t word, long len)
+{
+    while (len-- > 0)
+    {
+        if ((word >> len) & 1)
+            packet[packet_bits >> 3] |= 1 << (packet_bits & 7);
+        packet_bits++;
+    }
+}
+
+static void start_read(oggpack_buffer *b)
+{
+    oggpack_readinit(b, stream, (packet_bits + 7) >> 3);
+}
+
+
+/** Checks **/
+
+static void fail(int book, const char *what, long i, long got, long want)
+{
+    if (errors++ < 20)
+        printf("book %d: %s at %ld: got %ld, want %ld\n",
+               book, what, i, got, want);
+}
+
+/* Packed (sorted) index of each original entry */
+static int packed_index[MAX_ENTRIES];
+
+static const ogg_int32_t * entry_values(const codebook *c, long entry)
+{
+    return c->valuelist + packed_index[entry] * c->dim;
+}
+
+static void check_book(int book, const codebook *c, const long *sent,
+                       int count)
+{
+    oggpack_buffer b;
+    int dim = c->dim;
+    int n = count * dim;
+    ogg_int32_t *a = malloc(n * sizeof (*a));
+    ogg_int32_t *a2[2] = { malloc(n * sizeof (*a)), malloc(n * sizeof (*a)) };
+
+    /* One entry at a time */
+    start_read(&b);
+    for (int i = 0; i < count; i++)
+    {
+        long e = vorbis_book_decode((codebook *)c, &b);
+        mix(e);
+        if (e != sent[i])
+        {
+            fail(book, "vorbis_book_decode", i, e, sent[i]);
+            break;
+        }
+    }
+
+    /* Whole vectors, interleaved and not */
+    start_read(&b);
+    if (vorbis_book_decodev_set((codebook *)c, a, &b, n, c->binarypoint))
+        fail(book, "vorbis_book_decodev_set", 0, -1, 0);
+
+    for (int i = 0; i < n; i++)
+    {
+        mix(a[i]);
+        if (a[i] != entry_values(c, sent[i / dim])[i % dim])
+        {
+            fail(book, "vorbis_book_decodev_set", i, a[i],
+                 entry_values(c, sent[i / dim])[i % dim]);
+            break;
+        }
+    }
+
+    memset(a, 0, n * sizeof (*a));
+    start_read(&b);
+    if (vorbis_book_decodevs_add((codebook *)c, a, &b, n, c->binarypoint))
+        fail(book, "vorbis_book_decodevs_add", 0, -1, 0);
+
+    for (int i = 0; i < n; i++)
+    {
+        /* Interleaved: element j of vector k lands at j*count + k */
+        ogg_int32_t want = entry_values(c, sent[i % count])[i / count];
+        if (a[i] != want)
+        {
+            fail(book, "vorbis_book_decodevs_add", i, a[i], want);
+            break;
+        }
+    }
+
+    /* The block decoder, through both the stereo even-dim path and the
+       generic one */
+    for (int ch = 1; ch <= 2; ch++)
+    {
+        if (n % ch)
+            continue;
+
+        memset(a2[0], 0, n * sizeof (*a));
+        memset(a2[1], 0, n * sizeof (*a));
+        start_read(&b);
+        if (vorbis_book_decodevv_add((codebook *)c, a2, 0, ch, &b, n / ch,
+                                     c->binarypoint))
+            fail(book, "vorbis_book_decodevv_add", ch, -1, 0);
+
+        for (int i = 0; i < n; i++)
+        {
+            ogg_int32_t got = a2[i % ch][i / ch];
+            ogg_int32_t want = entry_values(c, sent[i / dim])[i % dim];
+            mix(got);
+            if (got != want)
+            {
+                fail(book, "vorbis_book_decodevv_add", i, got, want);
+                break;
+            }
+        }
+    }
+
+    free(a);
+    free(a2[0]);
+    free(a2[1]);
+}
+
+int main(void)
+{
+    static long lengths[MAX_ENTRIES];
+    static uint32_t words[MAX_ENTRIES];
+    static long used[MAX_ENTRIES];
+    static long sent[NUM_WORDS];
+    static long quant[MAX_ENTRIES * 8];
+
+    for (int book = 0; book < NUM_BOOKS; book++)
+    {
+        static_codebook s;
+        codebook c;
+
+        /* From tiny books that fit the first table to big sparse ones
+           that need the bisect fallback */
+        int nused = 2 + rnd(book % 3 ? 64 : MAX_ENTRIES / 2 - 2);
+        int entries = nused + (book % 4 == 0 ? rnd(nused) : 0);
+
+        if (entries > MAX_ENTRIES)
+            entries = MAX_ENTRIES;
+
+        make_lengths(used, nused, book & 1);
+
+        /* Spread the used entries over the book, the rest unused */
+        memset(lengths, 0, sizeof (lengths));
+        for (int i = 0, k = 0; i < entries; i++)
+        {
+            if (entries - i == nused - k || (k < nused && rnd(entries) < nused))
+                lengths[i] = used[k++];
+        }
+
+        if (make_codewords(lengths, entries, words))
+        {
+            printf("book %d: bad lengths\n", book);
+            return 1;
+        }
+
+        memset(&s, 0, sizeof (s));
+        s.dim = 1 + rnd(8);
+        s.entries = entries;
+        s.lengthlist = lengths;
+        s.maptype = 2;
+        s.q_min = 0;
+        s.q_delta = (788L << 21) | 1;   /* 1.0 */
+        s.q_quant = 16;
+        s.quantlist = quant;
+
+        /* Distinct values per entry so a wrong entry can't go unnoticed */
+        for (int i = 0; i < entries * s.dim; i++)
+            quant[i] = i & 0xffff;
+
+        if (vorbis_book_init_decode(&c, &s))
+        {
+            printf("book %d: init failed\n", book);
+            return 1;
+        }
+
+        for (int i = 0; i < c.used_entries; i++)
+            packed_index[c.dec_index[i]] = i;
+
+        /* Pack random used entries; the stream's length is whatever they
+           make so that the tail is exercised too */
+        int count = 1 + rnd(NUM_WORDS);
+
+        memset(packet, 0, sizeof (packet));
+        packet_bits = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            long e;
+
+            do
+                e = rnd(entries);
+            while (!lengths[e]);
+
+            sent[i] = e;
+            pack_word(words[e], lengths[e]);
+        }
+
+        /* The bit readers fetch whole aligned words, so round up to those
+           but no further */
+        size_t size = ((packet_bits + 31) >> 5) * 4;
+        stream = malloc(size);
+        memcpy(stream, packet, size);
+
+        check_book(book, &c, sent, count);
+        vorbis_book_clear(&c);
+        free(stream);
+    }
+
+    printf("%s: %d books, checksum %08x, %lu errors\n",
+#ifdef TREMOR_WIDE_CODEBOOK
+           "wide",
+#else
+           "narrow",
+#endif
+           NUM_BOOKS, checksum, errors);
+
+    return errors ? 1 : 0;
+}
@@ -278,6 +278,16 @@ const struct tag_info* find_tag(const char* name)
 
 }
 
+int tag_to_index(const struct tag_info* tag)
+{
+    return tag ? tag - legal_tags : -1;
+}
+
+const struct tag_info* tag_from_index(int index)
+{
+    return index < 0 ? NULL : &legal_tags[index];
+}
+
 /* Searches through the legal escape characters string */
 int find_escape_character(char lookup)
 {
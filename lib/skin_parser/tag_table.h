@@ -350,6 +350,13 @@ struct tag_info
  */
 const struct tag_info* find_tag(const char* name);
 
+/*
+ * Converts between a tag and its position in the table, for storing
+ * parsed trees somewhere the tag pointers don't survive. NULL is -1.
+ */
+int tag_to_index(const struct tag_info* tag);
+const struct tag_info* tag_from_index(int index);
+
 /*
  * Determines whether a character is legal to escape or not.  If 
  * lookup is not found in the legal escape characters string, returns